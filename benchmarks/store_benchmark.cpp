@@ -0,0 +1,671 @@
+/**
+ * @file store_benchmark.cpp
+ * @brief Bộ micro-benchmark cho Store, so sánh với std::vector / std::deque
+ *
+ * Build (header-only, không cần thư viện ngoài):
+ *   g++ -std=c++17 -O2 -I<thư mục chứa advance/> benchmarks/store_benchmark.cpp -o store_benchmark
+ *
+ * Chạy:
+ *   ./store_benchmark                               # bảng kết quả
+ *   ./store_benchmark --benchmark_format=json       # JSON (giống Google Benchmark)
+ *   ./store_benchmark --benchmark_filter=sort       # chỉ chạy benchmark có tên chứa "sort"
+ *   ./store_benchmark --benchmark_min_time=0.5      # thời gian đo tối thiểu (giây)
+ *   ./store_benchmark --benchmark_out=result.json   # ghi JSON ra file
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <ctime>
+#include <deque>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "advance/store/include/advance_store.hpp"
+
+namespace bench
+{
+
+// =======================
+// Harness
+// =======================
+
+/// @brief Per-run state, used like benchmark::State
+class State
+{
+	using clock = std::chrono::steady_clock;
+
+	size_t m_iterations;
+	size_t m_range;
+	clock::duration m_real{};
+	std::clock_t m_cpu = 0;
+	clock::time_point m_real_start;
+	std::clock_t m_cpu_start = 0;
+	size_t m_items = 0;
+
+  public:
+	State(size_t iterations, size_t range) : m_iterations(iterations), m_range(range) {}
+
+	/// @brief Size argument of this run
+	size_t range() const { return m_range; }
+	size_t iterations() const { return m_iterations; }
+
+	/// @brief Items processed per iteration, reported as items_per_second
+	void set_items_processed(size_t items) { m_items = items; }
+	size_t items_processed() const { return m_items; }
+
+	void pause_timing()
+	{
+		m_real += clock::now() - m_real_start;
+		m_cpu += std::clock() - m_cpu_start;
+	}
+
+	void resume_timing()
+	{
+		m_real_start = clock::now();
+		m_cpu_start = std::clock();
+	}
+
+	double real_seconds() const { return std::chrono::duration<double>(m_real).count(); }
+	double cpu_seconds() const { return static_cast<double>(m_cpu) / CLOCKS_PER_SEC; }
+
+	/// @brief Run body exactly iterations() times with the clock running
+	template <typename Body>
+	void run(Body body)
+	{
+		resume_timing();
+		for (size_t i = 0; i < m_iterations; ++i)
+		{
+			body();
+		}
+		pause_timing();
+	}
+};
+
+/// @brief Prevent the optimizer from discarding a value
+template <typename T>
+inline void do_not_optimize(const T &value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+	asm volatile("" : : "r,m"(value) : "memory");
+#else
+	static volatile const void *sink;
+	sink = &value;
+#endif
+}
+
+struct Benchmark
+{
+	std::string name;
+	std::function<void(State &)> func;
+	std::vector<size_t> ranges;
+};
+
+struct Result
+{
+	std::string name;
+	size_t iterations;
+	double real_ns;
+	double cpu_ns;
+	double items_per_second;
+};
+
+inline std::vector<Benchmark> &registry()
+{
+	static std::vector<Benchmark> s_registry;
+	return s_registry;
+}
+
+inline void register_benchmark(std::string name, std::function<void(State &)> func, std::vector<size_t> ranges)
+{
+	registry().push_back(Benchmark{std::move(name), std::move(func), std::move(ranges)});
+}
+
+/// @brief Grow the iteration count until a run lasts at least min_time seconds
+inline Result measure(const Benchmark &benchmark, size_t range, double min_time)
+{
+	size_t iterations = 1;
+	for (;;)
+	{
+		State state(iterations, range);
+		benchmark.func(state);
+		const double elapsed = state.real_seconds();
+		if (elapsed >= min_time || iterations >= (size_t(1) << 30))
+		{
+			const double per_iteration = 1e9 / static_cast<double>(iterations);
+			const double items = static_cast<double>(state.items_processed()) * static_cast<double>(iterations);
+			return Result{benchmark.name + "/" + std::to_string(range), iterations,
+						  elapsed * per_iteration, state.cpu_seconds() * per_iteration,
+						  elapsed > 0 ? items / elapsed : 0.0};
+		}
+		const double scale = elapsed > 0 ? min_time * 1.4 / elapsed : 10.0;
+		iterations = static_cast<size_t>(static_cast<double>(iterations) * std::min(std::max(scale, 2.0), 10.0));
+	}
+}
+
+inline std::string json_escape(const std::string &text)
+{
+	std::string out;
+	for (char c : text)
+	{
+		if (c == '"' || c == '\\')
+		{
+			out += '\\';
+		}
+		out += c;
+	}
+	return out;
+}
+
+inline void write_json(std::ostream &os, const std::vector<Result> &results)
+{
+	const std::time_t now = std::time(nullptr);
+	char date[64];
+	std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+
+	os << "{\n  \"context\": {\n"
+	   << "    \"date\": \"" << date << "\",\n"
+	   << "    \"library\": \"advance_store\",\n"
+#ifdef NDEBUG
+	   << "    \"library_build_type\": \"release\"\n"
+#else
+	   << "    \"library_build_type\": \"debug\"\n"
+#endif
+	   << "  },\n  \"benchmarks\": [\n";
+	for (size_t i = 0; i < results.size(); ++i)
+	{
+		const Result &r = results[i];
+		os << "    {\n"
+		   << "      \"name\": \"" << json_escape(r.name) << "\",\n"
+		   << "      \"run_type\": \"iteration\",\n"
+		   << "      \"iterations\": " << r.iterations << ",\n"
+		   << "      \"real_time\": " << std::setprecision(10) << r.real_ns << ",\n"
+		   << "      \"cpu_time\": " << r.cpu_ns << ",\n"
+		   << "      \"time_unit\": \"ns\",\n"
+		   << "      \"items_per_second\": " << r.items_per_second << "\n"
+		   << "    }" << (i + 1 < results.size() ? "," : "") << "\n";
+	}
+	os << "  ]\n}\n";
+}
+
+inline void write_table(std::ostream &os, const Result &r)
+{
+	os << std::left << std::setw(56) << r.name << std::right
+	   << std::setw(16) << std::fixed << std::setprecision(1) << r.real_ns << " ns"
+	   << std::setw(16) << r.cpu_ns << " ns"
+	   << std::setw(12) << r.iterations
+	   << std::setw(14) << std::setprecision(3) << r.items_per_second / 1e6 << " M/s\n";
+}
+
+inline int run_all(int argc, char **argv)
+{
+	std::string format = "console";
+	std::string filter;
+	std::string out_path;
+	double min_time = 0.1;
+	for (int i = 1; i < argc; ++i)
+	{
+		const std::string arg = argv[i];
+		auto value = [&](const char *flag) -> const char * {
+			const size_t length = std::strlen(flag);
+			return arg.compare(0, length, flag) == 0 ? arg.c_str() + length : nullptr;
+		};
+		if (const char *v = value("--benchmark_format="))
+		{
+			format = v;
+		}
+		else if (const char *v = value("--benchmark_filter="))
+		{
+			filter = v;
+		}
+		else if (const char *v = value("--benchmark_min_time="))
+		{
+			min_time = std::stod(v);
+		}
+		else if (const char *v = value("--benchmark_out="))
+		{
+			out_path = v;
+		}
+		else
+		{
+			std::cerr << "Unknown flag: " << arg << "\n";
+			return 1;
+		}
+	}
+
+	const bool json = format == "json";
+	if (!json)
+	{
+		std::cout << std::left << std::setw(56) << "Benchmark" << std::right
+				  << std::setw(19) << "Time" << std::setw(19) << "CPU"
+				  << std::setw(12) << "Iterations" << std::setw(18) << "Items" << "\n"
+				  << std::string(124, '-') << "\n";
+	}
+
+	std::vector<Result> results;
+	for (const auto &benchmark : registry())
+	{
+		for (size_t range : benchmark.ranges)
+		{
+			const std::string full_name = benchmark.name + "/" + std::to_string(range);
+			if (!filter.empty() && full_name.find(filter) == std::string::npos)
+			{
+				continue;
+			}
+			results.push_back(measure(benchmark, range, min_time));
+			if (!json)
+			{
+				write_table(std::cout, results.back());
+			}
+		}
+	}
+
+	if (json)
+	{
+		write_json(std::cout, results);
+	}
+	if (!out_path.empty())
+	{
+		std::ofstream out(out_path);
+		write_json(out, results);
+	}
+	return 0;
+}
+
+// =======================
+// Data Generation
+// =======================
+
+template <typename T>
+T make_value(size_t i);
+
+template <>
+int make_value<int>(size_t i) { return static_cast<int>(i); }
+
+template <>
+double make_value<double>(size_t i) { return static_cast<double>(i) * 0.5; }
+
+template <>
+std::string make_value<std::string>(size_t i) { return std::to_string(i * 7919); }
+
+template <typename T>
+const char *type_name();
+template <>
+const char *type_name<int>() { return "int"; }
+template <>
+const char *type_name<double>() { return "double"; }
+template <>
+const char *type_name<std::string>() { return "string"; }
+
+/// @brief Shuffled input with about n/8 distinct values
+template <typename T>
+std::vector<T> make_input(size_t n)
+{
+	std::mt19937_64 rng(42);
+	std::vector<T> data;
+	data.reserve(n);
+	for (size_t i = 0; i < n; ++i)
+	{
+		data.push_back(make_value<T>(rng() % std::max<size_t>(n / 8, 1)));
+	}
+	return data;
+}
+
+/// @brief Stream buffer that discards everything, used for print()
+class NullBuffer : public std::streambuf
+{
+  protected:
+	int overflow(int c) override { return c; }
+	std::streamsize xsputn(const char *, std::streamsize n) override { return n; }
+};
+
+// =======================
+// Container Adapters
+// =======================
+
+/// @brief Uniform operations for Store and the std baselines
+template <typename C>
+struct Ops;
+
+template <typename T>
+struct Ops<adv::Store<T>>
+{
+	using C = adv::Store<T>;
+	static const char *name() { return "Store"; }
+	static C make(const std::vector<T> &v) { return C(v.begin(), v.end()); }
+	static void push_front(C &c, const T &v) { c.push_front(v); }
+	static void pop_front(C &c) { c.pop_front(); }
+	static void insert(C &c, size_t pos, const T &v) { c.insert(pos, v); }
+	static void remove_at(C &c, size_t pos) { c.remove_at(pos); }
+	static std::vector<size_t> find_all(const C &c, const T &v) { return c.find_all(v); }
+	template <typename Pred>
+	static C filter(const C &c, Pred pred) { return c.filter(pred); }
+	static void sort(C &c) { c.sort(); }
+	static void unique(C &c) { c.unique(); }
+	static size_t to_int(const C &c) { return c.to_int().size(); }
+	static size_t to_double(const C &c) { return c.to_double().size(); }
+	static size_t to_string(const C &c) { return c.to_string().size(); }
+	static void print(const C &c) { c.print(); }
+};
+
+/// @brief Shared implementation for std::vector / std::deque
+template <typename C>
+struct StdOps
+{
+	using T = typename C::value_type;
+	static C make(const std::vector<T> &v) { return C(v.begin(), v.end()); }
+	static void insert(C &c, size_t pos, const T &v) { c.insert(c.begin() + pos, v); }
+	static void remove_at(C &c, size_t pos) { c.erase(c.begin() + pos); }
+	static std::vector<size_t> find_all(const C &c, const T &v)
+	{
+		std::vector<size_t> positions;
+		for (size_t i = 0; i < c.size(); ++i)
+		{
+			if (c[i] == v)
+			{
+				positions.push_back(i);
+			}
+		}
+		return positions;
+	}
+	template <typename Pred>
+	static C filter(const C &c, Pred pred)
+	{
+		C result;
+		std::copy_if(c.begin(), c.end(), std::back_inserter(result), pred);
+		return result;
+	}
+	static void sort(C &c) { std::sort(c.begin(), c.end()); }
+	static void unique(C &c)
+	{
+		std::sort(c.begin(), c.end());
+		c.erase(std::unique(c.begin(), c.end()), c.end());
+	}
+	static size_t to_int(const C &c)
+	{
+		std::vector<int> result;
+		for (const auto &v : c)
+		{
+			if constexpr (std::is_same_v<T, std::string>)
+			{
+				result.push_back(std::stoi(v));
+			}
+			else
+			{
+				result.push_back(static_cast<int>(v));
+			}
+		}
+		return result.size();
+	}
+	static size_t to_double(const C &c)
+	{
+		std::vector<double> result;
+		for (const auto &v : c)
+		{
+			if constexpr (std::is_same_v<T, std::string>)
+			{
+				result.push_back(std::stod(v));
+			}
+			else
+			{
+				result.push_back(static_cast<double>(v));
+			}
+		}
+		return result.size();
+	}
+	static size_t to_string(const C &c)
+	{
+		std::vector<std::string> result;
+		for (const auto &v : c)
+		{
+			if constexpr (std::is_same_v<T, std::string>)
+			{
+				result.push_back(v);
+			}
+			else
+			{
+				result.push_back(std::to_string(v));
+			}
+		}
+		return result.size();
+	}
+	static void print(const C &c)
+	{
+		for (size_t i = 0; i < c.size(); ++i)
+		{
+			std::cout << c[i];
+			if (i + 1 < c.size())
+			{
+				std::cout << " ";
+			}
+		}
+	}
+};
+
+template <typename T>
+struct Ops<std::vector<T>> : StdOps<std::vector<T>>
+{
+	using C = std::vector<T>;
+	static const char *name() { return "vector"; }
+	static void push_front(C &c, const T &v) { c.insert(c.begin(), v); }
+	static void pop_front(C &c) { c.erase(c.begin()); }
+};
+
+template <typename T>
+struct Ops<std::deque<T>> : StdOps<std::deque<T>>
+{
+	using C = std::deque<T>;
+	static const char *name() { return "deque"; }
+	static void push_front(C &c, const T &v) { c.push_front(v); }
+	static void pop_front(C &c) { c.pop_front(); }
+};
+
+// =======================
+// Benchmarks
+// =======================
+
+template <typename C>
+void bm_push_front(State &state)
+{
+	using T = typename std::decay_t<decltype(*std::declval<C &>().begin())>;
+	const auto input = make_input<T>(state.range());
+	state.run([&] {
+		C c;
+		for (const auto &v : input)
+		{
+			Ops<C>::push_front(c, v);
+		}
+		do_not_optimize(c);
+	});
+	state.set_items_processed(state.range());
+}
+
+template <typename C>
+void bm_pop_front(State &state)
+{
+	using T = typename std::decay_t<decltype(*std::declval<C &>().begin())>;
+	const auto input = make_input<T>(state.range());
+	for (size_t i = 0; i < state.iterations(); ++i)
+	{
+		C c = Ops<C>::make(input);
+		state.resume_timing();
+		while (!c.empty())
+		{
+			Ops<C>::pop_front(c);
+		}
+		state.pause_timing();
+		do_not_optimize(c);
+	}
+	state.set_items_processed(state.range());
+}
+
+/// @brief Insert then remove 256 elements at random positions
+template <typename C>
+void bm_insert_remove_at(State &state)
+{
+	using T = typename std::decay_t<decltype(*std::declval<C &>().begin())>;
+	const size_t ops = 256;
+	C c = Ops<C>::make(make_input<T>(state.range()));
+	std::mt19937_64 rng(7);
+	std::vector<size_t> positions(ops);
+	for (auto &pos : positions)
+	{
+		pos = rng() % state.range();
+	}
+	const T value = make_value<T>(1);
+	state.run([&] {
+		for (size_t pos : positions)
+		{
+			Ops<C>::insert(c, pos, value);
+		}
+		for (auto it = positions.rbegin(); it != positions.rend(); ++it)
+		{
+			Ops<C>::remove_at(c, *it);
+		}
+		do_not_optimize(c);
+	});
+	state.set_items_processed(ops * 2);
+}
+
+template <typename C>
+void bm_find_all(State &state)
+{
+	using T = typename std::decay_t<decltype(*std::declval<C &>().begin())>;
+	const C c = Ops<C>::make(make_input<T>(state.range()));
+	const T needle = make_value<T>(3);
+	state.run([&] { do_not_optimize(Ops<C>::find_all(c, needle)); });
+	state.set_items_processed(state.range());
+}
+
+template <typename C>
+void bm_filter(State &state)
+{
+	using T = typename std::decay_t<decltype(*std::declval<C &>().begin())>;
+	const C c = Ops<C>::make(make_input<T>(state.range()));
+	const T pivot = make_value<T>(state.range() / 16);
+	state.run([&] { do_not_optimize(Ops<C>::filter(c, [&](const T &v) { return v < pivot; })); });
+	state.set_items_processed(state.range());
+}
+
+template <typename C>
+void bm_sort(State &state)
+{
+	using T = typename std::decay_t<decltype(*std::declval<C &>().begin())>;
+	const auto input = make_input<T>(state.range());
+	for (size_t i = 0; i < state.iterations(); ++i)
+	{
+		C c = Ops<C>::make(input);
+		state.resume_timing();
+		Ops<C>::sort(c);
+		state.pause_timing();
+		do_not_optimize(c);
+	}
+	state.set_items_processed(state.range());
+}
+
+template <typename C>
+void bm_unique(State &state)
+{
+	using T = typename std::decay_t<decltype(*std::declval<C &>().begin())>;
+	const auto input = make_input<T>(state.range());
+	for (size_t i = 0; i < state.iterations(); ++i)
+	{
+		C c = Ops<C>::make(input);
+		state.resume_timing();
+		Ops<C>::unique(c);
+		state.pause_timing();
+		do_not_optimize(c);
+	}
+	state.set_items_processed(state.range());
+}
+
+template <typename C>
+void bm_to_int(State &state)
+{
+	using T = typename std::decay_t<decltype(*std::declval<C &>().begin())>;
+	const C c = Ops<C>::make(make_input<T>(state.range()));
+	state.run([&] { do_not_optimize(Ops<C>::to_int(c)); });
+	state.set_items_processed(state.range());
+}
+
+template <typename C>
+void bm_to_double(State &state)
+{
+	using T = typename std::decay_t<decltype(*std::declval<C &>().begin())>;
+	const C c = Ops<C>::make(make_input<T>(state.range()));
+	state.run([&] { do_not_optimize(Ops<C>::to_double(c)); });
+	state.set_items_processed(state.range());
+}
+
+template <typename C>
+void bm_to_string(State &state)
+{
+	using T = typename std::decay_t<decltype(*std::declval<C &>().begin())>;
+	const C c = Ops<C>::make(make_input<T>(state.range()));
+	state.run([&] { do_not_optimize(Ops<C>::to_string(c)); });
+	state.set_items_processed(state.range());
+}
+
+template <typename C>
+void bm_print(State &state)
+{
+	using T = typename std::decay_t<decltype(*std::declval<C &>().begin())>;
+	const C c = Ops<C>::make(make_input<T>(state.range()));
+	NullBuffer null_buffer;
+	std::streambuf *saved = std::cout.rdbuf(&null_buffer);
+	state.run([&] { Ops<C>::print(c); });
+	std::cout.rdbuf(saved);
+	state.set_items_processed(state.range());
+}
+
+/// @brief Register one benchmark for Store, vector and deque of T
+template <typename T>
+void register_for_type(const std::string &op, void (*store)(State &), void (*vec)(State &),
+					   void (*deq)(State &), const std::vector<size_t> &ranges)
+{
+	const std::string suffix = std::string("<") + type_name<T>() + ">";
+	register_benchmark("BM_" + op + "/Store" + suffix, store, ranges);
+	register_benchmark("BM_" + op + "/vector" + suffix, vec, ranges);
+	register_benchmark("BM_" + op + "/deque" + suffix, deq, ranges);
+}
+
+#define ADV_BENCH(op, T, ranges)                                            \
+	register_for_type<T>(#op, &bm_##op<adv::Store<T>>, &bm_##op<std::vector<T>>, \
+						 &bm_##op<std::deque<T>>, ranges)
+
+template <typename T>
+void register_type()
+{
+	// Front and positional edits are O(n) per call on Store/vector, keep sizes moderate
+	const std::vector<size_t> quadratic = {1 << 10, 1 << 13};
+	const std::vector<size_t> linear = {1 << 10, 1 << 14, 1 << 18};
+
+	ADV_BENCH(push_front, T, quadratic);
+	ADV_BENCH(pop_front, T, quadratic);
+	ADV_BENCH(insert_remove_at, T, linear);
+	ADV_BENCH(find_all, T, linear);
+	ADV_BENCH(filter, T, linear);
+	ADV_BENCH(sort, T, linear);
+	ADV_BENCH(unique, T, linear);
+	ADV_BENCH(to_int, T, linear);
+	ADV_BENCH(to_double, T, linear);
+	ADV_BENCH(to_string, T, linear);
+	ADV_BENCH(print, T, linear);
+}
+
+#undef ADV_BENCH
+
+} // namespace bench
+
+int main(int argc, char **argv)
+{
+	bench::register_type<int>();
+	bench::register_type<double>();
+	bench::register_type<std::string>();
+	return bench::run_all(argc, argv);
+}
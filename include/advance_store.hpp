@@ -1,14 +1,31 @@
 #pragma once
 #include <iostream>
+#include <cstdint>
 #include <initializer_list>
+#include <iomanip>
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
 #include <iterator>
+#include <limits>
+#include <memory>
+#include <mutex>
 #include <numeric>
 #include <vector>
 #include <string>
+#include <sstream>
 #include <stdexcept>
 #include <type_traits>
 
+#if !defined(ADV_STORE_NO_SIMD) && (defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86))
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#define ADV_STORE_SIMD_X86 1
+#endif
+
 namespace adv
 {
 using std::cout;
@@ -45,770 +62,5867 @@ class Errors
 };
 
 // =======================
-// Store Template Class
+// Instrumentation
 // =======================
-template <typename T>
-class Store
+// Define ADV_STORE_INSTRUMENTATION before including this header to enable
+// per-Store operation counters. When it is not defined the counting hooks
+// expand to nothing and stats() always returns an empty snapshot.
+
+#ifdef ADV_STORE_INSTRUMENTATION
+#define ADV_STORE_COUNT(op, shifted, scanned, added) \
+	m_stats.record(op, shifted, scanned, added, m_data.size(), m_data.capacity(), sizeof(T))
+#else
+#define ADV_STORE_COUNT(op, shifted, scanned, added) ((void)0)
+#endif
+
+/// @brief Store operations tracked by the instrumentation hooks
+enum class StoreOp : unsigned
 {
-  private:
-	vector<T> m_data;	   // Internal storage
-	static Errors s_error; // Error management
+	push_front, // push_front, emplace_front
+	push_back,	// push_back, emplace_back
+	pop_front,
+	insert,
+	remove_at,
+	contains,
+	find_all, // find_all, find_all_if
+	filter,
+	sort,
+	unique,
+	to_int,
+	to_double,
+	to_char,
+	to_string,
+	count_ // Number of operations, not an operation
+};
 
-  public:
-	// =======================
-	// Constructors & Destructor
-	// =======================
+/// @brief Number of tracked operations
+inline constexpr size_t k_store_op_count = static_cast<size_t>(StoreOp::count_);
 
-	/// @brief Default constructor
-	Store() = default;
+/// @brief Get printable name of an operation
+/// @param op Operation
+/// @return Operation name
+inline const char *store_op_name(StoreOp op) noexcept
+{
+	static const char *const s_names[k_store_op_count] = {
+		"push_front", "push_back", "pop_front", "insert", "remove_at", "contains", "find_all",
+		"filter", "sort", "unique", "to_int", "to_double", "to_char", "to_string"};
+	const size_t index = static_cast<size_t>(op);
+	return index < k_store_op_count ? s_names[index] : "unknown";
+}
 
-	/// @brief Constructor with size
-	/// @param size Initial size of the store
-	explicit Store(size_t size) : m_data(size) {}
+/// @brief Counters for one operation type
+struct OpCounters
+{
+	uint64_t calls = 0;			// Number of calls
+	uint64_t shifted = 0;		// Elements moved to open or close a gap
+	uint64_t reallocations = 0; // Buffer reallocations caused by the call
+	uint64_t bytes_copied = 0;	// Bytes moved by shifts and reallocations
+	uint64_t scans = 0;			// Linear scans started
+	uint64_t scanned = 0;		// Elements visited by linear scans
 
-	/// @brief Constructor with initializer list
-	/// @param list Initializer list of elements
-	Store(initializer_list<T> list) : m_data(list) {}
+	/// @brief Accumulate other counters into this one
+	/// @param other Counters to add
+	/// @return Reference to this
+	OpCounters &operator+=(const OpCounters &other) noexcept
+	{
+		calls += other.calls;
+		shifted += other.shifted;
+		reallocations += other.reallocations;
+		bytes_copied += other.bytes_copied;
+		scans += other.scans;
+		scanned += other.scanned;
+		return *this;
+	}
+};
 
-	/// @brief Constructor with iterator range
-	/// @tparam Iterator Iterator type
-	/// @param begin Start iterator
-	/// @param end End iterator
-	template <typename Iterator>
-	Store(Iterator begin, Iterator end) : m_data(begin, end) {}
+namespace detail
+{
+class StoreCounters;
+} // namespace detail
 
-	/// @brief Constructor with range
-	/// @tparam Range Range type
-	/// @param range Input range
-	template <typename Range>
-	explicit Store(const Range &range) : m_data(range.begin(), range.end()) {}
+/// @brief Snapshot of per-operation counters of a Store
+class StoreStats
+{
+  private:
+	friend class detail::StoreCounters;
 
-	/// @brief Move assignment operator
-	/// @param other Other store to move from
-	/// @return Reference to this store
-	Store &operator+=(Store<T> &&other)
+	OpCounters m_ops[k_store_op_count]; // Indexed by StoreOp
+
+  public:
+	/// @brief Get counters of one operation
+	/// @param op Operation
+	/// @return Const reference to counters
+	const OpCounters &operator[](StoreOp op) const noexcept
 	{
-		m_data.insert(m_data.end(),
-					  std::make_move_iterator(other.m_data.begin()),
-					  std::make_move_iterator(other.m_data.end()));
-		return *this;
+		return m_ops[static_cast<size_t>(op)];
 	}
 
-	// =======================
-	// Element Access
-	// =======================
+	/// @brief Sum of counters over all operations
+	/// @return Accumulated counters
+	OpCounters total() const noexcept
+	{
+		OpCounters sum;
+		for (const auto &ops : m_ops)
+		{
+			sum += ops;
+		}
+		return sum;
+	}
 
-	/// @brief Access element with bounds checking
-	/// @param pos Position to access
-	/// @return Reference to element at position
-	/// @throws std::out_of_range if position is invalid
-	T &at(size_t pos)
+	/// @brief Reset all counters to zero
+	void reset() noexcept
 	{
-		if (pos >= m_data.size())
+		for (auto &ops : m_ops)
 		{
-			s_error.throw_out_of_range();
+			ops = OpCounters();
 		}
-		return m_data[pos];
 	}
 
-	/// @brief Const access element with bounds checking
-	/// @param pos Position to access
-	/// @return Const reference to element at position
-	/// @throws std::out_of_range if position is invalid
-	const T &at(size_t pos) const
+	/// @brief Record one call (used by the instrumentation hooks)
+	/// @param op Operation
+	/// @param shifted Elements shifted by the call
+	/// @param scanned Elements visited by a linear scan (0 = no scan)
+	/// @param added Elements added, used to predict a reallocation
+	/// @param size Size before the call
+	/// @param capacity Capacity before the call
+	/// @param element_size sizeof the element type
+	void record(StoreOp op, size_t shifted, size_t scanned, size_t added,
+				size_t size, size_t capacity, size_t element_size) noexcept
 	{
-		if (pos >= m_data.size())
+		OpCounters &ops = m_ops[static_cast<size_t>(op)];
+		++ops.calls;
+		ops.shifted += shifted;
+		ops.bytes_copied += static_cast<uint64_t>(shifted) * element_size;
+		if (scanned > 0)
 		{
-			s_error.throw_out_of_range();
+			++ops.scans;
+			ops.scanned += scanned;
+		}
+		if (added > 0 && size + added > capacity)
+		{
+			++ops.reallocations;
+			ops.bytes_copied += static_cast<uint64_t>(size) * element_size;
 		}
-		return m_data[pos];
 	}
 
-	/// @brief Access element without bounds checking
-	/// @param pos Position to access
-	/// @return Reference to element at position
-	T &operator[](size_t pos) noexcept
+	/// @brief Print counters of every operation that was called
+	/// @param os Output stream (default std::cout)
+	void dump(ostream &os = cout) const
 	{
-		return m_data[pos];
+		os << std::left << std::setw(12) << "op" << std::right << std::setw(12) << "calls"
+		   << std::setw(14) << "shifted" << std::setw(10) << "reallocs" << std::setw(16) << "bytes_copied"
+		   << std::setw(10) << "scans" << std::setw(14) << "scanned" << '\n';
+		for (size_t i = 0; i < k_store_op_count; ++i)
+		{
+			const OpCounters &ops = m_ops[i];
+			if (ops.calls == 0)
+			{
+				continue;
+			}
+			os << std::left << std::setw(12) << store_op_name(static_cast<StoreOp>(i)) << std::right
+			   << std::setw(12) << ops.calls << std::setw(14) << ops.shifted
+			   << std::setw(10) << ops.reallocations << std::setw(16) << ops.bytes_copied
+			   << std::setw(10) << ops.scans << std::setw(14) << ops.scanned << '\n';
+		}
 	}
+};
 
-	/// @brief Const access element without bounds checking
-	/// @param pos Position to access
-	/// @return Const reference to element at position
-	const T &operator[](size_t pos) const noexcept
+namespace detail
+{
+/// @brief Live counters of a Store, safe to update from concurrent const calls
+/// @details Every field is a relaxed atomic: increments never tear or get lost,
+///          but a snapshot taken while other threads record is not a single
+///          point in time across fields.
+class StoreCounters
+{
+  private:
+	struct Counters
 	{
-		return m_data[pos];
+		std::atomic<uint64_t> calls{0};
+		std::atomic<uint64_t> shifted{0};
+		std::atomic<uint64_t> reallocations{0};
+		std::atomic<uint64_t> bytes_copied{0};
+		std::atomic<uint64_t> scans{0};
+		std::atomic<uint64_t> scanned{0};
+	};
+
+	Counters m_ops[k_store_op_count]; // Indexed by StoreOp
+
+	static void add(std::atomic<uint64_t> &counter, uint64_t amount) noexcept
+	{
+		counter.fetch_add(amount, std::memory_order_relaxed);
 	}
 
-	/// @brief Get first element
-	/// @return Const reference to first element
-	/// @throws std::out_of_range if store is empty
-	const T &front() const
+	static uint64_t get(const std::atomic<uint64_t> &counter) noexcept
 	{
-		if (m_data.empty())
-		{
-			s_error.throw_out_of_range();
-		}
-		return m_data.front();
+		return counter.load(std::memory_order_relaxed);
 	}
 
-	/// @brief Get middle element
-	/// @return Const reference to middle element
-	/// @throws std::out_of_range if store is empty
-	const T &mid() const
+	static void set(std::atomic<uint64_t> &counter, uint64_t value) noexcept
 	{
-		if (m_data.empty())
-		{
-			s_error.throw_out_of_range();
-		}
-		return m_data[m_data.size() / 2];
+		counter.store(value, std::memory_order_relaxed);
 	}
 
-	/// @brief Get last element
-	/// @return Const reference to last element
-	/// @throws std::out_of_range if store is empty
-	const T &back() const
+	void assign(const StoreStats &stats) noexcept
 	{
-		if (m_data.empty())
+		for (size_t i = 0; i < k_store_op_count; ++i)
 		{
-			s_error.throw_out_of_range();
+			const OpCounters &from = stats.m_ops[i];
+			Counters &to = m_ops[i];
+			set(to.calls, from.calls);
+			set(to.shifted, from.shifted);
+			set(to.reallocations, from.reallocations);
+			set(to.bytes_copied, from.bytes_copied);
+			set(to.scans, from.scans);
+			set(to.scanned, from.scanned);
 		}
-		return m_data.back();
 	}
 
-	/// @brief Get maximum element
-	/// @return Const reference to maximum element
-	/// @throws std::out_of_range if store is empty
-	const T &max() const
+  public:
+	StoreCounters() = default;
+
+	StoreCounters(const StoreCounters &other) noexcept
 	{
-		if (m_data.empty())
+		assign(other.snapshot());
+	}
+
+	StoreCounters &operator=(const StoreCounters &other) noexcept
+	{
+		if (this != &other)
 		{
-			s_error.throw_out_of_range();
+			assign(other.snapshot());
 		}
-		return *std::max_element(m_data.begin(), m_data.end());
+		return *this;
 	}
 
-	/// @brief Get minimum element
-	/// @return Const reference to minimum element
-	/// @throws std::out_of_range if store is empty
-	const T &min() const
+	/// @brief Record one call, see StoreStats::record
+	void record(StoreOp op, size_t shifted, size_t scanned, size_t added,
+				size_t size, size_t capacity, size_t element_size) noexcept
 	{
-		if (m_data.empty())
+		Counters &ops = m_ops[static_cast<size_t>(op)];
+		add(ops.calls, 1);
+		if (shifted > 0)
 		{
-			s_error.throw_out_of_range();
+			add(ops.shifted, shifted);
+			add(ops.bytes_copied, static_cast<uint64_t>(shifted) * element_size);
+		}
+		if (scanned > 0)
+		{
+			add(ops.scans, 1);
+			add(ops.scanned, scanned);
+		}
+		if (added > 0 && size + added > capacity)
+		{
+			add(ops.reallocations, 1);
+			add(ops.bytes_copied, static_cast<uint64_t>(size) * element_size);
 		}
-		return *std::min_element(m_data.begin(), m_data.end());
 	}
 
-	/// @brief Get raw pointer to data
-	/// @return Pointer to underlying data array
-	T *data() noexcept
+	void reset() noexcept
 	{
-		return m_data.data();
+		assign(StoreStats());
 	}
 
-	/// @brief Get const raw pointer to data
-	/// @return Const pointer to underlying data array
-	const T *data() const noexcept
+	/// @brief Copy the counters into a plain snapshot
+	StoreStats snapshot() const noexcept
 	{
-		return m_data.data();
+		StoreStats stats;
+		for (size_t i = 0; i < k_store_op_count; ++i)
+		{
+			const Counters &from = m_ops[i];
+			OpCounters &to = stats.m_ops[i];
+			to.calls = get(from.calls);
+			to.shifted = get(from.shifted);
+			to.reallocations = get(from.reallocations);
+			to.bytes_copied = get(from.bytes_copied);
+			to.scans = get(from.scans);
+			to.scanned = get(from.scanned);
+		}
+		return stats;
 	}
+};
+} // namespace detail
 
-	// =======================
-	// Capacity
-	// =======================
+// =======================
+// Latency Histograms
+// =======================
+// Define ADV_STORE_TIMING before including this header to time every
+// instrumented Store operation. Each thread records into its own shard of
+// log-linear (HDR-style) histograms without locks or shared cache lines;
+// StoreLatency merges the shards on read.
 
-	/// @brief Get current size
-	/// @return Number of elements in store
-	size_t size() const noexcept
+#ifdef ADV_STORE_TIMING
+#define ADV_STORE_TIME(op) const LatencyTimer adv_latency_timer_(op)
+#else
+#define ADV_STORE_TIME(op) ((void)0)
+#endif
+
+/// @brief Sub-bucket bits per power of two (16 sub-buckets, ~6% relative error)
+inline constexpr unsigned k_latency_sub_bits = 4;
+/// @brief Largest exponent tracked, values above 2^40 ns (~18 min) are clamped
+inline constexpr unsigned k_latency_max_exponent = 40;
+/// @brief Number of buckets in a latency histogram
+inline constexpr size_t k_latency_buckets =
+	(k_latency_max_exponent - k_latency_sub_bits + 2) << k_latency_sub_bits;
+
+/// @brief Log-linear histogram of latencies in nanoseconds
+class LatencyHistogram
+{
+  private:
+	static constexpr uint64_t k_sub_count = uint64_t(1) << k_latency_sub_bits;
+
+	vector<uint64_t> m_counts = vector<uint64_t>(k_latency_buckets); // Per-bucket counts
+	uint64_t m_total = 0;											  // Number of samples
+	uint64_t m_sum = 0;												  // Sum of samples (ns)
+	uint64_t m_max = 0;												  // Largest sample (ns)
+
+  public:
+	/// @brief Get bucket index of a value
+	/// @param ns Value in nanoseconds
+	/// @return Bucket index
+	static size_t bucket_of(uint64_t ns) noexcept
 	{
-		return m_data.size();
+		const uint64_t limit = (uint64_t(1) << (k_latency_max_exponent + 1)) - 1;
+		ns = std::min(ns, limit);
+		if (ns < k_sub_count)
+		{
+			return static_cast<size_t>(ns);
+		}
+		unsigned exponent = 63;
+		while (!(ns >> exponent))
+		{
+			--exponent;
+		}
+		const unsigned shift = exponent - k_latency_sub_bits;
+		return static_cast<size_t>(((exponent - k_latency_sub_bits + 1) << k_latency_sub_bits) +
+								   ((ns >> shift) & (k_sub_count - 1)));
 	}
 
-	/// @brief Check if store is empty
-	/// @return true if store is empty, false otherwise
-	bool empty() const noexcept
+	/// @brief Get largest value that maps to a bucket
+	/// @param bucket Bucket index
+	/// @return Upper bound in nanoseconds
+	static uint64_t bucket_upper(size_t bucket) noexcept
 	{
-		return m_data.empty();
+		if (bucket < k_sub_count)
+		{
+			return bucket;
+		}
+		const unsigned exponent = static_cast<unsigned>(bucket >> k_latency_sub_bits) + k_latency_sub_bits - 1;
+		const uint64_t sub = bucket & (k_sub_count - 1);
+		const unsigned shift = exponent - k_latency_sub_bits;
+		return ((k_sub_count + sub + 1) << shift) - 1;
 	}
 
-	/// @brief Get capacity
-	/// @return Current capacity of the store
-	size_t capacity() const noexcept
+	/// @brief Record one sample
+	/// @param ns Latency in nanoseconds
+	void record(uint64_t ns) noexcept
 	{
-		return m_data.capacity();
+		add_bucket(bucket_of(ns), 1, ns, ns);
 	}
 
-	// =======================
-	// Conversion Operators
-	// =======================
-
-	/// @brief Convert to vector
-	/// @return Vector containing store elements
-	operator vector<T>() const
+	/// @brief Add raw bucket counts (used when merging shards)
+	/// @param bucket Bucket index
+	/// @param count Number of samples
+	/// @param sum Sum of the samples
+	/// @param max Largest sample
+	void add_bucket(size_t bucket, uint64_t count, uint64_t sum, uint64_t max) noexcept
 	{
-		return m_data;
+		m_counts[bucket] += count;
+		m_total += count;
+		m_sum += sum;
+		m_max = std::max(m_max, max);
 	}
 
-	// =======================
-	// Iterators
-	// =======================
-	auto begin() noexcept { return m_data.begin(); }
-	auto end() noexcept { return m_data.end(); }
-	auto begin() const noexcept { return m_data.begin(); }
-	auto end() const noexcept { return m_data.end(); }
-	auto cbegin() const noexcept { return m_data.cbegin(); }
-	auto cend() const noexcept { return m_data.cend(); }
-	auto rbegin() noexcept { return m_data.rbegin(); }
-	auto rend() noexcept { return m_data.rend(); }
-	auto rbegin() const noexcept { return m_data.rbegin(); }
-	auto rend() const noexcept { return m_data.rend(); }
-
-	// =======================
-	// Basic Operations
-	// =======================
-
-	/// @brief Reserve capacity
-	/// @param new_capacity New capacity to reserve
-	void reserve(size_t new_capacity)
+	/// @brief Merge another histogram into this one
+	/// @param other Histogram to add
+	/// @return Reference to this
+	LatencyHistogram &operator+=(const LatencyHistogram &other) noexcept
 	{
-		m_data.reserve(new_capacity);
+		for (size_t i = 0; i < k_latency_buckets; ++i)
+		{
+			m_counts[i] += other.m_counts[i];
+		}
+		m_total += other.m_total;
+		m_sum += other.m_sum;
+		m_max = std::max(m_max, other.m_max);
+		return *this;
 	}
 
-	/// @brief Resize store
-	/// @param new_size New size of store
-	void resize(size_t new_size)
+	/// @brief Get number of samples
+	/// @return Sample count
+	uint64_t count() const noexcept
 	{
-		m_data.resize(new_size);
+		return m_total;
 	}
 
-	/// @brief Clear all elements
-	void clear() noexcept
+	/// @brief Get largest sample
+	/// @return Maximum in nanoseconds
+	uint64_t max() const noexcept
 	{
-		m_data.clear();
+		return m_max;
 	}
 
-	/// @brief Shrink capacity to fit size
-	void shrink_to_fit()
+	/// @brief Get mean latency
+	/// @return Mean in nanoseconds (0 if empty)
+	double mean() const noexcept
 	{
-		m_data.shrink_to_fit();
+		return m_total ? static_cast<double>(m_sum) / static_cast<double>(m_total) : 0.0;
 	}
 
-	/// @brief Remove first element
-	/// @throws std::out_of_range if store is empty
-	void pop_front()
+	/// @brief Get latency at a percentile
+	/// @param percentile Percentile in [0, 100]
+	/// @return Upper bound of the bucket holding the percentile, in nanoseconds
+	uint64_t percentile(double percentile) const noexcept
 	{
-		if (m_data.empty())
+		if (m_total == 0)
 		{
-			s_error.throw_out_of_range();
+			return 0;
 		}
-		m_data.erase(m_data.begin());
+		percentile = std::min(std::max(percentile, 0.0), 100.0);
+		const uint64_t rank = std::max<uint64_t>(
+			1, static_cast<uint64_t>(percentile / 100.0 * static_cast<double>(m_total) + 0.5));
+		uint64_t seen = 0;
+		for (size_t i = 0; i < k_latency_buckets; ++i)
+		{
+			seen += m_counts[i];
+			if (seen >= rank)
+			{
+				return std::min(bucket_upper(i), m_max);
+			}
+		}
+		return m_max;
 	}
+};
 
-	/// @brief Remove last element
-	/// @throws std::out_of_range if store is empty
-	void pop_back()
+namespace detail
+{
+/// @brief Histograms of one thread, written only by that thread
+struct alignas(64) LatencyShard
+{
+	std::atomic<uint64_t> counts[k_store_op_count][k_latency_buckets] = {};
+	std::atomic<uint64_t> sums[k_store_op_count] = {};
+	std::atomic<uint64_t> maxima[k_store_op_count] = {};
+
+	/// @brief Single-writer increment, no read-modify-write instruction needed
+	static void bump(std::atomic<uint64_t> &cell, uint64_t delta) noexcept
 	{
-		if (m_data.empty())
-		{
-			s_error.throw_out_of_range();
-		}
-		m_data.pop_back();
+		cell.store(cell.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
 	}
 
-	/// @brief Remove element at position
-	/// @param pos Position to remove
-	/// @throws std::out_of_range if position is invalid
-	void remove_at(size_t pos)
+	void record(StoreOp op, uint64_t ns) noexcept
 	{
-		if (pos >= m_data.size())
+		const size_t index = static_cast<size_t>(op);
+		bump(counts[index][LatencyHistogram::bucket_of(ns)], 1);
+		bump(sums[index], ns);
+		if (ns > maxima[index].load(std::memory_order_relaxed))
 		{
-			s_error.throw_out_of_range();
+			maxima[index].store(ns, std::memory_order_relaxed);
 		}
-		m_data.erase(m_data.begin() + pos);
 	}
 
-	/// @brief Insert element at position
-	/// @param pos Position to insert at
-	/// @param value Value to insert
-	/// @throws std::out_of_range if position is invalid
-	void insert(size_t pos, const T &value)
+	void reset() noexcept
 	{
-		if (pos > m_data.size())
+		for (size_t op = 0; op < k_store_op_count; ++op)
 		{
-			s_error.throw_out_of_range();
+			for (auto &cell : counts[op])
+			{
+				cell.store(0, std::memory_order_relaxed);
+			}
+			sums[op].store(0, std::memory_order_relaxed);
+			maxima[op].store(0, std::memory_order_relaxed);
 		}
-		m_data.insert(m_data.begin() + pos, value);
 	}
+};
 
-	/// @brief Replace element at position
-	/// @param pos Position to replace
-	/// @param value New value
-	/// @throws std::out_of_range if position is invalid
-	void replace_at(size_t pos, const T &value)
-	{
-		if (pos >= m_data.size())
-		{
-			s_error.throw_out_of_range();
-		}
-		m_data[pos] = value;
-	}
-
-	/// @brief Replace all occurrences of a value
-	/// @param old_value Value to replace
-	/// @param new_value New value
-	void replace_all(const T &old_value, const T &new_value)
-	{
-		std::replace(m_data.begin(), m_data.end(), old_value, new_value);
-	}
+/// @brief Process-wide list of shards; the mutex is only taken on thread
+///        start/exit and on reads, never on the recording path
+class LatencyRegistry
+{
+  private:
+	std::mutex m_mutex;
+	vector<std::unique_ptr<LatencyShard>> m_shards;
+	vector<LatencyShard *> m_free;
 
-	/// @brief Fill store with value
-	/// @param value Value to fill with
-	void fill(const T &value)
+  public:
+	static LatencyRegistry &instance()
 	{
-		std::fill(m_data.begin(), m_data.end(), value);
+		// Leaked on purpose so thread_local handles may outlive static destruction
+		static LatencyRegistry *s_instance = new LatencyRegistry();
+		return *s_instance;
 	}
 
-	/// @brief Reverse elements in store
-	void reverse()
+	LatencyShard *acquire()
 	{
-		std::reverse(m_data.begin(), m_data.end());
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (!m_free.empty())
+		{
+			// Reused shards keep their samples, exited threads still count
+			LatencyShard *shard = m_free.back();
+			m_free.pop_back();
+			return shard;
+		}
+		m_shards.push_back(std::make_unique<LatencyShard>());
+		return m_shards.back().get();
 	}
 
-	/// @brief Swap contents with another store
-	/// @param other Store to swap with
-	void swap(Store<T> &other) noexcept
+	void release(LatencyShard *shard)
 	{
-		m_data.swap(other.m_data);
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_free.push_back(shard);
 	}
 
-	/// @brief Print store contents
-	/// @param new_line Whether to print newline at the end
-	void print(bool new_line = false) const
+	template <typename Func>
+	void for_each(Func func)
 	{
-		for (size_t i = 0; i < m_data.size(); ++i)
-		{
-			cout << m_data[i];
-			if (i < m_data.size() - 1)
-			{
-				cout << " ";
-			}
-		}
-		if (new_line)
+		std::lock_guard<std::mutex> lock(m_mutex);
+		for (const auto &shard : m_shards)
 		{
-			cout << '\n';
+			func(*shard);
 		}
 	}
+};
 
-	// =======================
-	// Adding Elements
-	// =======================
+/// @brief Thread-local owner of a shard
+struct LatencyShardHandle
+{
+	LatencyShard *shard = LatencyRegistry::instance().acquire();
 
-	/// @brief Add container to front
-	/// @tparam Container Container type
-	/// @param container Container to add
-	template <typename Container>
-	void push_front(const Container &container)
+	~LatencyShardHandle()
 	{
-		m_data.insert(m_data.begin(), container.begin(), container.end());
+		LatencyRegistry::instance().release(shard);
 	}
+};
 
-	/// @brief Add initializer list to front
-	/// @param list Initializer list to add
-	void push_front(initializer_list<T> list)
-	{
-		m_data.insert(m_data.begin(), list.begin(), list.end());
-	}
+inline LatencyShard &local_latency_shard()
+{
+	thread_local LatencyShardHandle s_handle;
+	return *s_handle.shard;
+}
 
-	/// @brief Add value to front
-	/// @param value Value to add
-	void push_front(const T &value)
-	{
-		m_data.insert(m_data.begin(), value);
-	}
+inline std::atomic<bool> &latency_enabled_flag()
+{
+	static std::atomic<bool> s_enabled{true};
+	return s_enabled;
+}
+} // namespace detail
 
-	/// @brief Add moved value to front
-	/// @param value Value to move
-	void push_front(T &&value)
+/// @brief Process-wide latency statistics per Store operation
+class StoreLatency
+{
+  public:
+	/// @brief Check if timing hooks are compiled in
+	/// @return true if ADV_STORE_TIMING is defined
+	static constexpr bool compiled_in() noexcept
 	{
-		m_data.insert(m_data.begin(), std::move(value));
+#ifdef ADV_STORE_TIMING
+		return true;
+#else
+		return false;
+#endif
 	}
 
-	/// @brief Add container to back
-	/// @tparam Container Container type
-	/// @param container Container to add
-	template <typename Container>
-	void push_back(const Container &container)
+	/// @brief Enable or disable recording at runtime
+	/// @param enabled Whether to record
+	static void set_enabled(bool enabled) noexcept
 	{
-		m_data.insert(m_data.end(), container.begin(), container.end());
+		detail::latency_enabled_flag().store(enabled, std::memory_order_relaxed);
 	}
 
-	/// @brief Add initializer list to back
-	/// @param list Initializer list to add
-	void push_back(initializer_list<T> list)
+	/// @brief Check if recording is enabled at runtime
+	/// @return true if enabled
+	static bool enabled() noexcept
 	{
-		m_data.insert(m_data.end(), list.begin(), list.end());
+		return detail::latency_enabled_flag().load(std::memory_order_relaxed);
 	}
 
-	/// @brief Add value to back
-	/// @param value Value to add
-	void push_back(const T &value)
+	/// @brief Record one sample into the calling thread's shard (lock-free)
+	/// @param op Operation
+	/// @param ns Latency in nanoseconds
+	static void record(StoreOp op, uint64_t ns) noexcept
 	{
-		m_data.push_back(value);
+		detail::local_latency_shard().record(op, ns);
 	}
 
-	/// @brief Add moved value to back
-	/// @param value Value to move
-	void push_back(T &&value)
+	/// @brief Merge every thread's samples of one operation
+	/// @param op Operation
+	/// @return Merged histogram
+	static LatencyHistogram snapshot(StoreOp op)
 	{
-		m_data.push_back(std::move(value));
+		const size_t index = static_cast<size_t>(op);
+		LatencyHistogram result;
+		detail::LatencyRegistry::instance().for_each([&](detail::LatencyShard &shard) {
+			uint64_t sum = shard.sums[index].load(std::memory_order_relaxed);
+			const uint64_t max = shard.maxima[index].load(std::memory_order_relaxed);
+			for (size_t bucket = 0; bucket < k_latency_buckets; ++bucket)
+			{
+				const uint64_t count = shard.counts[index][bucket].load(std::memory_order_relaxed);
+				if (count)
+				{
+					result.add_bucket(bucket, count, sum, max);
+					sum = 0;
+				}
+			}
+		});
+		return result;
 	}
 
-	/// @brief Emplace element at back
-	/// @tparam Args Argument types
-	/// @param args Arguments to construct element
-	template <typename... Args>
-	void emplace_back(Args &&... args)
+	/// @brief Clear all samples
+	/// @details Samples recorded concurrently with reset may survive it.
+	static void reset()
 	{
-		m_data.emplace_back(std::forward<Args>(args)...);
+		detail::LatencyRegistry::instance().for_each([](detail::LatencyShard &shard) { shard.reset(); });
 	}
 
-	/// @brief Emplace element at front
-	/// @tparam Args Argument types
-	/// @param args Arguments to construct element
-	template <typename... Args>
-	void emplace_front(Args &&... args)
+	/// @brief Print count, mean and p50/p90/p99/p99.9/max per operation
+	/// @param os Output stream (default std::cout)
+	static void dump(ostream &os = cout)
 	{
-		m_data.emplace(m_data.begin(), std::forward<Args>(args)...);
+		os << std::left << std::setw(12) << "op" << std::right << std::setw(12) << "count"
+		   << std::setw(12) << "mean_ns" << std::setw(12) << "p50_ns" << std::setw(12) << "p90_ns"
+		   << std::setw(12) << "p99_ns" << std::setw(12) << "p999_ns" << std::setw(12) << "max_ns" << '\n';
+		for (size_t i = 0; i < k_store_op_count; ++i)
+		{
+			const StoreOp op = static_cast<StoreOp>(i);
+			const LatencyHistogram histogram = snapshot(op);
+			if (histogram.count() == 0)
+			{
+				continue;
+			}
+			os << std::left << std::setw(12) << store_op_name(op) << std::right
+			   << std::setw(12) << histogram.count()
+			   << std::setw(12) << static_cast<uint64_t>(histogram.mean())
+			   << std::setw(12) << histogram.percentile(50)
+			   << std::setw(12) << histogram.percentile(90)
+			   << std::setw(12) << histogram.percentile(99)
+			   << std::setw(12) << histogram.percentile(99.9)
+			   << std::setw(12) << histogram.max() << '\n';
+		}
 	}
+};
 
-	// =======================
-	// Search & Check
-	// =======================
+/// @brief RAII timer recording its lifetime into StoreLatency
+class LatencyTimer
+{
+  private:
+	using clock = std::chrono::steady_clock;
 
-	/// @brief Check if store contains value
-	/// @param value Value to search for
-	/// @return true if value found, false otherwise
-	bool contains(const T &value) const
-	{
-		return std::find(m_data.begin(), m_data.end(), value) != m_data.end();
-	}
+	StoreOp m_op;
+	clock::time_point m_start;
 
-	/// @brief Check if any element satisfies predicate
-	/// @tparam Pred Predicate type
-	/// @param pred Predicate function
-	/// @return true if any element satisfies predicate
-	template <typename Pred>
-	bool any_of(Pred pred) const
+  public:
+	explicit LatencyTimer(StoreOp op) noexcept : m_op(op), m_start(clock::now()) {}
+
+	LatencyTimer(const LatencyTimer &) = delete;
+	LatencyTimer &operator=(const LatencyTimer &) = delete;
+
+	~LatencyTimer()
 	{
-		return std::any_of(m_data.begin(), m_data.end(), pred);
+		if (StoreLatency::enabled())
+		{
+			const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - m_start);
+			StoreLatency::record(m_op, static_cast<uint64_t>(elapsed.count()));
+		}
 	}
+};
 
-	/// @brief Check if any element equals value
-	/// @param value Value to compare
-	/// @return true if any element equals value
-	bool any_of(const T &value) const
+// =======================
+// Allocation Tracking
+// =======================
+
+/// @brief Allocation counters shared by every TrackingAllocator pointing at them
+/// @details All counters are atomic, one instance may be shared across threads.
+class AllocationStats
+{
+  private:
+	std::atomic<uint64_t> m_allocations{0};	  // Number of allocate() calls
+	std::atomic<uint64_t> m_deallocations{0}; // Number of deallocate() calls
+	std::atomic<uint64_t> m_bytes_total{0};	  // Bytes ever allocated
+	std::atomic<uint64_t> m_bytes_live{0};	  // Bytes currently allocated
+	std::atomic<uint64_t> m_bytes_peak{0};	  // Largest value of m_bytes_live
+
+  public:
+	AllocationStats() = default;
+	AllocationStats(const AllocationStats &) = delete;
+	AllocationStats &operator=(const AllocationStats &) = delete;
+
+	/// @brief Record an allocation
+	/// @param bytes Allocated size
+	void on_allocate(size_t bytes) noexcept
 	{
-		return std::any_of(m_data.begin(), m_data.end(),
-						   [&](const T &elem) { return elem == value; });
+		m_allocations.fetch_add(1, std::memory_order_relaxed);
+		m_bytes_total.fetch_add(bytes, std::memory_order_relaxed);
+		const uint64_t live = m_bytes_live.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+		uint64_t peak = m_bytes_peak.load(std::memory_order_relaxed);
+		while (live > peak && !m_bytes_peak.compare_exchange_weak(peak, live, std::memory_order_relaxed))
+		{
+		}
 	}
 
-	/// @brief Check if all elements satisfy predicate
-	/// @tparam Pred Predicate type
-	/// @param pred Predicate function
-	/// @return true if all elements satisfy predicate
-	template <typename Pred>
-	bool all_of(Pred pred) const
+	/// @brief Record a deallocation
+	/// @param bytes Released size
+	void on_deallocate(size_t bytes) noexcept
 	{
-		return std::all_of(m_data.begin(), m_data.end(), pred);
+		m_deallocations.fetch_add(1, std::memory_order_relaxed);
+		m_bytes_live.fetch_sub(bytes, std::memory_order_relaxed);
 	}
 
-	/// @brief Check if all elements equal value
-	/// @param value Value to compare
-	/// @return true if all elements equal value
-	bool all_of(const T &value) const
+	/// @brief Get number of allocations
+	uint64_t allocations() const noexcept { return m_allocations.load(std::memory_order_relaxed); }
+	/// @brief Get number of deallocations
+	uint64_t deallocations() const noexcept { return m_deallocations.load(std::memory_order_relaxed); }
+	/// @brief Get bytes ever allocated
+	uint64_t bytes_total() const noexcept { return m_bytes_total.load(std::memory_order_relaxed); }
+	/// @brief Get bytes currently allocated
+	uint64_t bytes_live() const noexcept { return m_bytes_live.load(std::memory_order_relaxed); }
+	/// @brief Get peak of bytes currently allocated
+	uint64_t bytes_peak() const noexcept { return m_bytes_peak.load(std::memory_order_relaxed); }
+
+	/// @brief Reset counters, the peak restarts from the live bytes
+	void reset() noexcept
 	{
-		return std::all_of(m_data.begin(), m_data.end(),
-						   [&](const T &elem) { return elem == value; });
+		m_allocations.store(0, std::memory_order_relaxed);
+		m_deallocations.store(0, std::memory_order_relaxed);
+		m_bytes_total.store(0, std::memory_order_relaxed);
+		m_bytes_peak.store(m_bytes_live.load(std::memory_order_relaxed), std::memory_order_relaxed);
 	}
 
-	/// @brief Check if no elements satisfy predicate
-	/// @tparam Pred Predicate type
-	/// @param pred Predicate function
-	/// @return true if no elements satisfy predicate
-	template <typename Pred>
-	bool none_of(Pred pred) const
+	/// @brief Print counters on one line
+	/// @param os Output stream (default std::cout)
+	void dump(ostream &os = cout) const
 	{
-		return std::none_of(m_data.begin(), m_data.end(), pred);
+		os << "allocations=" << allocations() << " deallocations=" << deallocations()
+		   << " bytes_total=" << bytes_total() << " bytes_live=" << bytes_live()
+		   << " bytes_peak=" << bytes_peak() << '\n';
 	}
+};
 
-	/// @brief Check if no elements equal value
-	/// @param value Value to compare
-	/// @return true if no elements equal value
-	bool none_of(const T &value) const
+namespace detail
+{
+/// @brief Registry of named allocation groups (entries are never removed)
+class AllocationGroups
+{
+  private:
+	std::mutex m_mutex;
+	vector<std::pair<string, std::unique_ptr<AllocationStats>>> m_groups;
+
+  public:
+	static AllocationGroups &instance()
 	{
-		return std::none_of(m_data.begin(), m_data.end(),
-							[&](const T &elem) { return elem == value; });
+		// Leaked on purpose so allocators may outlive static destruction
+		static AllocationGroups *s_instance = new AllocationGroups();
+		return *s_instance;
 	}
 
-	/// @brief Find all positions of value
-	/// @param value Value to find
-	/// @return Vector of positions where value appears
-	vector<size_t> find_all(const T &value) const
+	AllocationStats &get(const string &tag)
 	{
-		vector<size_t> positions;
-		for (size_t i = 0; i < m_data.size(); ++i)
+		std::lock_guard<std::mutex> lock(m_mutex);
+		for (auto &group : m_groups)
 		{
-			if (m_data[i] == value)
+			if (group.first == tag)
 			{
-				positions.push_back(i);
+				return *group.second;
 			}
 		}
-		return positions;
+		m_groups.emplace_back(tag, std::make_unique<AllocationStats>());
+		return *m_groups.back().second;
 	}
 
-	/// @brief Find all positions satisfying predicate
-	/// @tparam Pred Predicate type
-	/// @param pred Predicate function
-	/// @return Vector of positions satisfying predicate
-	template <typename Pred>
-	vector<size_t> find_all_if(Pred pred) const
+	void dump(ostream &os)
 	{
-		vector<size_t> positions;
-		for (size_t i = 0; i < m_data.size(); ++i)
+		std::lock_guard<std::mutex> lock(m_mutex);
+		for (const auto &group : m_groups)
 		{
-			if (pred(m_data[i]))
-			{
-				positions.push_back(i);
-			}
+			os << group.first << ": ";
+			group.second->dump(os);
 		}
-		return positions;
 	}
+};
+} // namespace detail
 
-	// =======================
-	// Transformation & Filtering
-	// =======================
+/// @brief Get (creating on first use) the counters of a tagged group
+/// @param tag Group name
+/// @return Counters shared by every allocator of the group
+inline AllocationStats &allocation_group(const string &tag)
+{
+	return detail::AllocationGroups::instance().get(tag);
+}
 
-	/// @brief Transform elements in-place
-	/// @tparam Func Function type
-	/// @param func Transformation function
-	template <typename Func>
-	void transform(Func func)
+/// @brief Print the counters of every tagged group
+/// @param os Output stream (default std::cout)
+inline void dump_allocation_groups(ostream &os = cout)
+{
+	detail::AllocationGroups::instance().dump(os);
+}
+
+/// @brief Allocator that forwards to std::allocator and records into AllocationStats
+/// @tparam T Value type
+template <typename T>
+class TrackingAllocator
+{
+  private:
+	AllocationStats *m_stats; // Never null
+
+	template <typename U>
+	friend class TrackingAllocator;
+
+  public:
+	using value_type = T;
+	using propagate_on_container_copy_assignment = std::true_type;
+	using propagate_on_container_move_assignment = std::true_type;
+	using propagate_on_container_swap = std::true_type;
+
+	/// @brief Allocator recording into the "default" group
+	TrackingAllocator() : m_stats(&allocation_group("default")) {}
+
+	/// @brief Allocator recording into the given counters
+	/// @param stats Counters, must outlive every container using the allocator
+	explicit TrackingAllocator(AllocationStats &stats) noexcept : m_stats(&stats) {}
+
+	/// @brief Allocator recording into a tagged group
+	/// @param tag Group name
+	explicit TrackingAllocator(const string &tag) : m_stats(&allocation_group(tag)) {}
+
+	/// @brief Rebinding constructor
+	template <typename U>
+	TrackingAllocator(const TrackingAllocator<U> &other) noexcept : m_stats(other.m_stats) {}
+
+	T *allocate(size_t n)
 	{
-		std::transform(m_data.begin(), m_data.end(), m_data.begin(), func);
+		T *p = std::allocator<T>().allocate(n);
+		m_stats->on_allocate(n * sizeof(T));
+		return p;
 	}
 
-	/// @brief Filter elements based on predicate
-	/// @tparam Pred Predicate type
-	/// @param pred Predicate function
-	/// @return New store with filtered elements
-	template <typename Pred>
-	Store<T> filter(Pred pred) const
+	void deallocate(T *p, size_t n) noexcept
 	{
-		Store<T> result;
-		for (const auto &elem : m_data)
-		{
-			if (pred(elem))
-			{
-				result.push_back(elem);
-			}
-		}
-		return result;
+		m_stats->on_deallocate(n * sizeof(T));
+		std::allocator<T>().deallocate(p, n);
 	}
 
-	// =======================
-	// Sorting
-	// =======================
+	/// @brief Get the counters this allocator records into
+	/// @return Reference to counters
+	AllocationStats &stats() const noexcept
+	{
+		return *m_stats;
+	}
 
-	/// @brief Sort elements
-	/// @param ascending Whether to sort in ascending order (default true)
-	void sort(bool ascending = true)
+	template <typename U>
+	bool operator==(const TrackingAllocator<U> &other) const noexcept
 	{
-		if (ascending)
-		{
-			std::sort(m_data.begin(), m_data.end());
-		}
-		else
-		{
-			std::sort(m_data.begin(), m_data.end(), std::greater<T>());
-		}
+		return m_stats == other.m_stats;
 	}
 
-	/// @brief Sort with custom comparator
-	/// @tparam Compare Comparator type
-	/// @param comp Comparator function
+	template <typename U>
+	bool operator!=(const TrackingAllocator<U> &other) const noexcept
+	{
+		return m_stats != other.m_stats;
+	}
+};
+
+// =======================
+// Capacity Policy
+// =======================
+
+/// @brief Growth and shrink rules applied automatically by Store
+/// @details The default policy keeps std::vector behaviour. Shrinking is
+///          checked after pop_back, pop_front, remove_at and clear. To avoid
+///          grow/shrink thrash, shrink_threshold * growth factor must be < 1:
+///          a shrunk store keeps headroom of one growth factor.
+struct CapacityPolicy
+{
+	double growth_factor = 0.0;	   // Capacity multiplier when full (0 = std::vector default)
+	double shrink_threshold = 0.0; // Shrink when size < capacity * threshold (0 = never)
+	size_t min_capacity = 0;	   // Never shrink below, and grow at least to, this capacity
+
+	/// @brief Policy for pop-heavy stores: grow x2, shrink below 1/4 full
+	/// @param min_capacity Capacity kept even when empty
+	/// @return Policy
+	static CapacityPolicy adaptive(size_t min_capacity = 16) noexcept
+	{
+		return CapacityPolicy{2.0, 0.25, min_capacity};
+	}
+
+	/// @brief Growth factor used for shrink headroom (2 when left to std::vector)
+	/// @return Factor greater than 1
+	double effective_growth() const noexcept
+	{
+		return growth_factor > 1.0 ? growth_factor : 2.0;
+	}
+
+	/// @brief Check the policy has hysteresis and sane factors
+	/// @return true if valid
+	bool valid() const noexcept
+	{
+		const bool growth_ok = growth_factor == 0.0 || growth_factor > 1.0;
+		const bool shrink_ok = shrink_threshold >= 0.0 && shrink_threshold < 1.0;
+		return growth_ok && shrink_ok && shrink_threshold * effective_growth() < 1.0;
+	}
+};
+
+// =======================
+// Memory Footprint
+// =======================
+
+/// @brief Memory held by a Store
+struct MemoryUsage
+{
+	size_t payload = 0; // Bytes of constructed elements (size * sizeof(T))
+	size_t slack = 0;	// Bytes reserved but unused ((capacity - size) * sizeof(T))
+	size_t deep = 0;	// Heap bytes owned by the elements (strings, nested Stores)
+
+	/// @brief Get total heap bytes
+	/// @return payload + slack + deep
+	size_t total() const noexcept
+	{
+		return payload + slack + deep;
+	}
+};
+
+template <typename T, typename Alloc>
+class Store;
+
+// =======================
+// Modification Tracking
+// =======================
+
+namespace detail
+{
+/// @brief Per-object modification counter that never repeats a value
+/// @details Assignment makes the target's value larger than any it held
+///          before and moving bumps the source, so an observer remembering
+///          (object, value) always notices that the contents changed.
+///          rewritten() is the last value at which existing elements may
+///          have moved or changed; bump_local() marks changes that left them
+///          alone (appends) or were logged position by position.
+class Version
+{
+  private:
+	uint64_t m_value = 0;
+	uint64_t m_rewritten = 0;
+
+  public:
+	Version() = default;
+	Version(const Version &other) noexcept : m_value(other.m_value), m_rewritten(other.m_rewritten) {}
+	Version(Version &&other) noexcept : m_value(other.m_value), m_rewritten(other.m_rewritten) { other.bump(); }
+
+	Version &operator=(const Version &other) noexcept
+	{
+		m_value = std::max(m_value, other.m_value) + 1;
+		m_rewritten = m_value;
+		return *this;
+	}
+
+	Version &operator=(Version &&other) noexcept
+	{
+		m_value = std::max(m_value, other.m_value) + 1;
+		m_rewritten = m_value;
+		other.bump();
+		return *this;
+	}
+
+	void bump() noexcept { m_rewritten = ++m_value; }
+	void bump_local() noexcept { ++m_value; }
+	uint64_t value() const noexcept { return m_value; }
+	uint64_t rewritten() const noexcept { return m_rewritten; }
+};
+
+/// @brief Bounded log of (version, position) for single-element writes
+/// @details Keeps the last k_capacity entries; older ones are dropped and
+///          complete_after() moves past them, so a reader knows whether the
+///          log still describes every write since a given version.
+class ChangeLog
+{
+  private:
+	static constexpr size_t k_capacity = 64;
+
+	vector<std::pair<uint64_t, size_t>> m_entries; // Ring once full
+	size_t m_next = 0;							   // Oldest entry once full
+	uint64_t m_complete_after = 0;				   // Every write after this version is logged
+
+  public:
+	void record(uint64_t version, size_t pos)
+	{
+		if (m_entries.size() < k_capacity)
+		{
+			m_entries.emplace_back(version, pos);
+			return;
+		}
+		m_complete_after = m_entries[m_next].first;
+		m_entries[m_next] = {version, pos};
+		m_next = (m_next + 1) % k_capacity;
+	}
+
+	bool covers(uint64_t since) const noexcept { return since >= m_complete_after; }
+
+	/// @brief Call f(pos) for every write logged after version since
+	template <typename Func>
+	void for_each_after(uint64_t since, Func f) const
+	{
+		for (const auto &entry : m_entries)
+		{
+			if (entry.first > since)
+			{
+				f(entry.second);
+			}
+		}
+	}
+};
+
+/// @brief Index of the highest set bit, x must be non-zero
+inline size_t floor_log2(uint64_t x) noexcept
+{
+#if defined(__GNUC__) || defined(__clang__)
+	return 63 - static_cast<size_t>(__builtin_clzll(static_cast<unsigned long long>(x)));
+#else
+	size_t bit = 0;
+	while (x >>= 1)
+	{
+		++bit;
+	}
+	return bit;
+#endif
+}
+
+/// @brief Spread the bits of a std::hash result (often the identity)
+inline uint64_t mix_hash(uint64_t h) noexcept
+{
+	h ^= h >> 33;
+	h *= 0xff51afd7ed558ccdULL;
+	h ^= h >> 33;
+	h *= 0xc4ceb9fe1a85ec53ULL;
+	h ^= h >> 33;
+	return h;
+}
+
+template <typename U, typename = void>
+struct is_hashable : std::false_type
+{
+};
+
+template <typename U>
+struct is_hashable<U, std::void_t<decltype(std::hash<U>()(std::declval<const U &>()))>> : std::true_type
+{
+};
+
+/// @brief Types with begin()/end() members, accepted by the Range constructor
+template <typename U, typename = void>
+struct is_iterable : std::false_type
+{
+};
+
+template <typename U>
+struct is_iterable<U, std::void_t<decltype(std::declval<const U &>().begin()),
+								  decltype(std::declval<const U &>().end())>> : std::true_type
+{
+};
+
+/// @brief Element types a range index can be built over (ordered, not bool)
+template <typename U, typename = void>
+struct is_range_indexable : std::false_type
+{
+};
+
+template <typename U>
+struct is_range_indexable<U, std::void_t<decltype(std::declval<const U &>() < std::declval<const U &>())>>
+	: std::bool_constant<!std::is_same_v<U, bool>>
+{
+};
+
+/// @brief Store version a lazily built cache describes
+/// @details Read by concurrent const callers: the release store in stamp()
+///          publishes the cache contents written before it. Copies carry
+///          the stamp over.
+class CacheStamp
+{
+  private:
+	std::atomic<uint64_t> m_value{0}; // Version + 1, 0 when not built
+
+  public:
+	CacheStamp() = default;
+	CacheStamp(const CacheStamp &other) noexcept : m_value(other.m_value.load(std::memory_order_relaxed)) {}
+
+	CacheStamp &operator=(const CacheStamp &other) noexcept
+	{
+		m_value.store(other.m_value.load(std::memory_order_relaxed), std::memory_order_relaxed);
+		return *this;
+	}
+
+	bool current(uint64_t version) const noexcept { return m_value.load(std::memory_order_acquire) == version + 1; }
+	void stamp(uint64_t version) noexcept { m_value.store(version + 1, std::memory_order_release); }
+	void clear() noexcept { m_value.store(0, std::memory_order_relaxed); }
+};
+
+/// @brief Optional cache of a Store, allocated only once enabled
+/// @details A store that never enables the cache pays one pointer. The
+///          cache is mutable state of a const store, so get() hands out a
+///          non-const pointer; the cache serializes its own rebuilds. Copies
+///          deep-copy the cache, moves transfer it.
+/// @tparam C Cache type
+template <typename C>
+class CacheSlot
+{
+  private:
+	std::unique_ptr<C> m_cache; // nullptr when disabled
+
+  public:
+	CacheSlot() = default;
+	CacheSlot(const CacheSlot &other) : m_cache(other.m_cache ? std::make_unique<C>(*other.m_cache) : nullptr) {}
+	CacheSlot(CacheSlot &&other) noexcept = default;
+
+	CacheSlot &operator=(const CacheSlot &other)
+	{
+		if (this != &other)
+		{
+			CacheSlot copy(other);
+			m_cache = std::move(copy.m_cache);
+		}
+		return *this;
+	}
+
+	CacheSlot &operator=(CacheSlot &&other) noexcept = default;
+
+	explicit operator bool() const noexcept { return m_cache != nullptr; }
+	C *get() const noexcept { return m_cache.get(); }
+
+	template <typename... Args>
+	void emplace(Args &&...args)
+	{
+		m_cache = std::make_unique<C>(std::forward<Args>(args)...);
+	}
+
+	void reset() noexcept { m_cache.reset(); }
+};
+
+/// @brief Split-block Bloom filter over 64-bit hashes
+/// @details Each key sets one bit in each of the 8 words of a 32-byte block,
+///          so a query touches a single cache line. About 1% false positives
+///          at 10 bits per key; no false negatives.
+class MembershipFilter
+{
+  private:
+	static constexpr size_t k_block_words = 8;
+	static constexpr size_t k_block_bits = k_block_words * 32;
+
+	vector<uint32_t> m_words;	// k_block_words per block
+	size_t m_blocks = 0;
+	size_t m_bits_per_key;
+	CacheStamp m_stamp;			// Store version the bits describe
+	mutable std::mutex m_mutex; // Serializes rebuilds and copies by const callers
+
+	static uint32_t bit_of(uint64_t hash, size_t word) noexcept
+	{
+		static constexpr uint32_t k_salts[k_block_words] = {0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU,
+															0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U};
+		return uint32_t(1) << ((static_cast<uint32_t>(hash) * k_salts[word]) >> 27);
+	}
+
+	size_t block_of(uint64_t hash) const noexcept
+	{
+		return static_cast<size_t>(((hash >> 32) * static_cast<uint64_t>(m_blocks)) >> 32);
+	}
+
+  public:
+	explicit MembershipFilter(size_t bits_per_key) noexcept : m_bits_per_key(bits_per_key) {}
+
+	MembershipFilter(const MembershipFilter &other)
+	{
+		std::lock_guard<std::mutex> lock(other.m_mutex);
+		m_words = other.m_words;
+		m_blocks = other.m_blocks;
+		m_bits_per_key = other.m_bits_per_key;
+		m_stamp = other.m_stamp;
+	}
+
+	MembershipFilter &operator=(const MembershipFilter &) = delete;
+
+	bool current(uint64_t version) const noexcept { return m_stamp.current(version); }
+
+	/// @brief Rebuild from keys unless the bits already describe version
+	/// @details Safe to call from concurrent const callers of the owning store.
+	template <typename Keys, typename Hash>
+	void ensure(const Keys &keys, uint64_t version, Hash hash)
+	{
+		if (current(version))
+		{
+			return;
+		}
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (current(version))
+		{
+			return;
+		}
+		reset(keys.size());
+		for (const auto &key : keys)
+		{
+			add(hash(key));
+		}
+		m_stamp.stamp(version);
+	}
+	size_t bytes() const noexcept { return m_words.capacity() * sizeof(uint32_t); }
+
+	/// @brief Clear and size the filter for keys entries
+	void reset(size_t keys)
+	{
+		m_stamp.clear();
+		m_blocks = std::max<size_t>(1, (keys * m_bits_per_key + k_block_bits - 1) / k_block_bits);
+		m_blocks = std::min<size_t>(m_blocks, size_t(1) << 31);
+		m_words.assign(m_blocks * k_block_words, 0);
+	}
+
+	void add(uint64_t hash) noexcept
+	{
+		uint32_t *block = &m_words[block_of(hash) * k_block_words];
+		for (size_t i = 0; i < k_block_words; ++i)
+		{
+			block[i] |= bit_of(hash, i);
+		}
+	}
+
+	/// @brief Check a hash, false means certainly absent
+	bool may_contain(uint64_t hash) const noexcept
+	{
+		const uint32_t *block = &m_words[block_of(hash) * k_block_words];
+		uint32_t missing = 0;
+		for (size_t i = 0; i < k_block_words; ++i)
+		{
+			missing |= bit_of(hash, i) & ~block[i];
+		}
+		return missing == 0;
+	}
+};
+
+/// @brief Number of set bits
+inline size_t popcount(uint64_t x) noexcept
+{
+#if defined(__GNUC__) || defined(__clang__)
+	return static_cast<size_t>(__builtin_popcountll(static_cast<unsigned long long>(x)));
+#else
+	size_t count = 0;
+	for (; x != 0; x &= x - 1)
+	{
+		++count;
+	}
+	return count;
+#endif
+}
+
+/// @brief Index of the lowest set bit, x must be non-zero
+inline size_t lowest_bit(uint64_t x) noexcept
+{
+#if defined(__GNUC__) || defined(__clang__)
+	return static_cast<size_t>(__builtin_ctzll(static_cast<unsigned long long>(x)));
+#else
+	size_t bit = 0;
+	for (; (x & 1) == 0; x >>= 1)
+	{
+		++bit;
+	}
+	return bit;
+#endif
+}
+
+/// @brief Minimal perfect hash over distinct 64-bit hashes (BBHash-style)
+/// @details Each level is a bit array of gamma bits per remaining key; a key
+///          whose slot is taken by no other key sets its bit there, colliding
+///          keys retry on the next level with a new seed. A key's index is
+///          the rank of its bit across all levels. Bits are packed seven words
+///          to a 64-byte block next to the count of set bits before the block,
+///          so probing a level reads one cache line. About 3.5 bits per key
+///          and 1.6 levels per lookup on average.
+class MinimalPerfectHash
+{
+  private:
+	static constexpr size_t k_max_levels = 32;
+	static constexpr size_t k_gamma = 2;
+	static constexpr size_t k_block_words = 7;
+	static constexpr size_t k_block_bits = k_block_words * 64;
+
+	struct alignas(64) Block
+	{
+		uint64_t rank; // Set bits in all earlier blocks
+		uint64_t words[k_block_words];
+	};
+
+	vector<Block> m_blocks;		   // All levels, each a whole number of blocks
+	vector<size_t> m_level_offset; // First block of each level, plus the end
+	size_t m_keys = 0;			   // Keys with an index
+
+	static uint64_t level_hash(uint64_t hash, size_t level) noexcept
+	{
+		return mix_hash(hash + 0x9e3779b97f4a7c15ULL * (level + 1));
+	}
+
+	/// @brief Map a level hash onto [0, bits) without a division
+	static size_t slot_of(uint64_t hash, size_t bits) noexcept
+	{
+		return static_cast<size_t>(((hash >> 32) * static_cast<uint64_t>(bits)) >> 32);
+	}
+
+	uint64_t &word_at(size_t base, size_t slot) noexcept
+	{
+		const size_t word = slot / 64;
+		return m_blocks[base + word / k_block_words].words[word % k_block_words];
+	}
+
+  public:
+	/// @brief Build over distinct hashes
+	/// @param hashes Distinct hashes
+	/// @return Hashes left without an index (normally none), in input order
+	vector<uint64_t> build(vector<uint64_t> hashes)
+	{
+		m_blocks.clear();
+		m_level_offset.assign(1, 0);
+		vector<uint64_t> collisions;
+		for (size_t level = 0; level < k_max_levels && !hashes.empty(); ++level)
+		{
+			const size_t blocks = (hashes.size() * k_gamma + k_block_bits - 1) / k_block_bits;
+			const size_t bits = blocks * k_block_bits;
+			const size_t base = m_blocks.size();
+			m_blocks.resize(base + blocks, Block{});
+			collisions.assign(bits / 64, 0);
+			for (const uint64_t hash : hashes)
+			{
+				const size_t slot = slot_of(level_hash(hash, level), bits);
+				const uint64_t bit = uint64_t(1) << (slot % 64);
+				uint64_t &word = word_at(base, slot);
+				collisions[slot / 64] |= word & bit;
+				word |= bit;
+			}
+			size_t kept = 0;
+			for (const uint64_t hash : hashes)
+			{
+				const size_t slot = slot_of(level_hash(hash, level), bits);
+				if (collisions[slot / 64] & (uint64_t(1) << (slot % 64)))
+				{
+					hashes[kept++] = hash;
+				}
+			}
+			hashes.resize(kept);
+			for (size_t w = 0; w < collisions.size(); ++w)
+			{
+				word_at(base, w * 64) &= ~collisions[w];
+			}
+			m_level_offset.push_back(m_blocks.size());
+		}
+
+		uint64_t total = 0;
+		for (auto &block : m_blocks)
+		{
+			block.rank = total;
+			for (const uint64_t word : block.words)
+			{
+				total += popcount(word);
+			}
+		}
+		m_keys = static_cast<size_t>(total);
+		m_blocks.shrink_to_fit();
+		return hashes;
+	}
+
+	/// @brief Number of keys with an index
+	size_t size() const noexcept { return m_keys; }
+
+	/// @brief Index in [0, size()) of a built hash, arbitrary for others
+	/// @return Index, or size() if the hash reaches no level (never for built hashes)
+	size_t lookup(uint64_t hash) const noexcept
+	{
+		for (size_t level = 0; level + 1 < m_level_offset.size(); ++level)
+		{
+			const size_t base = m_level_offset[level];
+			const size_t bits = (m_level_offset[level + 1] - base) * k_block_bits;
+			const size_t slot = slot_of(level_hash(hash, level), bits);
+			const size_t word = slot / 64;
+			const Block &block = m_blocks[base + word / k_block_words];
+			const size_t inner = word % k_block_words;
+			const uint64_t bit = uint64_t(1) << (slot % 64);
+			if (block.words[inner] & bit)
+			{
+				size_t rank = static_cast<size_t>(block.rank);
+				for (size_t w = 0; w < inner; ++w)
+				{
+					rank += popcount(block.words[w]);
+				}
+				return rank + popcount(block.words[inner] & (bit - 1));
+			}
+		}
+		return m_keys;
+	}
+
+	/// @brief Get bytes held by the bit arrays
+	size_t bytes() const noexcept
+	{
+		return m_blocks.capacity() * sizeof(Block) + m_level_offset.capacity() * sizeof(size_t);
+	}
+};
+
+/// @brief Fenwick tree for sums and segment trees for min/max over a Store
+/// @details Point updates and queries are O(log n). The Fenwick tree exists
+///          only for arithmetic T; floating-point sums are prefix
+///          differences and may round differently from a direct sum.
+template <typename T>
+class RangeTrees
+{
+  private:
+	static constexpr bool k_summable = std::is_arithmetic_v<T> && !std::is_same_v<T, bool>;
+
+	vector<T> m_fenwick; // 1-based, empty unless k_summable
+	vector<T> m_min;	 // Segment tree, leaves at [m_size, 2 * m_size)
+	vector<T> m_max;
+	size_t m_size = 0;
+	CacheStamp m_stamp;			// Store version the trees describe
+	mutable std::mutex m_mutex; // Serializes rebuilds and copies by const callers
+
+	static const T &smaller(const T &a, const T &b) { return b < a ? b : a; }
+	static const T &larger(const T &a, const T &b) { return a < b ? b : a; }
+
+	void pull(size_t leaf)
+	{
+		for (size_t node = leaf / 2; node >= 1; node /= 2)
+		{
+			m_min[node] = smaller(m_min[2 * node], m_min[2 * node + 1]);
+			m_max[node] = larger(m_max[2 * node], m_max[2 * node + 1]);
+		}
+	}
+
+	T prefix(size_t end) const
+	{
+		T total = T();
+		for (; end > 0; end &= end - 1)
+		{
+			total += m_fenwick[end];
+		}
+		return total;
+	}
+
+  public:
+	RangeTrees() = default;
+
+	RangeTrees(const RangeTrees &other)
+	{
+		std::lock_guard<std::mutex> lock(other.m_mutex);
+		m_fenwick = other.m_fenwick;
+		m_min = other.m_min;
+		m_max = other.m_max;
+		m_size = other.m_size;
+		m_stamp = other.m_stamp;
+	}
+
+	RangeTrees &operator=(const RangeTrees &) = delete;
+
+	bool current(uint64_t version) const noexcept { return m_stamp.current(version); }
+	void stamp(uint64_t version) noexcept { m_stamp.stamp(version); }
+
+	/// @brief Rebuild from the elements unless the trees already describe version
+	/// @details Safe to call from concurrent const callers of the owning store.
+	template <typename Data>
+	void ensure(const Data &data, uint64_t version)
+	{
+		if (current(version))
+		{
+			return;
+		}
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (!current(version))
+		{
+			build(data, version);
+		}
+	}
+
+	/// @brief Build all trees from the elements, O(n)
+	template <typename Data>
+	void build(const Data &data, uint64_t version)
+	{
+		m_stamp.clear();
+		m_size = data.size();
+		m_min.clear();
+		m_max.clear();
+		if (m_size != 0)
+		{
+			m_min.assign(2 * m_size, data[0]);
+			std::copy(data.begin(), data.end(), m_min.begin() + m_size);
+			m_max = m_min;
+			for (size_t node = m_size - 1; node >= 1; --node)
+			{
+				m_min[node] = smaller(m_min[2 * node], m_min[2 * node + 1]);
+				m_max[node] = larger(m_max[2 * node], m_max[2 * node + 1]);
+			}
+		}
+		if constexpr (k_summable)
+		{
+			m_fenwick.assign(m_size + 1, T());
+			for (size_t i = 1; i <= m_size; ++i)
+			{
+				m_fenwick[i] += data[i - 1];
+				const size_t parent = i + (i & (~i + 1));
+				if (parent <= m_size)
+				{
+					m_fenwick[parent] += m_fenwick[i];
+				}
+			}
+		}
+		m_stamp.stamp(version);
+	}
+
+	/// @brief Replace one element, O(log n)
+	void set(size_t pos, const T &old_value, const T &value)
+	{
+		if constexpr (k_summable)
+		{
+			const T delta = static_cast<T>(value - old_value);
+			for (size_t i = pos + 1; i <= m_size; i += i & (~i + 1))
+			{
+				m_fenwick[i] += delta;
+			}
+		}
+		m_min[m_size + pos] = value;
+		m_max[m_size + pos] = value;
+		pull(m_size + pos);
+	}
+
+	/// @brief Set every element to value, O(n)
+	void fill(const T &value)
+	{
+		std::fill(m_min.begin(), m_min.end(), value);
+		std::fill(m_max.begin(), m_max.end(), value);
+		if constexpr (k_summable)
+		{
+			for (size_t i = 1; i <= m_size; ++i)
+			{
+				m_fenwick[i] = static_cast<T>(value * static_cast<T>(i & (~i + 1)));
+			}
+		}
+	}
+
+	T sum(size_t first, size_t last) const
+	{
+		return static_cast<T>(prefix(last) - prefix(first));
+	}
+
+	/// @brief Minimum of a non-empty range
+	const T &min(size_t first, size_t last) const
+	{
+		const T *best = &m_min[m_size + first];
+		for (size_t lo = first + m_size, hi = last + m_size; lo < hi; lo /= 2, hi /= 2)
+		{
+			if (lo & 1)
+			{
+				best = &smaller(*best, m_min[lo++]);
+			}
+			if (hi & 1)
+			{
+				best = &smaller(*best, m_min[--hi]);
+			}
+		}
+		return *best;
+	}
+
+	/// @brief Maximum of a non-empty range
+	const T &max(size_t first, size_t last) const
+	{
+		const T *best = &m_max[m_size + first];
+		for (size_t lo = first + m_size, hi = last + m_size; lo < hi; lo /= 2, hi /= 2)
+		{
+			if (lo & 1)
+			{
+				best = &larger(*best, m_max[lo++]);
+			}
+			if (hi & 1)
+			{
+				best = &larger(*best, m_max[--hi]);
+			}
+		}
+		return *best;
+	}
+};
+} // namespace detail
+
+/// @brief Key function returning the element itself
+struct IdentityKey
+{
+	template <typename U>
+	const U &operator()(const U &value) const noexcept
+	{
+		return value;
+	}
+};
+
+template <typename T, typename Alloc, typename KeyFn>
+class StoreIndex;
+
+template <typename T, typename Alloc>
+class StoreRmq;
+
+template <typename T, typename Alloc>
+class StoreSearch;
+
+template <typename T>
+class FrozenStore;
+
+template <typename T, typename Alloc, typename Pred>
+class LiveFilter;
+
+/// @brief Half-open position range [first, last) for batch range queries
+struct RangeQuery
+{
+	size_t first;
+	size_t last;
+};
+
+namespace detail
+{
+struct StoreAccess;
+} // namespace detail
+
+// =======================
+// SIMD Dispatch
+// =======================
+// max(), min(), sum(), contains(), count(), find_all() and filter() run
+// vector kernels on 32/64-bit integers, float and double. The kernels are
+// compiled for SSE2, AVX2 and AVX-512 through per-function target
+// attributes, so no -m flags are needed, and the level is chosen once from
+// cpuid. Define ADV_STORE_NO_SIMD before including this header to keep only
+// the scalar paths.
+
+/// @brief Instruction set level used by the Store kernels
+enum class SimdLevel : unsigned char
+{
+	scalar,
+	sse2,
+	avx2,
+	avx512 // AVX-512F
+};
+
+/// @brief Get printable name of a SIMD level
+/// @param level Level
+/// @return Level name
+inline const char *simd_level_name(SimdLevel level) noexcept
+{
+	static const char *const s_names[] = {"scalar", "sse2", "avx2", "avx512"};
+	const size_t index = static_cast<size_t>(level);
+	return index < 4 ? s_names[index] : "unknown";
+}
+
+namespace detail
+{
+/// @brief Best level supported by both the CPU and the OS (saved register state)
+inline SimdLevel detect_simd_level() noexcept
+{
+#if defined(ADV_STORE_SIMD_X86) && (defined(__GNUC__) || defined(__clang__))
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx512f"))
+	{
+		return SimdLevel::avx512;
+	}
+	if (__builtin_cpu_supports("avx2"))
+	{
+		return SimdLevel::avx2;
+	}
+	return __builtin_cpu_supports("sse2") ? SimdLevel::sse2 : SimdLevel::scalar;
+#elif defined(ADV_STORE_SIMD_X86)
+	int info[4];
+	__cpuid(info, 0);
+	const int max_leaf = info[0];
+	__cpuid(info, 1);
+	const bool sse2 = (info[3] & (1 << 26)) != 0;
+	const bool osxsave = (info[2] & (1 << 27)) != 0;
+	const unsigned long long xcr0 = osxsave ? _xgetbv(0) : 0;
+	bool avx2 = false;
+	bool avx512 = false;
+	if (max_leaf >= 7)
+	{
+		__cpuidex(info, 7, 0);
+		avx2 = (info[1] & (1 << 5)) != 0;
+		avx512 = (info[1] & (1 << 16)) != 0;
+	}
+	if (avx512 && (xcr0 & 0xe6) == 0xe6) // SSE, AVX, opmask and ZMM state
+	{
+		return SimdLevel::avx512;
+	}
+	if (avx2 && (xcr0 & 0x6) == 0x6) // SSE and AVX state
+	{
+		return SimdLevel::avx2;
+	}
+	return sse2 ? SimdLevel::sse2 : SimdLevel::scalar;
+#else
+	return SimdLevel::scalar;
+#endif
+}
+
+/// @brief Level set by force_simd_level(), -1 when not forced
+inline std::atomic<int> &forced_simd_level() noexcept
+{
+	static std::atomic<int> s_level{-1};
+	return s_level;
+}
+} // namespace detail
+
+/// @brief Get the best level this machine supports
+/// @details Detected on first use and cached.
+/// @return Detected level
+inline SimdLevel detected_simd_level() noexcept
+{
+	static const SimdLevel s_level = detail::detect_simd_level();
+	return s_level;
+}
+
+/// @brief Get the level the Store kernels currently run at
+/// @return Forced level if set, detected level otherwise
+inline SimdLevel simd_level() noexcept
+{
+	const int forced = detail::forced_simd_level().load(std::memory_order_relaxed);
+	return forced < 0 ? detected_simd_level() : static_cast<SimdLevel>(forced);
+}
+
+/// @brief Run the kernels at a lower level, e.g. to test the fallback paths
+/// @details Clamped to detected_simd_level(), so forcing avx512 on an AVX2
+///          machine selects avx2. Applies to all threads.
+/// @param level Requested level
+/// @return Level now in use
+inline SimdLevel force_simd_level(SimdLevel level) noexcept
+{
+	const SimdLevel used = std::min(level, detected_simd_level());
+	detail::forced_simd_level().store(static_cast<int>(used), std::memory_order_relaxed);
+	return used;
+}
+
+/// @brief Return to the detected level after force_simd_level()
+inline void reset_simd_level() noexcept
+{
+	detail::forced_simd_level().store(-1, std::memory_order_relaxed);
+}
+
+/// @brief Comparison tested by the compare kernels and predicate objects
+enum class CompareOp : unsigned char
+{
+	eq,
+	ne,
+	lt,
+	le,
+	gt,
+	ge,
+	between // lo <= x && x <= hi
+};
+
+namespace detail
+{
+namespace simd
+{
+/// @brief Element types with vector kernels: 32/64-bit integers, float, double
+template <typename T>
+inline constexpr bool k_vectorizable =
+	std::is_integral_v<T> ? !std::is_same_v<T, bool> && (sizeof(T) == 4 || sizeof(T) == 8)
+						  : std::is_same_v<T, float> || std::is_same_v<T, double>;
+
+/// @brief Element types with vector min/max (unsigned integers use the scalar path)
+template <typename T>
+inline constexpr bool k_ordered = k_vectorizable<T> && std::is_signed_v<T>;
+
+/// @brief Type the kernels compute in: integers by width, floats as themselves
+template <typename T>
+using lane_t = std::conditional_t<std::is_floating_point_v<T>, T,
+								  std::conditional_t<sizeof(T) == 4, int32_t, int64_t>>;
+
+/// @brief Accumulator for sums: unsigned for integers so overflow wraps
+template <typename T>
+using sum_t = typename std::conditional_t<std::is_floating_point_v<T>, std::enable_if<true, T>,
+										  std::make_unsigned<lane_t<T>>>::type;
+
+/// @brief Partial sums kept by sum(), one 512-bit register worth
+/// @details Every level accumulates element i into partial i % k_sum_width
+///          and combines the partials in the same order, so floating point
+///          sums do not depend on the level.
+template <typename T>
+inline constexpr size_t k_sum_width = 64 / sizeof(T);
+
+/// @brief Elements examined per dispatch by find/count/find_all/filter
+inline constexpr size_t k_block = 1024;
+inline constexpr size_t k_block_words = k_block / 64;
+
+/// @brief Add the tail to the partial sums and combine them pairwise
+template <typename T>
+T finish_sum(sum_t<T> *partials, const T *tail, size_t count) noexcept
+{
+	for (size_t j = 0; j < count; ++j)
+	{
+		partials[j] += static_cast<sum_t<T>>(tail[j]);
+	}
+	for (size_t width = k_sum_width<T> / 2; width > 0; width /= 2)
+	{
+		for (size_t j = 0; j < width; ++j)
+		{
+			partials[j] += partials[j + width];
+		}
+	}
+	return static_cast<T>(partials[0]);
+}
+
+/// @brief Test one element against bound a (and b for between)
+template <CompareOp Op, typename X, typename A>
+bool compare(const X &x, const A &a, const A &b)
+{
+	if constexpr (Op == CompareOp::eq)
+	{
+		return x == a;
+	}
+	else if constexpr (Op == CompareOp::ne)
+	{
+		return x != a;
+	}
+	else if constexpr (Op == CompareOp::lt)
+	{
+		return x < a;
+	}
+	else if constexpr (Op == CompareOp::le)
+	{
+		return x <= a;
+	}
+	else if constexpr (Op == CompareOp::gt)
+	{
+		return x > a;
+	}
+	else if constexpr (Op == CompareOp::ge)
+	{
+		return x >= a;
+	}
+	else
+	{
+		static_cast<void>(b);
+		return a <= x && x <= b;
+	}
+}
+
+namespace scalar
+{
+template <CompareOp Op, typename T>
+void compare_masks(const T *x, size_t n, T a, T b, uint64_t *masks) noexcept
+{
+	for (size_t base = 0; base < n; base += 64)
+	{
+		const size_t len = std::min<size_t>(64, n - base);
+		uint64_t word = 0;
+		for (size_t j = 0; j < len; ++j)
+		{
+			word |= static_cast<uint64_t>(compare<Op>(x[base + j], a, b)) << j;
+		}
+		masks[base / 64] = word;
+	}
+}
+
+template <typename T>
+T sum(const T *x, size_t n) noexcept
+{
+	constexpr size_t width = k_sum_width<T>;
+	sum_t<T> partials[width] = {};
+	size_t i = 0;
+	for (; i + width <= n; i += width)
+	{
+		for (size_t j = 0; j < width; ++j)
+		{
+			partials[j] += static_cast<sum_t<T>>(x[i + j]);
+		}
+	}
+	return finish_sum(partials, x + i, n - i);
+}
+
+template <typename T>
+size_t compress(const T *x, const uint64_t *masks, size_t n, T *out) noexcept
+{
+	size_t k = 0;
+	for (size_t i = 0; i < n; ++i)
+	{
+		out[k] = x[i];
+		k += (masks[i / 64] >> (i % 64)) & 1;
+	}
+	return k;
+}
+} // namespace scalar
+
+#ifdef ADV_STORE_SIMD_X86
+#if defined(__GNUC__) || defined(__clang__)
+#define ADV_STORE_TARGET(isa) __attribute__((target(isa)))
+#else
+#define ADV_STORE_TARGET(isa)
+#endif
+
+/// @brief 32-bit lane permutation moving the lanes set in an 8-bit mask to the front
+struct CompressTable
+{
+	uint64_t entries[256]; // Eight byte-sized lane indices per mask
+
+	constexpr CompressTable() : entries()
+	{
+		for (unsigned mask = 0; mask < 256; ++mask)
+		{
+			uint64_t packed = 0;
+			unsigned next = 0;
+			for (unsigned lane = 0; lane < 8; ++lane)
+			{
+				if (mask & (1u << lane))
+				{
+					packed |= static_cast<uint64_t>(lane) << (8 * next++);
+				}
+			}
+			entries[mask] = packed;
+		}
+	}
+};
+
+inline constexpr CompressTable k_compress_table{};
+
+/// @brief 4-bit mask of 64-bit lanes widened to the matching 8-bit mask of 32-bit lanes
+inline constexpr unsigned char k_pair_masks[16] = {0x00, 0x03, 0x0c, 0x0f, 0x30, 0x33, 0x3c, 0x3f,
+												   0xc0, 0xc3, 0xcc, 0xcf, 0xf0, 0xf3, 0xfc, 0xff};
+
+/// @brief Vector operations for one level and lane type
+/// @details eq(), lt(), le() and unordered() return one bit per lane; bias()
+///          flips the sign bit so that signed compares order unsigned lanes
+///          (SSE2 int64 has no ordered compares). compress() stores
+///          a full vector whose first popcount(mask) lanes are the selected
+///          ones, so callers need k_lanes writable elements at out.
+template <SimdLevel Level, typename Lane>
+struct Vec;
+
+template <>
+struct Vec<SimdLevel::sse2, int32_t>
+{
+	using V = __m128i;
+	static constexpr size_t k_lanes = 4;
+	static constexpr bool k_ordered = true;
+	static constexpr bool k_compress = false;
+
+	ADV_STORE_TARGET("sse2") static V load(const void *p) noexcept { return _mm_loadu_si128(static_cast<const __m128i *>(p)); }
+	ADV_STORE_TARGET("sse2") static void store(void *p, V v) noexcept { _mm_storeu_si128(static_cast<__m128i *>(p), v); }
+	ADV_STORE_TARGET("sse2") static V set1(int32_t x) noexcept { return _mm_set1_epi32(x); }
+	ADV_STORE_TARGET("sse2") static V add(V a, V b) noexcept { return _mm_add_epi32(a, b); }
+	ADV_STORE_TARGET("sse2") static unsigned eq(V a, V b) noexcept { return static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(a, b)))); }
+	ADV_STORE_TARGET("sse2") static unsigned unordered(V) noexcept { return 0; }
+	ADV_STORE_TARGET("sse2") static unsigned lt(V a, V b) noexcept { return static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(_mm_cmplt_epi32(a, b)))); }
+	ADV_STORE_TARGET("sse2") static unsigned le(V a, V b) noexcept { return ~static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(a, b)))) & 0xf; }
+	ADV_STORE_TARGET("sse2") static V bias(V a) noexcept { return _mm_xor_si128(a, _mm_set1_epi32(std::numeric_limits<int32_t>::min())); }
+	ADV_STORE_TARGET("sse2") static V max(V a, V b) noexcept
+	{
+		const V gt = _mm_cmpgt_epi32(a, b);
+		return _mm_or_si128(_mm_and_si128(gt, a), _mm_andnot_si128(gt, b));
+	}
+	ADV_STORE_TARGET("sse2") static V min(V a, V b) noexcept
+	{
+		const V gt = _mm_cmpgt_epi32(a, b);
+		return _mm_or_si128(_mm_and_si128(gt, b), _mm_andnot_si128(gt, a));
+	}
+};
+
+template <>
+struct Vec<SimdLevel::sse2, int64_t>
+{
+	using V = __m128i;
+	static constexpr size_t k_lanes = 2;
+	static constexpr bool k_ordered = false; // No 64-bit compare before SSE4.2
+	static constexpr bool k_compress = false;
+
+	ADV_STORE_TARGET("sse2") static V load(const void *p) noexcept { return _mm_loadu_si128(static_cast<const __m128i *>(p)); }
+	ADV_STORE_TARGET("sse2") static void store(void *p, V v) noexcept { _mm_storeu_si128(static_cast<__m128i *>(p), v); }
+	ADV_STORE_TARGET("sse2") static V set1(int64_t x) noexcept { return _mm_set1_epi64x(x); }
+	ADV_STORE_TARGET("sse2") static V add(V a, V b) noexcept { return _mm_add_epi64(a, b); }
+	ADV_STORE_TARGET("sse2") static unsigned eq(V a, V b) noexcept
+	{
+		const V halves = _mm_cmpeq_epi32(a, b);
+		const V both = _mm_and_si128(halves, _mm_shuffle_epi32(halves, _MM_SHUFFLE(2, 3, 0, 1)));
+		return static_cast<unsigned>(_mm_movemask_pd(_mm_castsi128_pd(both)));
+	}
+	ADV_STORE_TARGET("sse2") static unsigned unordered(V) noexcept { return 0; }
+	ADV_STORE_TARGET("sse2") static V bias(V a) noexcept { return _mm_xor_si128(a, _mm_set1_epi64x(std::numeric_limits<int64_t>::min())); }
+	static V max(V a, V) noexcept { return a; } // Unused, k_ordered is false
+	static V min(V a, V) noexcept { return a; }
+};
+
+template <>
+struct Vec<SimdLevel::sse2, float>
+{
+	using V = __m128;
+	static constexpr size_t k_lanes = 4;
+	static constexpr bool k_ordered = true;
+	static constexpr bool k_compress = false;
+
+	ADV_STORE_TARGET("sse2") static V load(const void *p) noexcept { return _mm_loadu_ps(static_cast<const float *>(p)); }
+	ADV_STORE_TARGET("sse2") static void store(void *p, V v) noexcept { _mm_storeu_ps(static_cast<float *>(p), v); }
+	ADV_STORE_TARGET("sse2") static V set1(float x) noexcept { return _mm_set1_ps(x); }
+	ADV_STORE_TARGET("sse2") static V add(V a, V b) noexcept { return _mm_add_ps(a, b); }
+	ADV_STORE_TARGET("sse2") static unsigned eq(V a, V b) noexcept { return static_cast<unsigned>(_mm_movemask_ps(_mm_cmpeq_ps(a, b))); }
+	ADV_STORE_TARGET("sse2") static unsigned unordered(V a) noexcept { return static_cast<unsigned>(_mm_movemask_ps(_mm_cmpunord_ps(a, a))); }
+	ADV_STORE_TARGET("sse2") static unsigned lt(V a, V b) noexcept { return static_cast<unsigned>(_mm_movemask_ps(_mm_cmplt_ps(a, b))); }
+	ADV_STORE_TARGET("sse2") static unsigned le(V a, V b) noexcept { return static_cast<unsigned>(_mm_movemask_ps(_mm_cmple_ps(a, b))); }
+	ADV_STORE_TARGET("sse2") static V max(V a, V b) noexcept { return _mm_max_ps(a, b); }
+	ADV_STORE_TARGET("sse2") static V min(V a, V b) noexcept { return _mm_min_ps(a, b); }
+};
+
+template <>
+struct Vec<SimdLevel::sse2, double>
+{
+	using V = __m128d;
+	static constexpr size_t k_lanes = 2;
+	static constexpr bool k_ordered = true;
+	static constexpr bool k_compress = false;
+
+	ADV_STORE_TARGET("sse2") static V load(const void *p) noexcept { return _mm_loadu_pd(static_cast<const double *>(p)); }
+	ADV_STORE_TARGET("sse2") static void store(void *p, V v) noexcept { _mm_storeu_pd(static_cast<double *>(p), v); }
+	ADV_STORE_TARGET("sse2") static V set1(double x) noexcept { return _mm_set1_pd(x); }
+	ADV_STORE_TARGET("sse2") static V add(V a, V b) noexcept { return _mm_add_pd(a, b); }
+	ADV_STORE_TARGET("sse2") static unsigned eq(V a, V b) noexcept { return static_cast<unsigned>(_mm_movemask_pd(_mm_cmpeq_pd(a, b))); }
+	ADV_STORE_TARGET("sse2") static unsigned unordered(V a) noexcept { return static_cast<unsigned>(_mm_movemask_pd(_mm_cmpunord_pd(a, a))); }
+	ADV_STORE_TARGET("sse2") static unsigned lt(V a, V b) noexcept { return static_cast<unsigned>(_mm_movemask_pd(_mm_cmplt_pd(a, b))); }
+	ADV_STORE_TARGET("sse2") static unsigned le(V a, V b) noexcept { return static_cast<unsigned>(_mm_movemask_pd(_mm_cmple_pd(a, b))); }
+	ADV_STORE_TARGET("sse2") static V max(V a, V b) noexcept { return _mm_max_pd(a, b); }
+	ADV_STORE_TARGET("sse2") static V min(V a, V b) noexcept { return _mm_min_pd(a, b); }
+};
+
+template <>
+struct Vec<SimdLevel::avx2, int32_t>
+{
+	using V = __m256i;
+	static constexpr size_t k_lanes = 8;
+	static constexpr bool k_ordered = true;
+	static constexpr bool k_compress = true;
+
+	ADV_STORE_TARGET("avx2") static V load(const void *p) noexcept { return _mm256_loadu_si256(static_cast<const __m256i *>(p)); }
+	ADV_STORE_TARGET("avx2") static void store(void *p, V v) noexcept { _mm256_storeu_si256(static_cast<__m256i *>(p), v); }
+	ADV_STORE_TARGET("avx2") static V set1(int32_t x) noexcept { return _mm256_set1_epi32(x); }
+	ADV_STORE_TARGET("avx2") static V add(V a, V b) noexcept { return _mm256_add_epi32(a, b); }
+	ADV_STORE_TARGET("avx2") static unsigned eq(V a, V b) noexcept { return static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(a, b)))); }
+	ADV_STORE_TARGET("avx2") static unsigned unordered(V) noexcept { return 0; }
+	ADV_STORE_TARGET("avx2") static unsigned lt(V a, V b) noexcept { return static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(b, a)))); }
+	ADV_STORE_TARGET("avx2") static unsigned le(V a, V b) noexcept { return ~static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(a, b)))) & 0xff; }
+	ADV_STORE_TARGET("avx2") static V bias(V a) noexcept { return _mm256_xor_si256(a, _mm256_set1_epi32(std::numeric_limits<int32_t>::min())); }
+	ADV_STORE_TARGET("avx2") static V max(V a, V b) noexcept { return _mm256_max_epi32(a, b); }
+	ADV_STORE_TARGET("avx2") static V min(V a, V b) noexcept { return _mm256_min_epi32(a, b); }
+	ADV_STORE_TARGET("avx2") static void compress(V v, unsigned mask, void *out) noexcept
+	{
+		const V index = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(&k_compress_table.entries[mask])));
+		store(out, _mm256_permutevar8x32_epi32(v, index));
+	}
+};
+
+template <>
+struct Vec<SimdLevel::avx2, int64_t>
+{
+	using V = __m256i;
+	static constexpr size_t k_lanes = 4;
+	static constexpr bool k_ordered = true;
+	static constexpr bool k_compress = true;
+
+	ADV_STORE_TARGET("avx2") static V load(const void *p) noexcept { return _mm256_loadu_si256(static_cast<const __m256i *>(p)); }
+	ADV_STORE_TARGET("avx2") static void store(void *p, V v) noexcept { _mm256_storeu_si256(static_cast<__m256i *>(p), v); }
+	ADV_STORE_TARGET("avx2") static V set1(int64_t x) noexcept { return _mm256_set1_epi64x(x); }
+	ADV_STORE_TARGET("avx2") static V add(V a, V b) noexcept { return _mm256_add_epi64(a, b); }
+	ADV_STORE_TARGET("avx2") static unsigned eq(V a, V b) noexcept { return static_cast<unsigned>(_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(a, b)))); }
+	ADV_STORE_TARGET("avx2") static unsigned unordered(V) noexcept { return 0; }
+	ADV_STORE_TARGET("avx2") static unsigned lt(V a, V b) noexcept { return static_cast<unsigned>(_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(b, a)))); }
+	ADV_STORE_TARGET("avx2") static unsigned le(V a, V b) noexcept { return ~static_cast<unsigned>(_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(a, b)))) & 0xf; }
+	ADV_STORE_TARGET("avx2") static V bias(V a) noexcept { return _mm256_xor_si256(a, _mm256_set1_epi64x(std::numeric_limits<int64_t>::min())); }
+	ADV_STORE_TARGET("avx2") static V max(V a, V b) noexcept { return _mm256_blendv_epi8(b, a, _mm256_cmpgt_epi64(a, b)); }
+	ADV_STORE_TARGET("avx2") static V min(V a, V b) noexcept { return _mm256_blendv_epi8(a, b, _mm256_cmpgt_epi64(a, b)); }
+	ADV_STORE_TARGET("avx2") static void compress(V v, unsigned mask, void *out) noexcept
+	{
+		const V index = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(&k_compress_table.entries[k_pair_masks[mask]])));
+		store(out, _mm256_permutevar8x32_epi32(v, index));
+	}
+};
+
+template <>
+struct Vec<SimdLevel::avx2, float>
+{
+	using V = __m256;
+	static constexpr size_t k_lanes = 8;
+	static constexpr bool k_ordered = true;
+	static constexpr bool k_compress = true;
+
+	ADV_STORE_TARGET("avx2") static V load(const void *p) noexcept { return _mm256_loadu_ps(static_cast<const float *>(p)); }
+	ADV_STORE_TARGET("avx2") static void store(void *p, V v) noexcept { _mm256_storeu_ps(static_cast<float *>(p), v); }
+	ADV_STORE_TARGET("avx2") static V set1(float x) noexcept { return _mm256_set1_ps(x); }
+	ADV_STORE_TARGET("avx2") static V add(V a, V b) noexcept { return _mm256_add_ps(a, b); }
+	ADV_STORE_TARGET("avx2") static unsigned eq(V a, V b) noexcept { return static_cast<unsigned>(_mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_EQ_OQ))); }
+	ADV_STORE_TARGET("avx2") static unsigned unordered(V a) noexcept { return static_cast<unsigned>(_mm256_movemask_ps(_mm256_cmp_ps(a, a, _CMP_UNORD_Q))); }
+	ADV_STORE_TARGET("avx2") static unsigned lt(V a, V b) noexcept { return static_cast<unsigned>(_mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_LT_OQ))); }
+	ADV_STORE_TARGET("avx2") static unsigned le(V a, V b) noexcept { return static_cast<unsigned>(_mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_LE_OQ))); }
+	ADV_STORE_TARGET("avx2") static V max(V a, V b) noexcept { return _mm256_max_ps(a, b); }
+	ADV_STORE_TARGET("avx2") static V min(V a, V b) noexcept { return _mm256_min_ps(a, b); }
+	ADV_STORE_TARGET("avx2") static void compress(V v, unsigned mask, void *out) noexcept
+	{
+		const __m256i index = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(&k_compress_table.entries[mask])));
+		store(out, _mm256_permutevar8x32_ps(v, index));
+	}
+};
+
+template <>
+struct Vec<SimdLevel::avx2, double>
+{
+	using V = __m256d;
+	static constexpr size_t k_lanes = 4;
+	static constexpr bool k_ordered = true;
+	static constexpr bool k_compress = true;
+
+	ADV_STORE_TARGET("avx2") static V load(const void *p) noexcept { return _mm256_loadu_pd(static_cast<const double *>(p)); }
+	ADV_STORE_TARGET("avx2") static void store(void *p, V v) noexcept { _mm256_storeu_pd(static_cast<double *>(p), v); }
+	ADV_STORE_TARGET("avx2") static V set1(double x) noexcept { return _mm256_set1_pd(x); }
+	ADV_STORE_TARGET("avx2") static V add(V a, V b) noexcept { return _mm256_add_pd(a, b); }
+	ADV_STORE_TARGET("avx2") static unsigned eq(V a, V b) noexcept { return static_cast<unsigned>(_mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_EQ_OQ))); }
+	ADV_STORE_TARGET("avx2") static unsigned unordered(V a) noexcept { return static_cast<unsigned>(_mm256_movemask_pd(_mm256_cmp_pd(a, a, _CMP_UNORD_Q))); }
+	ADV_STORE_TARGET("avx2") static unsigned lt(V a, V b) noexcept { return static_cast<unsigned>(_mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_LT_OQ))); }
+	ADV_STORE_TARGET("avx2") static unsigned le(V a, V b) noexcept { return static_cast<unsigned>(_mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_LE_OQ))); }
+	ADV_STORE_TARGET("avx2") static V max(V a, V b) noexcept { return _mm256_max_pd(a, b); }
+	ADV_STORE_TARGET("avx2") static V min(V a, V b) noexcept { return _mm256_min_pd(a, b); }
+	ADV_STORE_TARGET("avx2") static void compress(V v, unsigned mask, void *out) noexcept
+	{
+		const __m256i index = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(&k_compress_table.entries[k_pair_masks[mask]])));
+		_mm256_storeu_si256(static_cast<__m256i *>(out), _mm256_permutevar8x32_epi32(_mm256_castpd_si256(v), index));
+	}
+};
+
+// The AVX-512 min/max use the zero-masked forms: identical instructions, but
+// GCC 12 warns about the undefined source operand of the unmasked ones.
+template <>
+struct Vec<SimdLevel::avx512, int32_t>
+{
+	using V = __m512i;
+	static constexpr size_t k_lanes = 16;
+	static constexpr bool k_ordered = true;
+	static constexpr bool k_compress = true;
+
+	ADV_STORE_TARGET("avx512f") static V load(const void *p) noexcept { return _mm512_loadu_si512(p); }
+	ADV_STORE_TARGET("avx512f") static void store(void *p, V v) noexcept { _mm512_storeu_si512(p, v); }
+	ADV_STORE_TARGET("avx512f") static V set1(int32_t x) noexcept { return _mm512_set1_epi32(x); }
+	ADV_STORE_TARGET("avx512f") static V add(V a, V b) noexcept { return _mm512_add_epi32(a, b); }
+	ADV_STORE_TARGET("avx512f") static unsigned eq(V a, V b) noexcept { return _mm512_cmpeq_epi32_mask(a, b); }
+	ADV_STORE_TARGET("avx512f") static unsigned unordered(V) noexcept { return 0; }
+	ADV_STORE_TARGET("avx512f") static unsigned lt(V a, V b) noexcept { return _mm512_cmplt_epi32_mask(a, b); }
+	ADV_STORE_TARGET("avx512f") static unsigned le(V a, V b) noexcept { return _mm512_cmple_epi32_mask(a, b); }
+	ADV_STORE_TARGET("avx512f") static V bias(V a) noexcept { return _mm512_xor_si512(a, _mm512_set1_epi32(std::numeric_limits<int32_t>::min())); }
+	ADV_STORE_TARGET("avx512f") static V max(V a, V b) noexcept { return _mm512_maskz_max_epi32(static_cast<__mmask16>(-1), a, b); }
+	ADV_STORE_TARGET("avx512f") static V min(V a, V b) noexcept { return _mm512_maskz_min_epi32(static_cast<__mmask16>(-1), a, b); }
+	ADV_STORE_TARGET("avx512f") static void compress(V v, unsigned mask, void *out) noexcept { store(out, _mm512_maskz_compress_epi32(static_cast<__mmask16>(mask), v)); }
+};
+
+template <>
+struct Vec<SimdLevel::avx512, int64_t>
+{
+	using V = __m512i;
+	static constexpr size_t k_lanes = 8;
+	static constexpr bool k_ordered = true;
+	static constexpr bool k_compress = true;
+
+	ADV_STORE_TARGET("avx512f") static V load(const void *p) noexcept { return _mm512_loadu_si512(p); }
+	ADV_STORE_TARGET("avx512f") static void store(void *p, V v) noexcept { _mm512_storeu_si512(p, v); }
+	ADV_STORE_TARGET("avx512f") static V set1(int64_t x) noexcept { return _mm512_set1_epi64(x); }
+	ADV_STORE_TARGET("avx512f") static V add(V a, V b) noexcept { return _mm512_add_epi64(a, b); }
+	ADV_STORE_TARGET("avx512f") static unsigned eq(V a, V b) noexcept { return _mm512_cmpeq_epi64_mask(a, b); }
+	ADV_STORE_TARGET("avx512f") static unsigned unordered(V) noexcept { return 0; }
+	ADV_STORE_TARGET("avx512f") static unsigned lt(V a, V b) noexcept { return _mm512_cmplt_epi64_mask(a, b); }
+	ADV_STORE_TARGET("avx512f") static unsigned le(V a, V b) noexcept { return _mm512_cmple_epi64_mask(a, b); }
+	ADV_STORE_TARGET("avx512f") static V bias(V a) noexcept { return _mm512_xor_si512(a, _mm512_set1_epi64(std::numeric_limits<int64_t>::min())); }
+	ADV_STORE_TARGET("avx512f") static V max(V a, V b) noexcept { return _mm512_maskz_max_epi64(static_cast<__mmask8>(-1), a, b); }
+	ADV_STORE_TARGET("avx512f") static V min(V a, V b) noexcept { return _mm512_maskz_min_epi64(static_cast<__mmask8>(-1), a, b); }
+	ADV_STORE_TARGET("avx512f") static void compress(V v, unsigned mask, void *out) noexcept { store(out, _mm512_maskz_compress_epi64(static_cast<__mmask8>(mask), v)); }
+};
+
+template <>
+struct Vec<SimdLevel::avx512, float>
+{
+	using V = __m512;
+	static constexpr size_t k_lanes = 16;
+	static constexpr bool k_ordered = true;
+	static constexpr bool k_compress = true;
+
+	ADV_STORE_TARGET("avx512f") static V load(const void *p) noexcept { return _mm512_loadu_ps(p); }
+	ADV_STORE_TARGET("avx512f") static void store(void *p, V v) noexcept { _mm512_storeu_ps(p, v); }
+	ADV_STORE_TARGET("avx512f") static V set1(float x) noexcept { return _mm512_set1_ps(x); }
+	ADV_STORE_TARGET("avx512f") static V add(V a, V b) noexcept { return _mm512_add_ps(a, b); }
+	ADV_STORE_TARGET("avx512f") static unsigned eq(V a, V b) noexcept { return _mm512_cmp_ps_mask(a, b, _CMP_EQ_OQ); }
+	ADV_STORE_TARGET("avx512f") static unsigned unordered(V a) noexcept { return _mm512_cmp_ps_mask(a, a, _CMP_UNORD_Q); }
+	ADV_STORE_TARGET("avx512f") static unsigned lt(V a, V b) noexcept { return _mm512_cmp_ps_mask(a, b, _CMP_LT_OQ); }
+	ADV_STORE_TARGET("avx512f") static unsigned le(V a, V b) noexcept { return _mm512_cmp_ps_mask(a, b, _CMP_LE_OQ); }
+	ADV_STORE_TARGET("avx512f") static V max(V a, V b) noexcept { return _mm512_maskz_max_ps(static_cast<__mmask16>(-1), a, b); }
+	ADV_STORE_TARGET("avx512f") static V min(V a, V b) noexcept { return _mm512_maskz_min_ps(static_cast<__mmask16>(-1), a, b); }
+	ADV_STORE_TARGET("avx512f") static void compress(V v, unsigned mask, void *out) noexcept { store(out, _mm512_maskz_compress_ps(static_cast<__mmask16>(mask), v)); }
+};
+
+template <>
+struct Vec<SimdLevel::avx512, double>
+{
+	using V = __m512d;
+	static constexpr size_t k_lanes = 8;
+	static constexpr bool k_ordered = true;
+	static constexpr bool k_compress = true;
+
+	ADV_STORE_TARGET("avx512f") static V load(const void *p) noexcept { return _mm512_loadu_pd(p); }
+	ADV_STORE_TARGET("avx512f") static void store(void *p, V v) noexcept { _mm512_storeu_pd(p, v); }
+	ADV_STORE_TARGET("avx512f") static V set1(double x) noexcept { return _mm512_set1_pd(x); }
+	ADV_STORE_TARGET("avx512f") static V add(V a, V b) noexcept { return _mm512_add_pd(a, b); }
+	ADV_STORE_TARGET("avx512f") static unsigned eq(V a, V b) noexcept { return _mm512_cmp_pd_mask(a, b, _CMP_EQ_OQ); }
+	ADV_STORE_TARGET("avx512f") static unsigned unordered(V a) noexcept { return _mm512_cmp_pd_mask(a, a, _CMP_UNORD_Q); }
+	ADV_STORE_TARGET("avx512f") static unsigned lt(V a, V b) noexcept { return _mm512_cmp_pd_mask(a, b, _CMP_LT_OQ); }
+	ADV_STORE_TARGET("avx512f") static unsigned le(V a, V b) noexcept { return _mm512_cmp_pd_mask(a, b, _CMP_LE_OQ); }
+	ADV_STORE_TARGET("avx512f") static V max(V a, V b) noexcept { return _mm512_maskz_max_pd(static_cast<__mmask8>(-1), a, b); }
+	ADV_STORE_TARGET("avx512f") static V min(V a, V b) noexcept { return _mm512_maskz_min_pd(static_cast<__mmask8>(-1), a, b); }
+	ADV_STORE_TARGET("avx512f") static void compress(V v, unsigned mask, void *out) noexcept { store(out, _mm512_maskz_compress_pd(static_cast<__mmask8>(mask), v)); }
+};
+
+// The kernel bodies are shared by all levels; the macro stamps them out once
+// per target because a target attribute cannot depend on a template argument.
+#define ADV_STORE_SIMD_KERNELS(level, isa)                                                              \
+	namespace level                                                                                     \
+	{                                                                                                   \
+	template <typename T>                                                                               \
+	using W = Vec<SimdLevel::level, lane_t<T>>;                                                         \
+                                                                                                        \
+	/* Bit j of masks[j / 64] is set when compare<Op>(x[j], a, b) */                                    \
+	template <CompareOp Op, typename T>                                                                 \
+	ADV_STORE_TARGET(isa) void compare_masks(const T *x, size_t n, T a, T b, uint64_t *masks) noexcept  \
+	{                                                                                                   \
+		if constexpr (Op != CompareOp::eq && Op != CompareOp::ne && !W<T>::k_ordered)                   \
+		{                                                                                               \
+			scalar::compare_masks<Op>(x, n, a, b, masks);                                               \
+		}                                                                                               \
+		else                                                                                            \
+		{                                                                                               \
+			constexpr unsigned all = (1u << W<T>::k_lanes) - 1;                                         \
+			auto va = W<T>::set1(static_cast<lane_t<T>>(a));                                            \
+			auto vb = W<T>::set1(static_cast<lane_t<T>>(b));                                            \
+			if constexpr (std::is_unsigned_v<T>)                                                        \
+			{                                                                                           \
+				va = W<T>::bias(va);                                                                    \
+				vb = W<T>::bias(vb);                                                                    \
+			}                                                                                           \
+			for (size_t base = 0; base < n; base += 64)                                                 \
+			{                                                                                           \
+				const size_t len = std::min<size_t>(64, n - base);                                      \
+				uint64_t word = 0;                                                                      \
+				size_t j = 0;                                                                           \
+				for (; j + W<T>::k_lanes <= len; j += W<T>::k_lanes)                                    \
+				{                                                                                       \
+					auto v = W<T>::load(x + base + j);                                                  \
+					if constexpr (std::is_unsigned_v<T>)                                                \
+					{                                                                                   \
+						v = W<T>::bias(v);                                                              \
+					}                                                                                   \
+					unsigned bits;                                                                      \
+					if constexpr (Op == CompareOp::eq)                                                  \
+					{                                                                                   \
+						bits = W<T>::eq(v, va);                                                         \
+					}                                                                                   \
+					else if constexpr (Op == CompareOp::ne)                                             \
+					{                                                                                   \
+						bits = ~W<T>::eq(v, va) & all;                                                  \
+					}                                                                                   \
+					else if constexpr (Op == CompareOp::lt)                                             \
+					{                                                                                   \
+						bits = W<T>::lt(v, va);                                                         \
+					}                                                                                   \
+					else if constexpr (Op == CompareOp::le)                                             \
+					{                                                                                   \
+						bits = W<T>::le(v, va);                                                         \
+					}                                                                                   \
+					else if constexpr (Op == CompareOp::gt)                                             \
+					{                                                                                   \
+						bits = W<T>::lt(va, v);                                                         \
+					}                                                                                   \
+					else if constexpr (Op == CompareOp::ge)                                             \
+					{                                                                                   \
+						bits = W<T>::le(va, v);                                                         \
+					}                                                                                   \
+					else                                                                                \
+					{                                                                                   \
+						bits = W<T>::le(va, v) & W<T>::le(v, vb);                                       \
+					}                                                                                   \
+					word |= static_cast<uint64_t>(bits) << j;                                           \
+				}                                                                                       \
+				for (; j < len; ++j)                                                                    \
+				{                                                                                       \
+					word |= static_cast<uint64_t>(compare<Op>(x[base + j], a, b)) << j;                 \
+				}                                                                                       \
+				masks[base / 64] = word;                                                                \
+			}                                                                                           \
+		}                                                                                               \
+	}                                                                                                   \
+	/* Largest (Max) or smallest element of n >= 16; false if a NaN was seen */                         \
+	template <bool Max, typename T>                                                                     \
+	ADV_STORE_TARGET(isa) bool extreme(const T *x, size_t n, T &out) noexcept                           \
+	{                                                                                                   \
+		if constexpr (!W<T>::k_ordered)                                                                 \
+		{                                                                                               \
+			return false;                                                                               \
+		}                                                                                               \
+		else                                                                                            \
+		{                                                                                               \
+			constexpr size_t lanes = W<T>::k_lanes;                                                     \
+			auto best = W<T>::load(x);                                                                  \
+			unsigned nan = W<T>::unordered(best);                                                       \
+			const size_t full = n - n % lanes;                                                          \
+			for (size_t i = lanes; i < full; i += lanes)                                                \
+			{                                                                                           \
+				const auto v = W<T>::load(x + i);                                                       \
+				nan |= W<T>::unordered(v);                                                              \
+				best = Max ? W<T>::max(best, v) : W<T>::min(best, v);                                   \
+			}                                                                                           \
+			lane_t<T> values[lanes];                                                                    \
+			W<T>::store(values, best);                                                                  \
+			T result = static_cast<T>(values[0]);                                                       \
+			for (size_t j = 1; j < lanes; ++j)                                                          \
+			{                                                                                           \
+				const T v = static_cast<T>(values[j]);                                                  \
+				result = (Max ? result < v : v < result) ? v : result;                                  \
+			}                                                                                           \
+			for (size_t i = full; i < n; ++i)                                                           \
+			{                                                                                           \
+				nan |= x[i] != x[i];                                                                    \
+				result = (Max ? result < x[i] : x[i] < result) ? x[i] : result;                         \
+			}                                                                                           \
+			out = result;                                                                               \
+			return nan == 0;                                                                            \
+		}                                                                                               \
+	}                                                                                                   \
+                                                                                                        \
+	template <typename T>                                                                               \
+	ADV_STORE_TARGET(isa) T sum(const T *x, size_t n) noexcept                                          \
+	{                                                                                                   \
+		constexpr size_t lanes = W<T>::k_lanes;                                                         \
+		constexpr size_t width = k_sum_width<T>;                                                        \
+		using V = typename W<T>::V;                                                                     \
+		V acc[width / lanes];                                                                           \
+		for (auto &a : acc)                                                                             \
+		{                                                                                               \
+			a = W<T>::set1(lane_t<T>());                                                                \
+		}                                                                                               \
+		size_t i = 0;                                                                                   \
+		for (; i + width <= n; i += width)                                                              \
+		{                                                                                               \
+			for (size_t r = 0; r < width / lanes; ++r)                                                  \
+			{                                                                                           \
+				acc[r] = W<T>::add(acc[r], W<T>::load(x + i + r * lanes));                              \
+			}                                                                                           \
+		}                                                                                               \
+		sum_t<T> partials[width];                                                                       \
+		for (size_t r = 0; r < width / lanes; ++r)                                                      \
+		{                                                                                               \
+			W<T>::store(partials + r * lanes, acc[r]);                                                  \
+		}                                                                                               \
+		return finish_sum(partials, x + i, n - i);                                                      \
+	}                                                                                                   \
+                                                                                                        \
+	/* Copy the elements whose mask bit is set to out, in order; out may be x */                        \
+	template <typename T>                                                                               \
+	ADV_STORE_TARGET(isa) size_t compress(const T *x, const uint64_t *masks, size_t n, T *out) noexcept \
+	{                                                                                                   \
+		if constexpr (!W<T>::k_compress)                                                                \
+		{                                                                                               \
+			return scalar::compress(x, masks, n, out);                                                  \
+		}                                                                                               \
+		else                                                                                            \
+		{                                                                                               \
+			constexpr size_t lanes = W<T>::k_lanes;                                                     \
+			constexpr uint64_t lane_mask = (uint64_t(1) << lanes) - 1;                                  \
+			size_t k = 0;                                                                               \
+			for (size_t base = 0; base < n; base += 64)                                                 \
+			{                                                                                           \
+				const size_t len = std::min<size_t>(64, n - base);                                      \
+				const uint64_t word = masks[base / 64];                                                 \
+				if (len == 64 && word == ~uint64_t(0))                                                  \
+				{                                                                                       \
+					if (out + k != x + base)                                                            \
+					{                                                                                   \
+						std::copy(x + base, x + base + 64, out + k);                                    \
+					}                                                                                   \
+					k += 64;                                                                            \
+					continue;                                                                           \
+				}                                                                                       \
+				size_t j = 0;                                                                           \
+				for (; j + lanes <= len; j += lanes)                                                    \
+				{                                                                                       \
+					const unsigned bits = static_cast<unsigned>((word >> j) & lane_mask);               \
+					W<T>::compress(W<T>::load(x + base + j), bits, out + k);                            \
+					k += popcount(bits);                                                                \
+				}                                                                                       \
+				for (; j < len; ++j)                                                                    \
+				{                                                                                       \
+					out[k] = x[base + j];                                                               \
+					k += (word >> j) & 1;                                                               \
+				}                                                                                       \
+			}                                                                                           \
+			return k;                                                                                   \
+		}                                                                                               \
+	}                                                                                                   \
+	}
+
+ADV_STORE_SIMD_KERNELS(sse2, "sse2")
+ADV_STORE_SIMD_KERNELS(avx2, "avx2")
+ADV_STORE_SIMD_KERNELS(avx512, "avx512f")
+#undef ADV_STORE_SIMD_KERNELS
+#endif // ADV_STORE_SIMD_X86
+
+/// @brief Comparison bitmask of x[0, n), one bit per element
+template <CompareOp Op, typename T>
+void compare_masks(const T *x, size_t n, T a, T b, uint64_t *masks) noexcept
+{
+	switch (simd_level())
+	{
+#ifdef ADV_STORE_SIMD_X86
+	case SimdLevel::avx512:
+		return avx512::compare_masks<Op>(x, n, a, b, masks);
+	case SimdLevel::avx2:
+		return avx2::compare_masks<Op>(x, n, a, b, masks);
+	case SimdLevel::sse2:
+		return sse2::compare_masks<Op>(x, n, a, b, masks);
+#endif
+	default:
+		return scalar::compare_masks<Op>(x, n, a, b, masks);
+	}
+}
+
+/// @brief Vector min/max of n >= 16 elements
+/// @return false at the scalar level or if a NaN was seen
+template <bool Max, typename T>
+bool extreme(const T *x, size_t n, T &out) noexcept
+{
+	switch (simd_level())
+	{
+#ifdef ADV_STORE_SIMD_X86
+	case SimdLevel::avx512:
+		return avx512::extreme<Max>(x, n, out);
+	case SimdLevel::avx2:
+		return avx2::extreme<Max>(x, n, out);
+	case SimdLevel::sse2:
+		return sse2::extreme<Max>(x, n, out);
+#endif
+	default:
+		(void)x;
+		(void)n;
+		(void)out;
+		return false;
+	}
+}
+
+/// @brief Sum of x[0, n), integers wrap on overflow
+template <typename T>
+T sum(const T *x, size_t n) noexcept
+{
+	switch (simd_level())
+	{
+#ifdef ADV_STORE_SIMD_X86
+	case SimdLevel::avx512:
+		return avx512::sum(x, n);
+	case SimdLevel::avx2:
+		return avx2::sum(x, n);
+	case SimdLevel::sse2:
+		return sse2::sum(x, n);
+#endif
+	default:
+		return scalar::sum(x, n);
+	}
+}
+
+/// @brief Copy the elements selected by masks to out, in order; out may be x
+/// @return Number of elements copied
+template <typename T>
+size_t compress(const T *x, const uint64_t *masks, size_t n, T *out) noexcept
+{
+	switch (simd_level())
+	{
+#ifdef ADV_STORE_SIMD_X86
+	case SimdLevel::avx512:
+		return avx512::compress(x, masks, n, out);
+	case SimdLevel::avx2:
+		return avx2::compress(x, masks, n, out);
+#endif
+	default:
+		return scalar::compress(x, masks, n, out);
+	}
+}
+
+/// @brief Position of the first element equal to value, n if none
+template <typename T>
+size_t find_equal(const T *x, size_t n, T value) noexcept
+{
+	if (simd_level() == SimdLevel::scalar)
+	{
+		return static_cast<size_t>(std::find(x, x + n, value) - x);
+	}
+	uint64_t masks[k_block_words];
+	for (size_t base = 0; base < n; base += k_block)
+	{
+		const size_t len = std::min(k_block, n - base);
+		compare_masks<CompareOp::eq>(x + base, len, value, value, masks);
+		for (size_t w = 0; w * 64 < len; ++w)
+		{
+			if (masks[w] != 0)
+			{
+				return base + w * 64 + lowest_bit(masks[w]);
+			}
+		}
+	}
+	return n;
+}
+
+/// @brief Number of elements equal to value
+template <typename T>
+size_t count_equal(const T *x, size_t n, T value) noexcept
+{
+	if (simd_level() == SimdLevel::scalar)
+	{
+		return static_cast<size_t>(std::count(x, x + n, value));
+	}
+	uint64_t masks[k_block_words];
+	size_t count = 0;
+	for (size_t base = 0; base < n; base += k_block)
+	{
+		const size_t len = std::min(k_block, n - base);
+		compare_masks<CompareOp::eq>(x + base, len, value, value, masks);
+		for (size_t w = 0; w * 64 < len; ++w)
+		{
+			count += popcount(masks[w]);
+		}
+	}
+	return count;
+}
+
+/// @brief Append the positions of elements equal to value
+template <typename T>
+void find_all_equal(const T *x, size_t n, T value, vector<size_t> &positions)
+{
+	if (simd_level() == SimdLevel::scalar)
+	{
+		for (size_t i = 0; i < n; ++i)
+		{
+			if (x[i] == value)
+			{
+				positions.push_back(i);
+			}
+		}
+		return;
+	}
+	uint64_t masks[k_block_words];
+	for (size_t base = 0; base < n; base += k_block)
+	{
+		const size_t len = std::min(k_block, n - base);
+		compare_masks<CompareOp::eq>(x + base, len, value, value, masks);
+		for (size_t w = 0; w * 64 < len; ++w)
+		{
+			for (uint64_t word = masks[w]; word != 0; word &= word - 1)
+			{
+				positions.push_back(base + w * 64 + lowest_bit(word));
+			}
+		}
+	}
+}
+
+/// @brief Position of the first largest (Max) or smallest element, n must be > 0
+/// @details Same result as std::max_element / std::min_element; a vector
+///          pass finds the value and a second one its first position.
+template <bool Max, typename T>
+size_t extreme_index(const T *x, size_t n) noexcept
+{
+	if constexpr (k_ordered<T>)
+	{
+		T value;
+		if (n >= 16 && extreme<Max>(x, n, value))
+		{
+			return find_equal(x, n, value);
+		}
+	}
+	// Track the value rather than an iterator: GCC turns max_element into a
+	// conditional move whose next compare has to reload through the pointer.
+	T best = x[0];
+	size_t pos = 0;
+	for (size_t i = 1; i < n; ++i)
+	{
+		if (Max ? best < x[i] : x[i] < best)
+		{
+			best = x[i];
+			pos = i;
+		}
+	}
+	return pos;
+}
+} // namespace simd
+} // namespace detail
+
+// =======================
+// Predicates
+// =======================
+// eq(), gt(), between(), in() and their && / || combinations are ordinary
+// callables, but filter(), count_if(), find_all_if(), erase_if() and any_of()
+// recognize them and test whole blocks with the compare kernels instead of
+// calling them once per element. Plain lambdas keep working everywhere.
+
+template <CompareOp Op, typename V>
+struct Comparison;
+
+template <typename V>
+struct OneOf;
+
+template <typename L, typename R>
+struct PredicateAnd;
+
+template <typename L, typename R>
+struct PredicateOr;
+
+namespace detail
+{
+/// @brief Check if a predicate type can produce block masks
+template <typename P>
+struct is_block_predicate : std::false_type
+{
+};
+
+template <CompareOp Op, typename V>
+struct is_block_predicate<Comparison<Op, V>> : std::true_type
+{
+};
+
+template <typename V>
+struct is_block_predicate<OneOf<V>> : std::true_type
+{
+};
+
+template <typename L, typename R>
+struct is_block_predicate<PredicateAnd<L, R>> : std::true_type
+{
+};
+
+template <typename L, typename R>
+struct is_block_predicate<PredicateOr<L, R>> : std::true_type
+{
+};
+
+/// @brief Check if every value of T is exactly representable in C
+template <typename T, typename C>
+constexpr bool embeds() noexcept
+{
+	if constexpr (std::is_same_v<T, C>)
+	{
+		return true;
+	}
+	else if constexpr (std::is_floating_point_v<C>)
+	{
+		return std::numeric_limits<T>::digits <= std::numeric_limits<C>::digits;
+	}
+	else
+	{
+		return std::is_integral_v<T> && std::numeric_limits<T>::digits <= std::numeric_limits<C>::digits &&
+			   (std::is_signed_v<C> || !std::is_signed_v<T>);
+	}
+}
+
+/// @brief Check if x OP bound can be computed in T once bound is converted to T
+/// @details True when the comparison already happens in T, or when it happens
+///          in a wider type C that holds every T exactly (then only bounds
+///          that are themselves exact T values convert, see exact_bound()).
+template <typename T, typename V>
+constexpr bool comparable_in() noexcept
+{
+	if constexpr (!std::is_arithmetic_v<T> || !std::is_arithmetic_v<V>)
+	{
+		return false;
+	}
+	else
+	{
+		return embeds<T, std::common_type_t<T, V>>();
+	}
+}
+
+/// @brief Convert a bound to T, requires comparable_in<T, V>()
+/// @return false if bound is not exactly a T value (out of range, fractional, NaN)
+template <typename T, typename V>
+bool exact_bound(const V &bound, T &out) noexcept
+{
+	using C = std::common_type_t<T, V>;
+	const C value = static_cast<C>(bound);
+	if constexpr (!std::is_same_v<C, T>)
+	{
+		if (!(value >= static_cast<C>(std::numeric_limits<T>::lowest()) &&
+			  value <= static_cast<C>(std::numeric_limits<T>::max())))
+		{
+			return false;
+		}
+	}
+	out = static_cast<T>(value);
+	return static_cast<C>(out) == value;
+}
+
+/// @brief Bitmask of pred over x[0, n) by calling it per element
+template <typename Pred, typename T>
+void scalar_masks(Pred &pred, const T *x, size_t n, uint64_t *masks)
+{
+	for (size_t base = 0; base < n; base += 64)
+	{
+		const size_t len = std::min<size_t>(64, n - base);
+		uint64_t word = 0;
+		for (size_t j = 0; j < len; ++j)
+		{
+			word |= static_cast<uint64_t>(static_cast<bool>(pred(x[base + j]))) << j;
+		}
+		masks[base / 64] = word;
+	}
+}
+
+/// @brief Bitmask of pred over x[0, n), n <= simd::k_block
+template <typename Pred, typename T>
+void predicate_masks(Pred &pred, const T *x, size_t n, uint64_t *masks)
+{
+	if constexpr (is_block_predicate<Pred>::value)
+	{
+		pred.masks(x, n, masks);
+	}
+	else
+	{
+		scalar_masks(pred, x, n, masks);
+	}
+}
+} // namespace detail
+
+/// @brief Predicate comparing an element with one bound (two for between)
+/// @tparam Op Comparison
+/// @tparam V Bound type
+template <CompareOp Op, typename V>
+struct Comparison
+{
+	V value;
+	V upper; // Used by between only
+
+	template <typename U>
+	bool operator()(const U &x) const
+	{
+		if constexpr (std::is_arithmetic_v<U> && std::is_arithmetic_v<V>)
+		{
+			using C = std::common_type_t<U, V>;
+			return detail::simd::compare<Op>(static_cast<C>(x), static_cast<C>(value), static_cast<C>(upper));
+		}
+		else
+		{
+			return detail::simd::compare<Op>(x, value, upper);
+		}
+	}
+
+	/// @brief Bitmask over x[0, n), n <= detail::simd::k_block
+	template <typename T>
+	void masks(const T *x, size_t n, uint64_t *out) const
+	{
+		if constexpr (detail::simd::k_vectorizable<T> && detail::comparable_in<T, V>())
+		{
+			T a{};
+			T b{};
+			if (detail::exact_bound(value, a) && (Op != CompareOp::between || detail::exact_bound(upper, b)))
+			{
+				detail::simd::compare_masks<Op>(x, n, a, b, out);
+				return;
+			}
+		}
+		detail::scalar_masks(*this, x, n, out);
+	}
+};
+
+/// @brief Predicate testing membership in a small set of values
+/// @details Costs one comparison pass per value, meant for a handful of
+///          values; use build_index() or a hash set for large sets.
+/// @tparam V Value type
+template <typename V>
+struct OneOf
+{
+	vector<V> values;
+
+	template <typename U>
+	bool operator()(const U &x) const
+	{
+		for (const auto &value : values)
+		{
+			if (Comparison<CompareOp::eq, V>{value, value}(x))
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	/// @brief Bitmask over x[0, n), n <= detail::simd::k_block
+	template <typename T>
+	void masks(const T *x, size_t n, uint64_t *out) const
+	{
+		if constexpr (detail::simd::k_vectorizable<T> && detail::comparable_in<T, V>())
+		{
+			const size_t words = (n + 63) / 64;
+			uint64_t hits[detail::simd::k_block_words];
+			std::fill(out, out + words, 0);
+			for (const auto &value : values)
+			{
+				T bound;
+				if (detail::exact_bound(value, bound)) // Otherwise no T equals it
+				{
+					detail::simd::compare_masks<CompareOp::eq>(x, n, bound, bound, hits);
+					for (size_t w = 0; w < words; ++w)
+					{
+						out[w] |= hits[w];
+					}
+				}
+			}
+		}
+		else
+		{
+			detail::scalar_masks(*this, x, n, out);
+		}
+	}
+};
+
+/// @brief Predicate true when both predicates are
+template <typename L, typename R>
+struct PredicateAnd
+{
+	L left;
+	R right;
+
+	template <typename U>
+	bool operator()(const U &x) const
+	{
+		return left(x) && right(x);
+	}
+
+	/// @brief Bitmask over x[0, n), n <= detail::simd::k_block
+	template <typename T>
+	void masks(const T *x, size_t n, uint64_t *out) const
+	{
+		uint64_t other[detail::simd::k_block_words];
+		left.masks(x, n, out);
+		right.masks(x, n, other);
+		for (size_t w = 0; w * 64 < n; ++w)
+		{
+			out[w] &= other[w];
+		}
+	}
+};
+
+/// @brief Predicate true when either predicate is
+template <typename L, typename R>
+struct PredicateOr
+{
+	L left;
+	R right;
+
+	template <typename U>
+	bool operator()(const U &x) const
+	{
+		return left(x) || right(x);
+	}
+
+	/// @brief Bitmask over x[0, n), n <= detail::simd::k_block
+	template <typename T>
+	void masks(const T *x, size_t n, uint64_t *out) const
+	{
+		uint64_t other[detail::simd::k_block_words];
+		left.masks(x, n, out);
+		right.masks(x, n, other);
+		for (size_t w = 0; w * 64 < n; ++w)
+		{
+			out[w] |= other[w];
+		}
+	}
+};
+
+/// @brief Predicate x == value
+template <typename V>
+Comparison<CompareOp::eq, V> eq(V value)
+{
+	return {std::move(value), V()};
+}
+
+/// @brief Predicate x != value
+template <typename V>
+Comparison<CompareOp::ne, V> ne(V value)
+{
+	return {std::move(value), V()};
+}
+
+/// @brief Predicate x < value
+template <typename V>
+Comparison<CompareOp::lt, V> lt(V value)
+{
+	return {std::move(value), V()};
+}
+
+/// @brief Predicate x <= value
+template <typename V>
+Comparison<CompareOp::le, V> le(V value)
+{
+	return {std::move(value), V()};
+}
+
+/// @brief Predicate x > value
+template <typename V>
+Comparison<CompareOp::gt, V> gt(V value)
+{
+	return {std::move(value), V()};
+}
+
+/// @brief Predicate x >= value
+template <typename V>
+Comparison<CompareOp::ge, V> ge(V value)
+{
+	return {std::move(value), V()};
+}
+
+/// @brief Predicate lo <= x && x <= hi (inclusive)
+template <typename V>
+Comparison<CompareOp::between, V> between(V lo, V hi)
+{
+	return {std::move(lo), std::move(hi)};
+}
+
+/// @brief Predicate x equal to one of values
+template <typename V>
+OneOf<V> in(initializer_list<V> values)
+{
+	return {vector<V>(values)};
+}
+
+/// @brief Predicate x equal to one of values
+template <typename V>
+OneOf<V> in(vector<V> values)
+{
+	return {std::move(values)};
+}
+
+/// @brief Combine predicate objects, both must hold
+template <typename L, typename R,
+		  typename = std::enable_if_t<detail::is_block_predicate<L>::value && detail::is_block_predicate<R>::value>>
+PredicateAnd<L, R> operator&&(L left, R right)
+{
+	return {std::move(left), std::move(right)};
+}
+
+/// @brief Combine predicate objects, either may hold
+template <typename L, typename R,
+		  typename = std::enable_if_t<detail::is_block_predicate<L>::value && detail::is_block_predicate<R>::value>>
+PredicateOr<L, R> operator||(L left, R right)
+{
+	return {std::move(left), std::move(right)};
+}
+
+// =======================
+// Sort Order
+// =======================
+
+/// @brief Order a Store is known to be sorted in
+enum class SortOrder : unsigned char
+{
+	unknown,
+	ascending,	// By operator<
+	descending	// By operator>
+};
+
+namespace detail
+{
+/// @brief Order produced by sorting with a comparator, unknown unless std::less/std::greater
+template <typename Compare, typename T>
+constexpr SortOrder order_of() noexcept
+{
+	if constexpr (std::is_same_v<Compare, std::less<T>> || std::is_same_v<Compare, std::less<>>)
+	{
+		return SortOrder::ascending;
+	}
+	else if constexpr (std::is_same_v<Compare, std::greater<T>> || std::is_same_v<Compare, std::greater<>>)
+	{
+		return SortOrder::descending;
+	}
+	else
+	{
+		return SortOrder::unknown;
+	}
+}
+} // namespace detail
+
+namespace detail
+{
+/// @brief Heap bytes owned by a value, 0 for types without owned storage
+template <typename U>
+size_t heap_bytes(const U &) noexcept
+{
+	return 0;
+}
+
+/// @brief Heap bytes owned by a string, 0 when stored inline (SSO)
+template <typename Char, typename Traits, typename Alloc>
+size_t heap_bytes(const std::basic_string<Char, Traits, Alloc> &value) noexcept
+{
+	const char *const object = reinterpret_cast<const char *>(&value);
+	const char *const text = reinterpret_cast<const char *>(value.data());
+	if (text >= object && text < object + sizeof(value))
+	{
+		return 0;
+	}
+	return (value.capacity() + 1) * sizeof(Char);
+}
+
+template <typename U, typename Alloc>
+size_t heap_bytes(const vector<U, Alloc> &value) noexcept;
+
+template <typename U, typename Alloc>
+size_t heap_bytes(const Store<U, Alloc> &value) noexcept;
+
+/// @brief Heap bytes owned by a vector, including its elements' storage
+template <typename U, typename Alloc>
+size_t heap_bytes(const vector<U, Alloc> &value) noexcept
+{
+	size_t bytes = value.capacity() * sizeof(U);
+	for (const auto &elem : value)
+	{
+		bytes += heap_bytes(elem);
+	}
+	return bytes;
+}
+} // namespace detail
+
+// =======================
+// Store Template Class
+// =======================
+template <typename T, typename Alloc = std::allocator<T>>
+class Store
+{
+  private:
+	vector<T, Alloc> m_data; // Internal storage
+	static Errors s_error;	 // Error management
+	CapacityPolicy m_policy; // Automatic growth/shrink rules
+	detail::Version m_version; // Bumped by every modifying member function
+	detail::ChangeLog m_changes; // Positions written by replace_at
+	detail::CacheSlot<detail::MembershipFilter> m_filter; // Optional, rebuilt lazily for contains()
+	detail::CacheSlot<detail::RangeTrees<T>> m_ranges; // Optional, rebuilt lazily for range queries
+	SortOrder m_sort_order = SortOrder::unknown; // Valid while m_version == m_sorted_at
+	uint64_t m_sorted_at = 0;
+#ifdef ADV_STORE_INSTRUMENTATION
+	mutable detail::StoreCounters m_stats; // Operation counters, relaxed atomics
+#endif
+
+  public:
+	using value_type = T;
+	using allocator_type = Alloc;
+	using size_type = size_t;
+	using reference = T &;
+	using const_reference = const T &;
+	using iterator = typename vector<T, Alloc>::iterator;
+	using const_iterator = typename vector<T, Alloc>::const_iterator;
+
+	// =======================
+	// Constructors & Destructor
+	// =======================
+
+	/// @brief Default constructor
+	Store() = default;
+
+	/// @brief Constructor with allocator
+	/// @param alloc Allocator (e.g. a TrackingAllocator)
+	explicit Store(const Alloc &alloc) : m_data(alloc) {}
+
+	/// @brief Constructor with size
+	/// @param size Initial size of the store
+	/// @param alloc Allocator (default-constructed if omitted)
+	explicit Store(size_t size, const Alloc &alloc = Alloc()) : m_data(size, alloc) {}
+
+	/// @brief Constructor with initializer list
+	/// @param list Initializer list of elements
+	/// @param alloc Allocator (default-constructed if omitted)
+	Store(initializer_list<T> list, const Alloc &alloc = Alloc()) : m_data(list, alloc) {}
+
+	/// @brief Constructor with iterator range
+	/// @tparam Iterator Iterator type
+	/// @param begin Start iterator
+	/// @param end End iterator
+	/// @param alloc Allocator (default-constructed if omitted)
+	template <typename Iterator>
+	Store(Iterator begin, Iterator end, const Alloc &alloc = Alloc()) : m_data(begin, end, alloc) {}
+
+	/// @brief Constructor with range
+	/// @tparam Range Range type (anything with begin() and end())
+	/// @param range Input range
+	/// @param alloc Allocator (default-constructed if omitted)
+	template <typename Range, typename = std::enable_if_t<detail::is_iterable<Range>::value>>
+	explicit Store(const Range &range, const Alloc &alloc = Alloc()) : m_data(range.begin(), range.end(), alloc) {}
+
+	/// @brief Move-append another store
+	/// @details When both stores are known to be sorted in the same order the
+	///          result is merged in O(n) and stays sorted.
+	/// @param other Other store to move from
+	/// @return Reference to this store
+	Store &operator+=(Store &&other)
+	{
+		const SortOrder order = sort_order();
+		const bool merge = order != SortOrder::unknown && other.sort_order() == order;
+		const size_t middle = m_data.size();
+		if (merge)
+		{
+			m_version.bump();
+		}
+		else
+		{
+			m_version.bump_local();
+		}
+		m_data.insert(m_data.end(),
+					  std::make_move_iterator(other.m_data.begin()),
+					  std::make_move_iterator(other.m_data.end()));
+		if (merge)
+		{
+			if (order == SortOrder::ascending)
+			{
+				std::inplace_merge(m_data.begin(), m_data.begin() + middle, m_data.end());
+			}
+			else
+			{
+				std::inplace_merge(m_data.begin(), m_data.begin() + middle, m_data.end(), std::greater<T>());
+			}
+			set_sort_order(order);
+		}
+		return *this;
+	}
+
+	// =======================
+	// Element Access
+	// =======================
+
+	/// @brief Access element with bounds checking
+	/// @param pos Position to access
+	/// @return Reference to element at position
+	/// @throws std::out_of_range if position is invalid
+	T &at(size_t pos)
+	{
+		if (pos >= m_data.size())
+		{
+			s_error.throw_out_of_range();
+		}
+		untracked_write();
+		return m_data[pos];
+	}
+
+	/// @brief Const access element with bounds checking
+	/// @param pos Position to access
+	/// @return Const reference to element at position
+	/// @throws std::out_of_range if position is invalid
+	const T &at(size_t pos) const
+	{
+		if (pos >= m_data.size())
+		{
+			s_error.throw_out_of_range();
+		}
+		return m_data[pos];
+	}
+
+	/// @brief Access element without bounds checking
+	/// @param pos Position to access
+	/// @return Reference to element at position
+	T &operator[](size_t pos) noexcept
+	{
+		untracked_write();
+		return m_data[pos];
+	}
+
+	/// @brief Const access element without bounds checking
+	/// @param pos Position to access
+	/// @return Const reference to element at position
+	const T &operator[](size_t pos) const noexcept
+	{
+		return m_data[pos];
+	}
+
+	/// @brief Get first element
+	/// @return Const reference to first element
+	/// @throws std::out_of_range if store is empty
+	const T &front() const
+	{
+		if (m_data.empty())
+		{
+			s_error.throw_out_of_range();
+		}
+		return m_data.front();
+	}
+
+	/// @brief Get middle element
+	/// @return Const reference to middle element
+	/// @throws std::out_of_range if store is empty
+	const T &mid() const
+	{
+		if (m_data.empty())
+		{
+			s_error.throw_out_of_range();
+		}
+		return m_data[m_data.size() / 2];
+	}
+
+	/// @brief Get last element
+	/// @return Const reference to last element
+	/// @throws std::out_of_range if store is empty
+	const T &back() const
+	{
+		if (m_data.empty())
+		{
+			s_error.throw_out_of_range();
+		}
+		return m_data.back();
+	}
+
+	/// @brief Get maximum element
+	/// @details Vectorized for 32/64-bit arithmetic types (see simd_level()).
+	/// @return Const reference to first maximum element
+	/// @throws std::out_of_range if store is empty
+	const T &max() const
+	{
+		if (m_data.empty())
+		{
+			s_error.throw_out_of_range();
+		}
+		if constexpr (detail::simd::k_vectorizable<T>)
+		{
+			return m_data[detail::simd::extreme_index<true>(m_data.data(), m_data.size())];
+		}
+		else
+		{
+			return *std::max_element(m_data.begin(), m_data.end());
+		}
+	}
+
+	/// @brief Get minimum element
+	/// @details Vectorized for 32/64-bit arithmetic types (see simd_level()).
+	/// @return Const reference to first minimum element
+	/// @throws std::out_of_range if store is empty
+	const T &min() const
+	{
+		if (m_data.empty())
+		{
+			s_error.throw_out_of_range();
+		}
+		if constexpr (detail::simd::k_vectorizable<T>)
+		{
+			return m_data[detail::simd::extreme_index<false>(m_data.data(), m_data.size())];
+		}
+		else
+		{
+			return *std::min_element(m_data.begin(), m_data.end());
+		}
+	}
+
+	/// @brief Get sum of all elements
+	/// @details Vectorized for 32/64-bit arithmetic types, where integers wrap
+	///          on overflow and floating point values are added in 64 bytes
+	///          worth of interleaved partial sums: the result is the same at
+	///          every SIMD level but may differ from a left-to-right sum in
+	///          the last bits.
+	/// @return Sum, T() if store is empty
+	T sum() const
+	{
+		if constexpr (detail::simd::k_vectorizable<T>)
+		{
+			return detail::simd::sum(m_data.data(), m_data.size());
+		}
+		else
+		{
+			return std::accumulate(m_data.begin(), m_data.end(), T());
+		}
+	}
+
+	/// @brief Get raw pointer to data
+	/// @return Pointer to underlying data array
+	T *data() noexcept
+	{
+		untracked_write();
+		return m_data.data();
+	}
+
+	/// @brief Get const raw pointer to data
+	/// @return Const pointer to underlying data array
+	const T *data() const noexcept
+	{
+		return m_data.data();
+	}
+
+	// =======================
+	// Capacity
+	// =======================
+
+	/// @brief Get current size
+	/// @return Number of elements in store
+	size_t size() const noexcept
+	{
+		return m_data.size();
+	}
+
+	/// @brief Check if store is empty
+	/// @return true if store is empty, false otherwise
+	bool empty() const noexcept
+	{
+		return m_data.empty();
+	}
+
+	/// @brief Get capacity
+	/// @return Current capacity of the store
+	size_t capacity() const noexcept
+	{
+		return m_data.capacity();
+	}
+
+	/// @brief Get memory held by the store
+	/// @details deep walks every element, it is O(n) for strings and nested Stores.
+	/// @return Payload, slack and deep (element-owned) heap bytes
+	MemoryUsage memory_usage() const noexcept
+	{
+		MemoryUsage usage;
+		usage.payload = m_data.size() * sizeof(T);
+		usage.slack = (m_data.capacity() - m_data.size()) * sizeof(T);
+		if constexpr (!std::is_trivially_copyable_v<T>)
+		{
+			for (const auto &elem : m_data)
+			{
+				usage.deep += detail::heap_bytes(elem);
+			}
+		}
+		return usage;
+	}
+
+	/// @brief Get allocator
+	/// @return Copy of the allocator
+	Alloc get_allocator() const noexcept
+	{
+		return m_data.get_allocator();
+	}
+
+	// =======================
+	// Instrumentation
+	// =======================
+
+	/// @brief Check if operation counters are compiled in
+	/// @return true if ADV_STORE_INSTRUMENTATION is defined
+	static constexpr bool instrumented() noexcept
+	{
+#ifdef ADV_STORE_INSTRUMENTATION
+		return true;
+#else
+		return false;
+#endif
+	}
+
+	/// @brief Get snapshot of operation counters
+	/// @return Copy of the counters (all zero when instrumentation is disabled)
+	StoreStats stats() const noexcept
+	{
+#ifdef ADV_STORE_INSTRUMENTATION
+		return m_stats.snapshot();
+#else
+		return StoreStats();
+#endif
+	}
+
+	/// @brief Reset operation counters
+	void reset_stats() noexcept
+	{
+#ifdef ADV_STORE_INSTRUMENTATION
+		m_stats.reset();
+#endif
+	}
+
+	/// @brief Print operation counters
+	/// @param os Output stream (default std::cout)
+	void dump_stats(ostream &os = cout) const
+	{
+		stats().dump(os);
+	}
+
+	// =======================
+	// Conversion Operators
+	// =======================
+
+	/// @brief Convert to vector
+	/// @return Vector containing store elements
+	operator vector<T>() const
+	{
+		return vector<T>(m_data.begin(), m_data.end());
+	}
+
+	// =======================
+	// Iterators
+	// =======================
+	// Mutable iterators count as a modification, see untracked_write()
+	auto begin() noexcept
+	{
+		untracked_write();
+		return m_data.begin();
+	}
+	auto end() noexcept
+	{
+		untracked_write();
+		return m_data.end();
+	}
+	auto begin() const noexcept { return m_data.begin(); }
+	auto end() const noexcept { return m_data.end(); }
+	auto cbegin() const noexcept { return m_data.cbegin(); }
+	auto cend() const noexcept { return m_data.cend(); }
+	auto rbegin() noexcept
+	{
+		untracked_write();
+		return m_data.rbegin();
+	}
+	auto rend() noexcept
+	{
+		untracked_write();
+		return m_data.rend();
+	}
+	auto rbegin() const noexcept { return m_data.rbegin(); }
+	auto rend() const noexcept { return m_data.rend(); }
+
+	// =======================
+	// Basic Operations
+	// =======================
+
+	/// @brief Reserve capacity
+	/// @param new_capacity New capacity to reserve
+	void reserve(size_t new_capacity)
+	{
+		m_data.reserve(new_capacity);
+	}
+
+	/// @brief Resize store
+	/// @param new_size New size of store
+	void resize(size_t new_size)
+	{
+		m_version.bump();
+		m_data.resize(new_size);
+	}
+
+	/// @brief Clear all elements
+	void clear() noexcept
+	{
+		m_version.bump();
+		m_data.clear();
+		shrink_if_sparse();
+	}
+
+	/// @brief Shrink capacity to fit size
+	void shrink_to_fit()
+	{
+		m_data.shrink_to_fit();
+	}
+
+	/// @brief Set automatic growth/shrink rules
+	/// @param policy New policy, applied from the next operation
+	/// @throws std::invalid_argument if the policy is invalid (see CapacityPolicy)
+	void set_capacity_policy(const CapacityPolicy &policy)
+	{
+		if (!policy.valid())
+		{
+			s_error.throw_invalid_argument();
+		}
+		m_policy = policy;
+	}
+
+	/// @brief Get automatic growth/shrink rules
+	/// @return Current policy
+	const CapacityPolicy &capacity_policy() const noexcept
+	{
+		return m_policy;
+	}
+
+	/// @brief Remove first element
+	/// @throws std::out_of_range if store is empty
+	void pop_front()
+	{
+		ADV_STORE_TIME(StoreOp::pop_front);
+		if (m_data.empty())
+		{
+			s_error.throw_out_of_range();
+		}
+		ADV_STORE_COUNT(StoreOp::pop_front, m_data.size() - 1, 0, 0);
+		m_version.bump();
+		m_data.erase(m_data.begin());
+		shrink_if_sparse();
+	}
+
+	/// @brief Remove last element
+	/// @throws std::out_of_range if store is empty
+	void pop_back()
+	{
+		if (m_data.empty())
+		{
+			s_error.throw_out_of_range();
+		}
+		m_version.bump();
+		m_data.pop_back();
+		shrink_if_sparse();
+	}
+
+	/// @brief Remove element at position
+	/// @param pos Position to remove
+	/// @throws std::out_of_range if position is invalid
+	void remove_at(size_t pos)
+	{
+		ADV_STORE_TIME(StoreOp::remove_at);
+		if (pos >= m_data.size())
+		{
+			s_error.throw_out_of_range();
+		}
+		ADV_STORE_COUNT(StoreOp::remove_at, m_data.size() - pos - 1, 0, 0);
+		m_version.bump();
+		m_data.erase(m_data.begin() + pos);
+		shrink_if_sparse();
+	}
+
+	/// @brief Remove all elements satisfying predicate
+	/// @details The remaining elements keep their order (and known sort
+	///          order). Predicate objects (gt(), between(), in(), ...) are
+	///          tested with vector compares and the survivors compacted in
+	///          place.
+	/// @tparam Pred Predicate type
+	/// @param pred Predicate function
+	/// @return Number of elements removed
+	template <typename Pred>
+	size_t erase_if(Pred pred)
+	{
+		const size_t before = m_data.size();
+		const SortOrder order = sort_order();
+		m_version.bump();
+		size_t kept = 0;
+		if constexpr (detail::is_block_predicate<Pred>::value && detail::simd::k_vectorizable<T>)
+		{
+			T *data = m_data.data();
+			uint64_t masks[detail::simd::k_block_words];
+			for (size_t base = 0; base < before; base += detail::simd::k_block)
+			{
+				const size_t len = std::min(detail::simd::k_block, before - base);
+				detail::predicate_masks(pred, data + base, len, masks);
+				for (size_t w = 0; w * 64 < len; ++w)
+				{
+					masks[w] = ~masks[w];
+				}
+				kept += detail::simd::compress(data + base, masks, len, data + kept);
+			}
+		}
+		else
+		{
+			kept = static_cast<size_t>(std::remove_if(m_data.begin(), m_data.end(), pred) - m_data.begin());
+		}
+		m_data.erase(m_data.begin() + kept, m_data.end());
+		set_sort_order(order);
+		shrink_if_sparse();
+		return before - kept;
+	}
+
+	/// @brief Insert element at position
+	/// @param pos Position to insert at
+	/// @param value Value to insert
+	/// @throws std::out_of_range if position is invalid
+	void insert(size_t pos, const T &value)
+	{
+		ADV_STORE_TIME(StoreOp::insert);
+		if (pos > m_data.size())
+		{
+			s_error.throw_out_of_range();
+		}
+		ADV_STORE_COUNT(StoreOp::insert, m_data.size() - pos, 0, 1);
+		place(pos, value);
+	}
+
+	/// @brief Replace element at position
+	/// @param pos Position to replace
+	/// @param value New value
+	/// @throws std::out_of_range if position is invalid
+	void replace_at(size_t pos, const T &value)
+	{
+		if (pos >= m_data.size())
+		{
+			s_error.throw_out_of_range();
+		}
+		if constexpr (detail::is_range_indexable<T>::value)
+		{
+			detail::RangeTrees<T> *const ranges = m_ranges.get();
+			if (ranges && ranges->current(m_version.value()))
+			{
+				const T old_value = m_data[pos];
+				write_at(pos, value);
+				ranges->set(pos, old_value, m_data[pos]);
+				ranges->stamp(m_version.value());
+				return;
+			}
+		}
+		write_at(pos, value);
+	}
+
+	/// @brief Replace all occurrences of a value
+	/// @param old_value Value to replace
+	/// @param new_value New value
+	void replace_all(const T &old_value, const T &new_value)
+	{
+		m_version.bump();
+		std::replace(m_data.begin(), m_data.end(), old_value, new_value);
+	}
+
+	/// @brief Fill store with value
+	/// @param value Value to fill with
+	void fill(const T &value)
+	{
+		detail::RangeTrees<T> *const ranges = m_ranges.get();
+		const bool sync = ranges && ranges->current(m_version.value());
+		m_version.bump();
+		std::fill(m_data.begin(), m_data.end(), value);
+		if constexpr (detail::is_range_indexable<T>::value)
+		{
+			if (sync)
+			{
+				ranges->fill(value);
+				ranges->stamp(m_version.value());
+			}
+		}
+	}
+
+	/// @brief Reverse elements in store
+	void reverse()
+	{
+		const SortOrder order = sort_order();
+		m_version.bump();
+		std::reverse(m_data.begin(), m_data.end());
+		if (order != SortOrder::unknown)
+		{
+			set_sort_order(order == SortOrder::ascending ? SortOrder::descending : SortOrder::ascending);
+		}
+	}
+
+	/// @brief Swap contents with another store
+	/// @param other Store to swap with
+	void swap(Store &other) noexcept
+	{
+		m_version.bump();
+		other.m_version.bump();
+		m_data.swap(other.m_data);
+	}
+
+	/// @brief Print store contents
+	/// @param new_line Whether to print newline at the end
+	void print(bool new_line = false) const
+	{
+		for (size_t i = 0; i < m_data.size(); ++i)
+		{
+			cout << m_data[i];
+			if (i < m_data.size() - 1)
+			{
+				cout << " ";
+			}
+		}
+		if (new_line)
+		{
+			cout << '\n';
+		}
+	}
+
+	// =======================
+	// Adding Elements
+	// =======================
+
+	/// @brief Add container to front
+	/// @tparam Container Container type
+	/// @param container Container to add
+	template <typename Container>
+	void push_front(const Container &container)
+	{
+		ADV_STORE_TIME(StoreOp::push_front);
+		ADV_STORE_COUNT(StoreOp::push_front, m_data.size(), 0, container.size());
+		grow_for(container.size(), false);
+		m_data.insert(m_data.begin(), container.begin(), container.end());
+	}
+
+	/// @brief Add initializer list to front
+	/// @param list Initializer list to add
+	void push_front(initializer_list<T> list)
+	{
+		ADV_STORE_TIME(StoreOp::push_front);
+		ADV_STORE_COUNT(StoreOp::push_front, m_data.size(), 0, list.size());
+		grow_for(list.size(), false);
+		m_data.insert(m_data.begin(), list.begin(), list.end());
+	}
+
+	/// @brief Add value to front
+	/// @param value Value to add
+	void push_front(const T &value)
+	{
+		ADV_STORE_TIME(StoreOp::push_front);
+		ADV_STORE_COUNT(StoreOp::push_front, m_data.size(), 0, 1);
+		place(0, value);
+	}
+
+	/// @brief Add moved value to front
+	/// @param value Value to move
+	void push_front(T &&value)
+	{
+		ADV_STORE_TIME(StoreOp::push_front);
+		ADV_STORE_COUNT(StoreOp::push_front, m_data.size(), 0, 1);
+		place(0, std::move(value));
+	}
+
+	/// @brief Add container to back
+	/// @tparam Container Container type
+	/// @param container Container to add
+	template <typename Container>
+	void push_back(const Container &container)
+	{
+		ADV_STORE_TIME(StoreOp::push_back);
+		ADV_STORE_COUNT(StoreOp::push_back, 0, 0, container.size());
+		grow_for(container.size(), true);
+		m_data.insert(m_data.end(), container.begin(), container.end());
+	}
+
+	/// @brief Add initializer list to back
+	/// @param list Initializer list to add
+	void push_back(initializer_list<T> list)
+	{
+		ADV_STORE_TIME(StoreOp::push_back);
+		ADV_STORE_COUNT(StoreOp::push_back, 0, 0, list.size());
+		grow_for(list.size(), true);
+		m_data.insert(m_data.end(), list.begin(), list.end());
+	}
+
+	/// @brief Add value to back
+	/// @param value Value to add
+	void push_back(const T &value)
+	{
+		ADV_STORE_TIME(StoreOp::push_back);
+		ADV_STORE_COUNT(StoreOp::push_back, 0, 0, 1);
+		place(m_data.size(), value);
+	}
+
+	/// @brief Add moved value to back
+	/// @param value Value to move
+	void push_back(T &&value)
+	{
+		ADV_STORE_TIME(StoreOp::push_back);
+		ADV_STORE_COUNT(StoreOp::push_back, 0, 0, 1);
+		place(m_data.size(), std::move(value));
+	}
+
+	/// @brief Emplace element at back
+	/// @tparam Args Argument types
+	/// @param args Arguments to construct element
+	template <typename... Args>
+	void emplace_back(Args &&... args)
+	{
+		ADV_STORE_TIME(StoreOp::push_back);
+		ADV_STORE_COUNT(StoreOp::push_back, 0, 0, 1);
+		place(m_data.size(), std::forward<Args>(args)...);
+	}
+
+	/// @brief Emplace element at front
+	/// @tparam Args Argument types
+	/// @param args Arguments to construct element
+	template <typename... Args>
+	void emplace_front(Args &&... args)
+	{
+		ADV_STORE_TIME(StoreOp::push_front);
+		ADV_STORE_COUNT(StoreOp::push_front, m_data.size(), 0, 1);
+		place(0, std::forward<Args>(args)...);
+	}
+
+	// =======================
+	// Search & Check
+	// =======================
+
+	/// @brief Check if store contains value
+	/// @param value Value to search for
+	/// @return true if value found, false otherwise
+	bool contains(const T &value) const
+	{
+		ADV_STORE_TIME(StoreOp::contains);
+		if (!maybe_present(value))
+		{
+			ADV_STORE_COUNT(StoreOp::contains, 0, 0, 0);
+			return false;
+		}
+		size_t pos;
+		if constexpr (detail::simd::k_vectorizable<T>)
+		{
+			pos = detail::simd::find_equal(m_data.data(), m_data.size(), value);
+		}
+		else
+		{
+			pos = static_cast<size_t>(std::find(m_data.begin(), m_data.end(), value) - m_data.begin());
+		}
+		ADV_STORE_COUNT(StoreOp::contains, 0, pos + (pos != m_data.size()), 0);
+		return pos != m_data.size();
+	}
+
+	/// @brief Count elements equal to value
+	/// @param value Value to count
+	/// @return Number of occurrences
+	size_t count(const T &value) const
+	{
+		if (!maybe_present(value))
+		{
+			return 0;
+		}
+		if constexpr (detail::simd::k_vectorizable<T>)
+		{
+			return detail::simd::count_equal(m_data.data(), m_data.size(), value);
+		}
+		else
+		{
+			return static_cast<size_t>(std::count(m_data.begin(), m_data.end(), value));
+		}
+	}
+
+	/// @brief Check if any element satisfies predicate
+	/// @tparam Pred Predicate type
+	/// @param pred Predicate function
+	/// @return true if any element satisfies predicate
+	template <typename Pred>
+	bool any_of(Pred pred) const
+	{
+		if constexpr (detail::is_block_predicate<Pred>::value && detail::simd::k_vectorizable<T>)
+		{
+			uint64_t masks[detail::simd::k_block_words];
+			for (size_t base = 0; base < m_data.size(); base += detail::simd::k_block)
+			{
+				const size_t len = std::min(detail::simd::k_block, m_data.size() - base);
+				detail::predicate_masks(pred, m_data.data() + base, len, masks);
+				for (size_t w = 0; w * 64 < len; ++w)
+				{
+					if (masks[w] != 0)
+					{
+						return true;
+					}
+				}
+			}
+			return false;
+		}
+		else
+		{
+			return std::any_of(m_data.begin(), m_data.end(), pred);
+		}
+	}
+
+	/// @brief Check if any element equals value
+	/// @param value Value to compare
+	/// @return true if any element equals value
+	bool any_of(const T &value) const
+	{
+		return std::any_of(m_data.begin(), m_data.end(),
+						   [&](const T &elem) { return elem == value; });
+	}
+
+	/// @brief Check if all elements satisfy predicate
+	/// @tparam Pred Predicate type
+	/// @param pred Predicate function
+	/// @return true if all elements satisfy predicate
+	template <typename Pred>
+	bool all_of(Pred pred) const
+	{
+		return std::all_of(m_data.begin(), m_data.end(), pred);
+	}
+
+	/// @brief Check if all elements equal value
+	/// @param value Value to compare
+	/// @return true if all elements equal value
+	bool all_of(const T &value) const
+	{
+		return std::all_of(m_data.begin(), m_data.end(),
+						   [&](const T &elem) { return elem == value; });
+	}
+
+	/// @brief Check if no elements satisfy predicate
+	/// @tparam Pred Predicate type
+	/// @param pred Predicate function
+	/// @return true if no elements satisfy predicate
+	template <typename Pred>
+	bool none_of(Pred pred) const
+	{
+		return std::none_of(m_data.begin(), m_data.end(), pred);
+	}
+
+	/// @brief Check if no elements equal value
+	/// @param value Value to compare
+	/// @return true if no elements equal value
+	bool none_of(const T &value) const
+	{
+		return std::none_of(m_data.begin(), m_data.end(),
+							[&](const T &elem) { return elem == value; });
+	}
+
+	/// @brief Find all positions of value
+	/// @param value Value to find
+	/// @return Vector of positions where value appears
+	vector<size_t> find_all(const T &value) const
+	{
+		ADV_STORE_TIME(StoreOp::find_all);
+		vector<size_t> positions;
+		if (!maybe_present(value))
+		{
+			ADV_STORE_COUNT(StoreOp::find_all, 0, 0, 0);
+			return positions;
+		}
+		ADV_STORE_COUNT(StoreOp::find_all, 0, m_data.size(), 0);
+		if constexpr (detail::simd::k_vectorizable<T>)
+		{
+			detail::simd::find_all_equal(m_data.data(), m_data.size(), value, positions);
+		}
+		else
+		{
+			for (size_t i = 0; i < m_data.size(); ++i)
+			{
+				if (m_data[i] == value)
+				{
+					positions.push_back(i);
+				}
+			}
+		}
+		return positions;
+	}
+
+	/// @brief Find all positions satisfying predicate
+	/// @tparam Pred Predicate type
+	/// @param pred Predicate function
+	/// @return Vector of positions satisfying predicate
+	template <typename Pred>
+	vector<size_t> find_all_if(Pred pred) const
+	{
+		ADV_STORE_TIME(StoreOp::find_all);
+		ADV_STORE_COUNT(StoreOp::find_all, 0, m_data.size(), 0);
+		vector<size_t> positions;
+		if constexpr (detail::is_block_predicate<Pred>::value && detail::simd::k_vectorizable<T>)
+		{
+			uint64_t masks[detail::simd::k_block_words];
+			for (size_t base = 0; base < m_data.size(); base += detail::simd::k_block)
+			{
+				const size_t len = std::min(detail::simd::k_block, m_data.size() - base);
+				detail::predicate_masks(pred, m_data.data() + base, len, masks);
+				for (size_t w = 0; w * 64 < len; ++w)
+				{
+					for (uint64_t word = masks[w]; word != 0; word &= word - 1)
+					{
+						positions.push_back(base + w * 64 + detail::lowest_bit(word));
+					}
+				}
+			}
+		}
+		else
+		{
+			for (size_t i = 0; i < m_data.size(); ++i)
+			{
+				if (pred(m_data[i]))
+				{
+					positions.push_back(i);
+				}
+			}
+		}
+		return positions;
+	}
+
+	/// @brief Count elements satisfying predicate
+	/// @details Predicate objects (gt(), between(), in(), ...) are tested a
+	///          block at a time with vector compares.
+	/// @tparam Pred Predicate type
+	/// @param pred Predicate function
+	/// @return Number of elements satisfying predicate
+	template <typename Pred>
+	size_t count_if(Pred pred) const
+	{
+		if constexpr (detail::is_block_predicate<Pred>::value && detail::simd::k_vectorizable<T>)
+		{
+			uint64_t masks[detail::simd::k_block_words];
+			size_t count = 0;
+			for (size_t base = 0; base < m_data.size(); base += detail::simd::k_block)
+			{
+				const size_t len = std::min(detail::simd::k_block, m_data.size() - base);
+				detail::predicate_masks(pred, m_data.data() + base, len, masks);
+				for (size_t w = 0; w * 64 < len; ++w)
+				{
+					count += detail::popcount(masks[w]);
+				}
+			}
+			return count;
+		}
+		else
+		{
+			return static_cast<size_t>(std::count_if(m_data.begin(), m_data.end(), pred));
+		}
+	}
+
+	// =======================
+	// Indexing
+	// =======================
+
+	/// @brief Get modification counter
+	/// @details Changes whenever a member function modifies the contents, and
+	///          whenever mutable at(), operator[], data(), begin()/end() or
+	///          rbegin()/rend() hand out write access, since writes through
+	///          what they return cannot be seen. The sort order and every
+	///          cache keyed on the version (membership filter, range index,
+	///          build_index, freeze_rmq, freeze_search, live_filter) follow
+	///          this one rule. A reference, pointer or iterator kept across a
+	///          later lookup must not be written through without calling
+	///          mark_modified(); read through cbegin() or a const reference to
+	///          keep the caches.
+	/// @return Current version
+	uint64_t version() const noexcept
+	{
+		return m_version.value();
+	}
+
+	/// @brief Report a write made through a reference, pointer or iterator
+	void mark_modified() noexcept
+	{
+		m_version.bump();
+	}
+
+	/// @brief Attach a Bloom filter consulted by contains() and find_all(value)
+	/// @details Misses then cost one cache line instead of a scan. The filter
+	///          is rebuilt (O(n)) by the first lookup after a modification, so
+	///          it pays off for stores queried much more often than changed.
+	///          Concurrent const lookups are safe, the rebuild is serialized.
+	///          Mutable element access counts as a modification (see
+	///          version()). The filter is allocated here, a store without one
+	///          carries only a null pointer.
+	/// @param bits_per_key Filter size per element (10 gives about 1% false positives)
+	/// @throws std::invalid_argument if bits_per_key is zero
+	void enable_membership_filter(size_t bits_per_key = 10)
+	{
+		static_assert(detail::is_hashable<T>::value, "membership filter requires std::hash<T>");
+		if (bits_per_key == 0)
+		{
+			s_error.throw_invalid_argument();
+		}
+		m_filter.emplace(bits_per_key);
+	}
+
+	/// @brief Detach the membership filter and free its memory
+	void disable_membership_filter() noexcept
+	{
+		m_filter.reset();
+	}
+
+	/// @brief Check if a membership filter is attached
+	/// @return true if enabled
+	bool membership_filter_enabled() const noexcept
+	{
+		return static_cast<bool>(m_filter);
+	}
+
+	/// @brief Build a hash index from key to positions
+	/// @details The index rebuilds itself on the next lookup after the store
+	///          changed (see version()). It keeps a pointer to this store and
+	///          must not outlive it.
+	/// @tparam KeyFn Key function type
+	/// @param key_fn Function computing the key of an element (default: the element)
+	/// @return Index over this store
+	template <typename KeyFn = IdentityKey>
+	StoreIndex<T, Alloc, KeyFn> build_index(KeyFn key_fn = KeyFn()) const
+	{
+		return StoreIndex<T, Alloc, KeyFn>(*this, std::move(key_fn));
+	}
+
+	/// @brief Build an O(1) range-min/max structure over the current contents
+	/// @details Meant for stores that no longer change: the structure rebuilds
+	///          itself (O(n)) on the next query after a modification. It
+	///          keeps a pointer to this store and must not outlive it.
+	/// @return Range-min/max query structure over this store
+	StoreRmq<T, Alloc> freeze_rmq() const
+	{
+		return StoreRmq<T, Alloc>(*this);
+	}
+
+	/// @brief Build a cache-friendly search layout over the sorted contents
+	/// @details Meant for sorted stores that no longer change: the layout
+	///          rebuilds itself (O(n)) on the next query after a
+	///          modification. It keeps a pointer to this store and must not
+	///          outlive it.
+	/// @return Search structure over this store
+	/// @throws std::invalid_argument if the store is not sorted ascending
+	StoreSearch<T, Alloc> freeze_search() const
+	{
+		return StoreSearch<T, Alloc>(*this);
+	}
+
+	/// @brief Copy into an immutable store with O(1) lookups
+	/// @details Storage is sized exactly; a minimal perfect hash maps each
+	///          distinct element to its first position. Requires std::hash<T>.
+	/// @return Frozen copy of this store
+	FrozenStore<T> freeze() const &
+	{
+		return FrozenStore<T>(m_data.begin(), m_data.end());
+	}
+
+	/// @brief Move into an immutable store with O(1) lookups
+	/// @details The elements are moved, this store is left empty.
+	/// @return Frozen store holding this store's elements
+	FrozenStore<T> freeze() &&
+	{
+		m_version.bump();
+		FrozenStore<T> frozen(std::make_move_iterator(m_data.begin()), std::make_move_iterator(m_data.end()));
+		m_data.clear();
+		return frozen;
+	}
+
+	/// @brief Attach a range index for range_sum, range_min and range_max
+	/// @details Keeps a Fenwick tree (sums, arithmetic T only) and min/max
+	///          segment trees, about 3n extra elements. replace_at() and
+	///          fill() update them in place; any other modification makes the
+	///          next range query rebuild them in O(n). Concurrent const range
+	///          queries are safe, the rebuild is serialized. Mutable element
+	///          access counts as a modification (see version()). The trees
+	///          are allocated here, a store without them carries only a null
+	///          pointer; enabling twice keeps the existing trees.
+	void enable_range_index()
+	{
+		static_assert(detail::is_range_indexable<T>::value, "range index requires operator< and a non-bool type");
+		if (!m_ranges)
+		{
+			m_ranges.emplace();
+		}
+	}
+
+	/// @brief Detach the range index and free its memory
+	void disable_range_index() noexcept
+	{
+		m_ranges.reset();
+	}
+
+	/// @brief Check if a range index is attached
+	/// @return true if enabled
+	bool range_index_enabled() const noexcept
+	{
+		return static_cast<bool>(m_ranges);
+	}
+
+	/// @brief Sum of the elements in [first, last)
+	/// @details O(log n) with the range index, O(last - first) without.
+	/// @param first Start position
+	/// @param last End position (exclusive)
+	/// @return Sum, T() for an empty range
+	/// @throws std::out_of_range if first > last or last > size
+	T range_sum(size_t first, size_t last) const
+	{
+		static_assert(std::is_arithmetic_v<T> && !std::is_same_v<T, bool>,
+					  "range_sum requires an arithmetic element type");
+		check_range(first, last, false);
+		if (m_ranges)
+		{
+			return current_ranges().sum(first, last);
+		}
+		return std::accumulate(m_data.begin() + first, m_data.begin() + last, T());
+	}
+
+	/// @brief Minimum of the elements in [first, last)
+	/// @details O(log n) with the range index, O(last - first) without.
+	/// @param first Start position
+	/// @param last End position (exclusive)
+	/// @return Const reference to a smallest element
+	/// @throws std::out_of_range if the range is empty or exceeds the store
+	const T &range_min(size_t first, size_t last) const
+	{
+		static_assert(detail::is_range_indexable<T>::value, "range_min requires operator< and a non-bool type");
+		check_range(first, last, true);
+		if (m_ranges)
+		{
+			return current_ranges().min(first, last);
+		}
+		return *std::min_element(m_data.begin() + first, m_data.begin() + last);
+	}
+
+	/// @brief Maximum of the elements in [first, last)
+	/// @details O(log n) with the range index, O(last - first) without.
+	/// @param first Start position
+	/// @param last End position (exclusive)
+	/// @return Const reference to a largest element
+	/// @throws std::out_of_range if the range is empty or exceeds the store
+	const T &range_max(size_t first, size_t last) const
+	{
+		static_assert(detail::is_range_indexable<T>::value, "range_max requires operator< and a non-bool type");
+		check_range(first, last, true);
+		if (m_ranges)
+		{
+			return current_ranges().max(first, last);
+		}
+		return *std::max_element(m_data.begin() + first, m_data.begin() + last);
+	}
+
+	// =======================
+	// Transformation & Filtering
+	// =======================
+
+	/// @brief Transform elements in-place
+	/// @tparam Func Function type
+	/// @param func Transformation function
+	template <typename Func>
+	void transform(Func func)
+	{
+		m_version.bump();
+		std::transform(m_data.begin(), m_data.end(), m_data.begin(), func);
+	}
+
+	/// @brief Filter elements based on predicate
+	/// @details For 32/64-bit arithmetic types pred fills a bitmask per block
+	///          and a vector kernel compacts the selected elements, so there
+	///          is no branch per element. Predicate objects (gt(), between(),
+	///          in(), ...) fill the bitmask with vector compares.
+	/// @tparam Pred Predicate type
+	/// @param pred Predicate function
+	/// @return New store with filtered elements
+	template <typename Pred>
+	Store filter(Pred pred) const
+	{
+		ADV_STORE_TIME(StoreOp::filter);
+		ADV_STORE_COUNT(StoreOp::filter, 0, m_data.size(), 0);
+		Store result(m_data.get_allocator());
+		if constexpr (detail::simd::k_vectorizable<T>)
+		{
+			const size_t n = m_data.size();
+			const T *src = m_data.data();
+			size_t kept = 0;
+			uint64_t masks[detail::simd::k_block_words];
+			for (size_t base = 0; base < n; base += detail::simd::k_block)
+			{
+				const size_t len = std::min(detail::simd::k_block, n - base);
+				detail::predicate_masks(pred, src + base, len, masks);
+				// The kernel may fill the whole block, grow geometrically for that room
+				if (kept + len > result.m_data.capacity())
+				{
+					result.m_data.reserve(std::min(n, std::max(kept + len, 2 * result.m_data.capacity())));
+				}
+				result.m_data.resize(kept + len);
+				kept += detail::simd::compress(src + base, masks, len, result.m_data.data() + kept);
+			}
+			result.m_data.resize(kept);
+			if (result.m_data.capacity() / 2 > kept)
+			{
+				result.m_data.shrink_to_fit(); // Mostly rejected, the last block's room is waste
+			}
+		}
+		else
+		{
+			for (const auto &elem : m_data)
+			{
+				if (pred(elem))
+				{
+					result.push_back(elem);
+				}
+			}
+		}
+		return result;
+	}
+
+	/// @brief Create a filter view kept up to date incrementally
+	/// @details On access the view evaluates pred only on elements appended
+	///          or written with replace_at() since its last refresh (up to 64
+	///          writes); any other modification makes it rescan the store.
+	///          It keeps a pointer to this store and must not outlive it.
+	/// @tparam Pred Predicate type
+	/// @param pred Predicate function
+	/// @return View over the elements satisfying pred
+	template <typename Pred>
+	LiveFilter<T, Alloc, Pred> live_filter(Pred pred) const
+	{
+		return LiveFilter<T, Alloc, Pred>(*this, std::move(pred));
+	}
+
+	// =======================
+	// Sorting
+	// =======================
+
+	/// @brief Sort elements
+	/// @param ascending Whether to sort in ascending order (default true)
+	void sort(bool ascending = true)
+	{
+		ADV_STORE_TIME(StoreOp::sort);
+		ADV_STORE_COUNT(StoreOp::sort, 0, 0, 0);
+		m_version.bump();
+		if (ascending)
+		{
+			std::sort(m_data.begin(), m_data.end());
+		}
+		else
+		{
+			std::sort(m_data.begin(), m_data.end(), std::greater<T>());
+		}
+		set_sort_order(ascending ? SortOrder::ascending : SortOrder::descending);
+	}
+
+	/// @brief Sort with custom comparator
+	/// @tparam Compare Comparator type
+	/// @param comp Comparator function
 	template <typename Compare>
 	void sort(Compare comp)
 	{
-		std::sort(m_data.begin(), m_data.end(), comp);
+		ADV_STORE_TIME(StoreOp::sort);
+		ADV_STORE_COUNT(StoreOp::sort, 0, 0, 0);
+		m_version.bump();
+		std::sort(m_data.begin(), m_data.end(), comp);
+		set_sort_order(detail::order_of<Compare, T>());
+	}
+
+	/// @brief Remove duplicate elements
+	/// @param auto_sort Whether to sort before removing duplicates
+	void unique(bool auto_sort = true)
+	{
+		ADV_STORE_TIME(StoreOp::unique);
+		ADV_STORE_COUNT(StoreOp::unique, 0, m_data.size(), 0);
+		const SortOrder order = auto_sort ? SortOrder::ascending : sort_order();
+		m_version.bump();
+		if (auto_sort)
+		{
+			sort();
+		}
+		auto it = std::unique(m_data.begin(), m_data.end());
+		m_data.erase(it, m_data.end());
+		set_sort_order(order);
+	}
+
+	/// @brief Get the order the store is known to be sorted in
+	/// @details Set by sort(), unique(), merges and mark_sorted(); any other
+	///          modification, mutable element access included (see
+	///          version()), resets it to unknown.
+	/// @return Known sort order
+	SortOrder sort_order() const noexcept
+	{
+		return m_sorted_at == m_version.value() ? m_sort_order : SortOrder::unknown;
+	}
+
+	/// @brief Record that the contents are sorted (e.g. loaded pre-sorted)
+	/// @param ascending Whether sorted ascending (default true) or descending
+	/// @throws std::invalid_argument if the contents are not sorted that way
+	void mark_sorted(bool ascending = true)
+	{
+		const bool sorted = ascending ? std::is_sorted(m_data.begin(), m_data.end())
+									  : std::is_sorted(m_data.begin(), m_data.end(), std::greater<T>());
+		if (!sorted)
+		{
+			s_error.throw_invalid_argument();
+		}
+		set_sort_order(ascending ? SortOrder::ascending : SortOrder::descending);
+	}
+
+	// =======================
+	// Type Conversion
+	// =======================
+
+	/// @brief Convert to store of integers
+	/// @tparam U Original type (deduced)
+	/// @return New store with integer values
+	template <typename U = T>
+	Store<int> to_int() const
+	{
+		ADV_STORE_TIME(StoreOp::to_int);
+		ADV_STORE_COUNT(StoreOp::to_int, 0, m_data.size(), 0);
+		static_assert(std::is_arithmetic_v<U> || std::is_same_v<U, string>,
+					  "Type must be arithmetic or string for conversion to int");
+
+		if (m_data.empty())
+		{
+			s_error.throw_runtime_error();
+		}
+
+		Store<int> result;
+		for (const auto &val : m_data)
+		{
+			if constexpr (std::is_same_v<U, string>)
+			{
+				try
+				{
+					result.push_back(std::stoi(val));
+				}
+				catch (...)
+				{
+					result.push_back(0);
+				}
+			}
+			else
+			{
+				result.push_back(static_cast<int>(val));
+			}
+		}
+		return result;
+	}
+
+	/// @brief Convert to store of doubles
+	/// @tparam U Original type (deduced)
+	/// @return New store with double values
+	template <typename U = T>
+	Store<double> to_double() const
+	{
+		ADV_STORE_TIME(StoreOp::to_double);
+		ADV_STORE_COUNT(StoreOp::to_double, 0, m_data.size(), 0);
+		static_assert(std::is_arithmetic_v<U> || std::is_same_v<U, string>,
+					  "Type must be arithmetic or string for conversion to double");
+
+		if (m_data.empty())
+		{
+			s_error.throw_runtime_error();
+		}
+
+		Store<double> result;
+		for (const auto &val : m_data)
+		{
+			if constexpr (std::is_same_v<U, string>)
+			{
+				try
+				{
+					result.push_back(std::stod(val));
+				}
+				catch (...)
+				{
+					result.push_back(0.0);
+				}
+			}
+			else
+			{
+				result.push_back(static_cast<double>(val));
+			}
+		}
+		return result;
+	}
+
+	/// @brief Convert to store of characters
+	/// @tparam U Original type (deduced)
+	/// @return New store with character values
+	template <typename U = T>
+	Store<char> to_char() const
+	{
+		ADV_STORE_TIME(StoreOp::to_char);
+		ADV_STORE_COUNT(StoreOp::to_char, 0, m_data.size(), 0);
+		static_assert(std::is_arithmetic_v<U> || std::is_same_v<U, string>,
+					  "Type must be arithmetic or string for conversion to char");
+
+		if (m_data.empty())
+		{
+			s_error.throw_runtime_error();
+		}
+
+		Store<char> result;
+		for (const auto &val : m_data)
+		{
+			if constexpr (std::is_same_v<U, string>)
+			{
+				if (!val.empty())
+				{
+					result.push_back(val[0]);
+				}
+				else
+				{
+					result.push_back('\0');
+				}
+			}
+			else
+			{
+				result.push_back(static_cast<char>(val));
+			}
+		}
+		return result;
+	}
+
+	/// @brief Convert to store of strings
+	/// @tparam U Original type (deduced)
+	/// @return New store with string values
+	template <typename U = T>
+	Store<string> to_string() const
+	{
+		ADV_STORE_TIME(StoreOp::to_string);
+		ADV_STORE_COUNT(StoreOp::to_string, 0, m_data.size(), 0);
+		if (m_data.empty())
+		{
+			s_error.throw_runtime_error();
+		}
+
+		Store<string> result;
+		for (const auto &val : m_data)
+		{
+			if constexpr (std::is_arithmetic_v<U>)
+			{
+				result.push_back(std::to_string(val));
+			}
+			else if constexpr (std::is_same_v<U, char>)
+			{
+				result.push_back(string(1, val));
+			}
+			else if constexpr (std::is_same_v<U, string>)
+			{
+				result.push_back(val);
+			}
+			else
+			{
+				// For other types, use string stream
+				std::ostringstream oss;
+				oss << val;
+				result.push_back(oss.str());
+			}
+		}
+		return result;
+	}
+
+  private:
+	friend struct detail::StoreAccess;
+
+	/// @brief Record the order of the current contents
+	void set_sort_order(SortOrder order) noexcept
+	{
+		m_sort_order = order;
+		m_sorted_at = m_version.value();
+	}
+
+	// =======================
+	// Membership Filter Helpers
+	// =======================
+
+	/// @brief Count handing out mutable access as a rewrite
+	/// @details Writes through a returned reference, pointer or iterator bypass
+	///          the member functions, so the version moves up front: the sort
+	///          order lapses and every cache rebuilds on its next use.
+	void untracked_write() noexcept
+	{
+		m_version.bump();
+	}
+
+	/// @brief Ask the membership filter whether value can be present
+	/// @return false only if value is certainly absent
+	bool maybe_present(const T &value) const
+	{
+		if constexpr (detail::is_hashable<T>::value)
+		{
+			if (detail::MembershipFilter *filter = m_filter.get())
+			{
+				filter->ensure(m_data, m_version.value(),
+							   [](const T &elem) { return detail::mix_hash(std::hash<T>()(elem)); });
+				return filter->may_contain(detail::mix_hash(std::hash<T>()(value)));
+			}
+		}
+		return true;
+	}
+
+	// =======================
+	// Range Index Helpers
+	// =======================
+
+	/// @brief Validate [first, last), optionally rejecting empty ranges
+	void check_range(size_t first, size_t last, bool non_empty) const
+	{
+		if (first > last || last > m_data.size() || (non_empty && first == last))
+		{
+			s_error.throw_out_of_range();
+		}
+	}
+
+	/// @brief Range trees, rebuilt first if the store changed (range index enabled)
+	const detail::RangeTrees<T> &current_ranges() const
+	{
+		detail::RangeTrees<T> &ranges = *m_ranges.get();
+		ranges.ensure(m_data, m_version.value());
+		return ranges;
+	}
+
+	// =======================
+	// Capacity Policy Helpers
+	// =======================
+
+	/// @brief Check if adding elements must grow the buffer under the policy
+	bool needs_growth(size_t added) const noexcept
+	{
+		return m_policy.growth_factor > 0 && m_data.size() + added > m_data.capacity();
+	}
+
+	/// @brief Reserve room for added elements using the policy growth factor
+	/// @details Every range add goes through here, so it also bumps the
+	///          version; adds at the end keep existing elements valid.
+	void grow_for(size_t added, bool at_end)
+	{
+		if (at_end)
+		{
+			m_version.bump_local();
+		}
+		else
+		{
+			m_version.bump();
+		}
+		if (needs_growth(added))
+		{
+			const auto scaled = static_cast<size_t>(static_cast<double>(m_data.capacity()) * m_policy.growth_factor);
+			m_data.reserve(std::max({m_data.size() + added, scaled, m_policy.min_capacity}));
+		}
+	}
+
+	/// @brief Assign one element, logging the position for incremental views
+	void write_at(size_t pos, const T &value)
+	{
+		m_version.bump_local();
+		m_data[pos] = value;
+		m_changes.record(m_version.value(), pos);
+	}
+
+	/// @brief Construct one element at pos, growing by the policy first
+	/// @details The value is built before growing since args may refer to
+	///          elements of this store. Every single-element add goes through
+	///          here, so it also bumps the version.
+	template <typename... Args>
+	void place(size_t pos, Args &&... args)
+	{
+		const bool at_end = pos == m_data.size();
+		if (at_end)
+		{
+			m_version.bump_local();
+		}
+		else
+		{
+			m_version.bump();
+		}
+		if (needs_growth(1))
+		{
+			T value(std::forward<Args>(args)...);
+			grow_for(1, at_end);
+			m_data.insert(m_data.begin() + pos, std::move(value));
+		}
+		else if (at_end)
+		{
+			m_data.emplace_back(std::forward<Args>(args)...);
+		}
+		else
+		{
+			m_data.emplace(m_data.begin() + pos, std::forward<Args>(args)...);
+		}
+	}
+
+	/// @brief Release capacity once size falls below the shrink threshold
+	/// @details Shrinks to size * growth factor (at least min_capacity), so the
+	///          store has to grow or shrink by a whole factor before the next
+	///          reallocation. Failure to allocate or copy keeps the old buffer;
+	///          types whose move may throw are copied, or left alone if move-only.
+	void shrink_if_sparse() noexcept
+	{
+		const size_t capacity = m_data.capacity();
+		if (m_policy.shrink_threshold <= 0 || capacity <= m_policy.min_capacity ||
+			static_cast<double>(m_data.size()) >= static_cast<double>(capacity) * m_policy.shrink_threshold)
+		{
+			return;
+		}
+		const size_t target = std::max(
+			m_policy.min_capacity,
+			static_cast<size_t>(static_cast<double>(m_data.size()) * m_policy.effective_growth()) + 1);
+		if (target >= capacity)
+		{
+			return;
+		}
+		if constexpr (!std::is_nothrow_move_constructible_v<T> && !std::is_copy_constructible_v<T>)
+		{
+			return; // A throwing move could leave elements half-moved, keep the slack
+		}
+		else
+		{
+			// Elements are copied when moving could throw, so a failure leaves m_data intact
+			try
+			{
+				vector<T, Alloc> shrunk(m_data.get_allocator());
+				shrunk.reserve(target);
+				for (T &value : m_data)
+				{
+					shrunk.push_back(std::move_if_noexcept(value));
+				}
+				m_data.swap(shrunk);
+			}
+			catch (...)
+			{
+			}
+		}
+	}
+};
+
+// =======================
+// Static Member Initialization
+// =======================
+template <typename T, typename Alloc>
+Errors Store<T, Alloc>::s_error;
+
+namespace detail
+{
+/// @brief Internal hooks for algorithms that know properties of their output
+struct StoreAccess
+{
+	template <typename T, typename Alloc>
+	static void set_sort_order(Store<T, Alloc> &store, SortOrder order) noexcept
+	{
+		store.set_sort_order(order);
+	}
+
+	/// @brief Last version at which existing elements may have moved or changed
+	template <typename T, typename Alloc>
+	static uint64_t rewritten(const Store<T, Alloc> &store) noexcept
+	{
+		return store.m_version.rewritten();
+	}
+
+	/// @brief Positions written one at a time (replace_at)
+	template <typename T, typename Alloc>
+	static const ChangeLog &changes(const Store<T, Alloc> &store) noexcept
+	{
+		return store.m_changes;
+	}
+};
+
+/// @brief Heap bytes owned by a nested Store, including its elements' storage
+template <typename U, typename Alloc>
+size_t heap_bytes(const Store<U, Alloc> &value) noexcept
+{
+	return value.memory_usage().total();
+}
+} // namespace detail
+
+// =======================
+// StoreIndex Template Class
+// =======================
+
+/// @brief Flat hash index from key to the positions holding that key
+/// @details Open addressing table over distinct keys; positions of each key
+///          are stored contiguously in ascending order. Lookups on an index
+///          whose store changed rebuild it first, lookups on an up-to-date
+///          index only read and may run concurrently.
+/// @tparam T Element type
+/// @tparam Alloc Allocator of the indexed store
+/// @tparam KeyFn Key function type
+template <typename T, typename Alloc, typename KeyFn>
+class StoreIndex
+{
+  public:
+	using key_type = std::decay_t<std::invoke_result_t<const KeyFn &, const T &>>;
+
+	/// @brief Ascending positions of one key, valid until the next rebuild
+	class Positions
+	{
+	  private:
+		const size_t *m_begin = nullptr;
+		const size_t *m_end = nullptr;
+
+	  public:
+		Positions() = default;
+		Positions(const size_t *begin, const size_t *end) : m_begin(begin), m_end(end) {}
+
+		const size_t *begin() const noexcept { return m_begin; }
+		const size_t *end() const noexcept { return m_end; }
+		size_t size() const noexcept { return static_cast<size_t>(m_end - m_begin); }
+		bool empty() const noexcept { return m_begin == m_end; }
+		size_t operator[](size_t i) const noexcept { return m_begin[i]; }
+	};
+
+  private:
+	/// @brief Table slot: full hash of the key and its group, k_empty if unused
+	struct Slot
+	{
+		size_t hash;
+		size_t group;
+	};
+
+	static constexpr size_t k_empty = static_cast<size_t>(-1);
+	static constexpr size_t k_prefetch_distance = 8; // Batch probe lookahead
+
+	const Store<T, Alloc> *m_store;
+	KeyFn m_key_fn;
+	mutable uint64_t m_version = 0;
+	mutable vector<Slot> m_slots;		// Power-of-two table
+	mutable vector<key_type> m_keys;	// Distinct keys, by group
+	mutable vector<size_t> m_offsets;	// Group g owns m_positions[m_offsets[g], m_offsets[g + 1])
+	mutable vector<size_t> m_positions; // Positions grouped by key
+
+	static size_t hash_of(const key_type &key) noexcept
+	{
+		return static_cast<size_t>(detail::mix_hash(std::hash<key_type>()(key)));
+	}
+
+	size_t find_group(const key_type &key, size_t hash) const noexcept
+	{
+		const size_t mask = m_slots.size() - 1;
+		for (size_t i = hash & mask;; i = (i + 1) & mask)
+		{
+			const Slot &slot = m_slots[i];
+			if (slot.group == k_empty)
+			{
+				return k_empty;
+			}
+			if (slot.hash == hash && m_keys[slot.group] == key)
+			{
+				return slot.group;
+			}
+		}
+	}
+
+	Positions group_positions(size_t group) const noexcept
+	{
+		if (group == k_empty)
+		{
+			return Positions();
+		}
+		const size_t *base = m_positions.data();
+		return Positions(base + m_offsets[group], base + m_offsets[group + 1]);
+	}
+
+  public:
+	/// @brief Constructor, builds the index
+	/// @param store Store to index, must outlive the index
+	/// @param key_fn Function computing the key of an element
+	StoreIndex(const Store<T, Alloc> &store, KeyFn key_fn) : m_store(&store), m_key_fn(std::move(key_fn))
+	{
+		rebuild();
 	}
 
-	/// @brief Remove duplicate elements
-	/// @param auto_sort Whether to sort before removing duplicates
-	void unique(bool auto_sort = true)
+	/// @brief Check if the store changed since the last build
+	/// @return true if the next lookup will rebuild
+	bool stale() const noexcept
+	{
+		return m_version != m_store->version();
+	}
+
+	/// @brief Rebuild if the store changed since the last build
+	void refresh() const
+	{
+		if (stale())
+		{
+			rebuild();
+		}
+	}
+
+	/// @brief Rebuild unconditionally, O(n) expected
+	void rebuild() const
+	{
+		const Store<T, Alloc> &store = *m_store;
+		const size_t n = store.size();
+		size_t table = 8;
+		while (table < 2 * n)
+		{
+			table <<= 1;
+		}
+		const size_t mask = table - 1;
+
+		m_slots.assign(table, Slot{0, k_empty});
+		m_keys.clear();
+		vector<size_t> group_of(n);
+		vector<size_t> counts;
+		for (size_t i = 0; i < n; ++i)
+		{
+			key_type key = m_key_fn(store[i]);
+			const size_t hash = hash_of(key);
+			size_t slot = hash & mask;
+			while (m_slots[slot].group != k_empty &&
+				   !(m_slots[slot].hash == hash && m_keys[m_slots[slot].group] == key))
+			{
+				slot = (slot + 1) & mask;
+			}
+			if (m_slots[slot].group == k_empty)
+			{
+				m_slots[slot] = Slot{hash, m_keys.size()};
+				m_keys.push_back(std::move(key));
+				counts.push_back(0);
+			}
+			group_of[i] = m_slots[slot].group;
+			++counts[group_of[i]];
+		}
+
+		m_offsets.assign(m_keys.size() + 1, 0);
+		for (size_t g = 0; g < counts.size(); ++g)
+		{
+			m_offsets[g + 1] = m_offsets[g] + counts[g];
+		}
+		m_positions.resize(n);
+		vector<size_t> cursor(m_offsets.begin(), m_offsets.end() - 1);
+		for (size_t i = 0; i < n; ++i)
+		{
+			m_positions[cursor[group_of[i]]++] = i;
+		}
+		m_version = store.version();
+	}
+
+	/// @brief Get number of distinct keys
+	/// @return Distinct key count
+	size_t key_count() const
+	{
+		refresh();
+		return m_keys.size();
+	}
+
+	/// @brief Get positions holding key, O(1) expected
+	/// @param key Key to look up
+	/// @return Ascending positions (empty if absent)
+	Positions positions(const key_type &key) const
+	{
+		refresh();
+		return group_positions(find_group(key, hash_of(key)));
+	}
+
+	/// @brief Check if some element has key
+	/// @param key Key to look up
+	/// @return true if found
+	bool contains(const key_type &key) const
+	{
+		return !positions(key).empty();
+	}
+
+	/// @brief Count elements with key
+	/// @param key Key to look up
+	/// @return Number of elements
+	size_t count(const key_type &key) const
+	{
+		return positions(key).size();
+	}
+
+	/// @brief Find all positions of key (same result as a find_all scan)
+	/// @param key Key to look up
+	/// @return Vector of positions
+	vector<size_t> find_all(const key_type &key) const
+	{
+		const Positions found = positions(key);
+		return vector<size_t>(found.begin(), found.end());
+	}
+
+	/// @brief Look up many keys in one pass
+	/// @details Hashes every key first, then probes with the table slots of
+	///          upcoming keys prefetched, hiding cache misses on large tables.
+	/// @param keys Keys to look up
+	/// @return Positions of each key, in the order of keys
+	vector<Positions> probe(const vector<key_type> &keys) const
+	{
+		refresh();
+		const size_t mask = m_slots.size() - 1;
+		vector<size_t> hashes(keys.size());
+		for (size_t i = 0; i < keys.size(); ++i)
+		{
+			hashes[i] = hash_of(keys[i]);
+		}
+
+		vector<Positions> result(keys.size());
+		for (size_t i = 0; i < keys.size(); ++i)
+		{
+#if defined(__GNUC__) || defined(__clang__)
+			if (i + k_prefetch_distance < keys.size())
+			{
+				__builtin_prefetch(&m_slots[hashes[i + k_prefetch_distance] & mask]);
+			}
+#endif
+			result[i] = group_positions(find_group(keys[i], hashes[i]));
+		}
+		return result;
+	}
+
+	/// @brief Check many keys in one pass
+	/// @param keys Keys to look up
+	/// @return For each key, whether it is present
+	vector<bool> contains_all(const vector<key_type> &keys) const
+	{
+		const vector<Positions> found = probe(keys);
+		vector<bool> result(found.size());
+		for (size_t i = 0; i < found.size(); ++i)
+		{
+			result[i] = !found[i].empty();
+		}
+		return result;
+	}
+};
+
+// =======================
+// StoreRmq Template Class
+// =======================
+
+/// @brief Block-decomposed sparse table for static range min/max
+/// @details Positions are split into blocks of k_block. Inside a window of
+///          up to k_block positions the answer comes from a bitmask of the
+///          monotonic stack ending there; longer ranges add a sparse table
+///          over whole blocks. Every query is O(1): at most three mask
+///          lookups and two table lookups. Memory is O(n): one 32-bit mask
+///          per element and (n / k_block) log(n / k_block) table entries for
+///          each of min and max. Ties go to the leftmost position.
+/// @tparam T Element type (needs operator<)
+/// @tparam Alloc Allocator of the queried store
+template <typename T, typename Alloc>
+class StoreRmq
+{
+  private:
+	static constexpr size_t k_block = 32; // Bits of a window mask
+
+	/// @brief Masks and block table for one direction (min or max)
+	struct Side
+	{
+		vector<uint32_t> masks;	// Stack of the k_block positions ending at i, bit d = position i - d
+		vector<size_t> table;	// Level j, block b at [j * blocks + b]
+	};
+
+	const Store<T, Alloc> *m_store;
+	mutable uint64_t m_version = 0;
+	mutable size_t m_blocks = 0; // Full blocks
+	mutable Side m_min;
+	mutable Side m_max;
+	static Errors s_error; // Error management
+
+	/// @brief Check if position a holds a strictly better value than b
+	template <bool Max>
+	bool beats(size_t a, size_t b) const
+	{
+		const Store<T, Alloc> &store = *m_store;
+		return Max ? store[b] < store[a] : store[a] < store[b];
+	}
+
+	/// @brief Better of two positions, leftmost on ties
+	template <bool Max>
+	size_t pick(size_t a, size_t b) const
+	{
+		if (beats<Max>(a, b))
+		{
+			return a;
+		}
+		if (beats<Max>(b, a))
+		{
+			return b;
+		}
+		return std::min(a, b);
+	}
+
+	/// @brief Best position in [last - width + 1, last], width <= k_block
+	size_t in_window(const Side &side, size_t last, size_t width) const noexcept
+	{
+		const uint32_t window = width == k_block ? ~uint32_t(0) : (uint32_t(1) << width) - 1;
+		return last - detail::floor_log2(side.masks[last] & window);
+	}
+
+	template <bool Max>
+	void build_side(Side &side) const
+	{
+		const size_t n = m_store->size();
+		side.masks.resize(n);
+		uint32_t stack = 0;
+		for (size_t i = 0; i < n; ++i)
+		{
+			stack <<= 1;
+			while (stack != 0 && beats<Max>(i, i - detail::floor_log2(stack & (~stack + 1))))
+			{
+				stack &= stack - 1;
+			}
+			stack |= 1;
+			side.masks[i] = stack;
+		}
+
+		const size_t levels = m_blocks == 0 ? 0 : detail::floor_log2(m_blocks) + 1;
+		side.table.resize(levels * m_blocks);
+		for (size_t b = 0; b < m_blocks; ++b)
+		{
+			side.table[b] = in_window(side, b * k_block + k_block - 1, k_block);
+		}
+		for (size_t j = 1; j < levels; ++j)
+		{
+			const size_t *below = &side.table[(j - 1) * m_blocks];
+			size_t *level = &side.table[j * m_blocks];
+			for (size_t b = 0; b + (size_t(1) << j) <= m_blocks; ++b)
+			{
+				level[b] = pick<Max>(below[b], below[b + (size_t(1) << (j - 1))]);
+			}
+		}
+	}
+
+	/// @brief Best position in the inclusive range [first, last]
+	template <bool Max>
+	size_t query(const Side &side, size_t first, size_t last) const
+	{
+		if (last - first + 1 <= k_block)
+		{
+			return in_window(side, last, last - first + 1);
+		}
+		size_t best = pick<Max>(in_window(side, first + k_block - 1, k_block), in_window(side, last, k_block));
+		const size_t low = first / k_block + 1;
+		const size_t high = last / k_block; // Exclusive
+		if (low < high)
+		{
+			const size_t j = detail::floor_log2(high - low);
+			const size_t *level = &side.table[j * m_blocks];
+			best = pick<Max>(best, pick<Max>(level[low], level[high - (size_t(1) << j)]));
+		}
+		return best;
+	}
+
+	void check(size_t first, size_t last) const
+	{
+		if (first >= last || last > m_store->size())
+		{
+			s_error.throw_out_of_range();
+		}
+	}
+
+	template <bool Max>
+	vector<size_t> query_all(const vector<RangeQuery> &queries) const
+	{
+		refresh();
+		for (const auto &q : queries)
+		{
+			check(q.first, q.last);
+		}
+		const Side &side = Max ? m_max : m_min;
+		vector<size_t> result(queries.size());
+		const auto by_first = [](const RangeQuery &a, const RangeQuery &b) { return a.first < b.first; };
+		if (std::is_sorted(queries.begin(), queries.end(), by_first))
+		{
+			for (size_t i = 0; i < queries.size(); ++i)
+			{
+				result[i] = query<Max>(side, queries[i].first, queries[i].last - 1);
+			}
+			return result;
+		}
+		// Answer in position order so masks and blocks are read front to back
+		vector<size_t> order(queries.size());
+		std::iota(order.begin(), order.end(), size_t(0));
+		std::sort(order.begin(), order.end(),
+				  [&](size_t a, size_t b) { return queries[a].first < queries[b].first; });
+		for (const size_t i : order)
+		{
+			result[i] = query<Max>(side, queries[i].first, queries[i].last - 1);
+		}
+		return result;
+	}
+
+  public:
+	/// @brief Constructor, builds the structure
+	/// @param store Store to query, must outlive this object
+	explicit StoreRmq(const Store<T, Alloc> &store) : m_store(&store)
+	{
+		rebuild();
+	}
+
+	/// @brief Check if the store changed since the last build
+	/// @return true if the next query will rebuild
+	bool stale() const noexcept
+	{
+		return m_version != m_store->version();
+	}
+
+	/// @brief Rebuild if the store changed since the last build
+	void refresh() const
+	{
+		if (stale())
+		{
+			rebuild();
+		}
+	}
+
+	/// @brief Rebuild unconditionally, O(n)
+	void rebuild() const
+	{
+		m_blocks = m_store->size() / k_block;
+		build_side<false>(m_min);
+		build_side<true>(m_max);
+		m_version = m_store->version();
+	}
+
+	/// @brief Position of the smallest element in [first, last), O(1)
+	/// @param first Start position
+	/// @param last End position (exclusive)
+	/// @return Leftmost position holding the minimum
+	/// @throws std::out_of_range if the range is empty or exceeds the store
+	size_t argmin(size_t first, size_t last) const
+	{
+		refresh();
+		check(first, last);
+		return query<false>(m_min, first, last - 1);
+	}
+
+	/// @brief Position of the largest element in [first, last), O(1)
+	/// @param first Start position
+	/// @param last End position (exclusive)
+	/// @return Leftmost position holding the maximum
+	/// @throws std::out_of_range if the range is empty or exceeds the store
+	size_t argmax(size_t first, size_t last) const
+	{
+		refresh();
+		check(first, last);
+		return query<true>(m_max, first, last - 1);
+	}
+
+	/// @brief Smallest element in [first, last), O(1)
+	/// @param first Start position
+	/// @param last End position (exclusive)
+	/// @return Const reference to the minimum
+	/// @throws std::out_of_range if the range is empty or exceeds the store
+	const T &range_min(size_t first, size_t last) const
+	{
+		return (*m_store)[argmin(first, last)];
+	}
+
+	/// @brief Largest element in [first, last), O(1)
+	/// @param first Start position
+	/// @param last End position (exclusive)
+	/// @return Const reference to the maximum
+	/// @throws std::out_of_range if the range is empty or exceeds the store
+	const T &range_max(size_t first, size_t last) const
+	{
+		return (*m_store)[argmax(first, last)];
+	}
+
+	/// @brief Answer many argmin queries
+	/// @details Queries are answered in order of their first position (the
+	///          input order if already sorted that way), so the masks and
+	///          block table are swept front to back instead of at random.
+	/// @param queries Ranges [first, last)
+	/// @return Argmin of each query, in input order
+	/// @throws std::out_of_range if any range is empty or exceeds the store
+	vector<size_t> argmin_all(const vector<RangeQuery> &queries) const
+	{
+		return query_all<false>(queries);
+	}
+
+	/// @brief Answer many argmax queries
+	/// @param queries Ranges [first, last)
+	/// @return Argmax of each query, in input order
+	/// @throws std::out_of_range if any range is empty or exceeds the store
+	vector<size_t> argmax_all(const vector<RangeQuery> &queries) const
+	{
+		return query_all<true>(queries);
+	}
+
+	/// @brief Get bytes held by masks and tables
+	/// @return Heap bytes
+	size_t bytes() const noexcept
+	{
+		return (m_min.masks.capacity() + m_max.masks.capacity()) * sizeof(uint32_t) +
+			   (m_min.table.capacity() + m_max.table.capacity()) * sizeof(size_t);
+	}
+};
+
+template <typename T, typename Alloc>
+Errors StoreRmq<T, Alloc>::s_error;
+
+// =======================
+// StoreSearch Template Class
+// =======================
+
+/// @brief Eytzinger (BFS-order) copy of a sorted store for fast searches
+/// @details Node k has children 2k and 2k + 1, so a search walks one array
+///          front to back and the nodes it reaches k_prefetch_levels later
+///          share one cache line, which is prefetched while the current
+///          comparison resolves. The descent is branch-free. Compared with
+///          std::lower_bound this hides most of the cache misses once the
+///          data exceeds L2. Batched lookups interleave k_batch searches to
+///          overlap their misses further.
+/// @tparam T Element type (needs operator<)
+/// @tparam Alloc Allocator of the searched store
+template <typename T, typename Alloc>
+class StoreSearch
+{
+  private:
+	static constexpr size_t k_line = 64;
+	static constexpr size_t k_per_line = sizeof(T) >= k_line ? 1 : k_line / sizeof(T);
+	static constexpr size_t k_batch = 16; // Searches run in lockstep
+
+	const Store<T, Alloc> *m_store;
+	mutable uint64_t m_version = 0;
+	mutable vector<T> m_tree;	   // 1-based Eytzinger order, [0] unused
+	mutable vector<size_t> m_rank; // Node -> position in the store
+	static Errors s_error;		   // Error management
+
+	void fill(size_t &position, size_t node) const
+	{
+		if (node < m_tree.size())
+		{
+			fill(position, 2 * node);
+			m_tree[node] = (*m_store)[position];
+			m_rank[node] = position++;
+			fill(position, 2 * node + 1);
+		}
+	}
+
+	void prefetch(size_t node) const noexcept
+	{
+#if defined(__GNUC__) || defined(__clang__)
+		// Prefetching past the end is harmless, so the address is not checked
+		const auto address = reinterpret_cast<std::uintptr_t>(m_tree.data()) + node * k_per_line * sizeof(T);
+		__builtin_prefetch(reinterpret_cast<const void *>(address));
+#else
+		(void)node;
+#endif
+	}
+
+	/// @brief Descend one level: right when the node is before value
+	template <bool Upper>
+	size_t step(size_t node, const T &value) const
+	{
+		const bool right = Upper ? !(value < m_tree[node]) : m_tree[node] < value;
+		return 2 * node + static_cast<size_t>(right);
+	}
+
+	/// @brief Map the node where a descent fell off the tree to a position
+	size_t finish(size_t node) const noexcept
+	{
+		// Undo the trailing right turns and the final left one
+		node >>= detail::floor_log2(~node & (node + 1)) + 1;
+		return node == 0 ? m_rank.size() - 1 : m_rank[node];
+	}
+
+	template <bool Upper>
+	size_t search(const T &value) const
+	{
+		size_t node = 1;
+		while (node < m_tree.size())
+		{
+			prefetch(node);
+			node = step<Upper>(node, value);
+		}
+		return finish(node);
+	}
+
+	template <bool Upper>
+	vector<size_t> search_all(const vector<T> &values) const
+	{
+		refresh();
+		vector<size_t> result(values.size());
+		size_t nodes[k_batch];
+		for (size_t base = 0; base < values.size(); base += k_batch)
+		{
+			const size_t count = std::min(k_batch, values.size() - base);
+			std::fill(nodes, nodes + count, size_t(1));
+			bool active = true;
+			while (active)
+			{
+				active = false;
+				for (size_t i = 0; i < count; ++i)
+				{
+					if (nodes[i] < m_tree.size())
+					{
+						prefetch(nodes[i]);
+						nodes[i] = step<Upper>(nodes[i], values[base + i]);
+						active = true;
+					}
+				}
+			}
+			for (size_t i = 0; i < count; ++i)
+			{
+				result[base + i] = finish(nodes[i]);
+			}
+		}
+		return result;
+	}
+
+  public:
+	/// @brief Constructor, builds the layout
+	/// @param store Sorted store to search, must outlive this object
+	/// @throws std::invalid_argument if the store is not sorted ascending
+	explicit StoreSearch(const Store<T, Alloc> &store) : m_store(&store)
+	{
+		rebuild();
+	}
+
+	/// @brief Check if the store changed since the last build
+	/// @return true if the next query will rebuild
+	bool stale() const noexcept
+	{
+		return m_version != m_store->version();
+	}
+
+	/// @brief Rebuild if the store changed since the last build
+	/// @throws std::invalid_argument if the store is no longer sorted ascending
+	void refresh() const
+	{
+		if (stale())
+		{
+			rebuild();
+		}
+	}
+
+	/// @brief Rebuild unconditionally, O(n)
+	/// @throws std::invalid_argument if the store is not sorted ascending
+	void rebuild() const
+	{
+		const Store<T, Alloc> &store = *m_store;
+		if (store.sort_order() != SortOrder::ascending && !std::is_sorted(store.begin(), store.end()))
+		{
+			s_error.throw_invalid_argument();
+		}
+		m_tree.assign(store.begin(), store.end());
+		m_tree.insert(m_tree.begin(), store.empty() ? T() : store[0]);
+		m_rank.assign(store.size() + 1, 0);
+		size_t position = 0;
+		fill(position, 1);
+		m_rank[0] = store.size();
+		m_version = store.version();
+	}
+
+	/// @brief Position of the first element not less than value
+	/// @param value Value to search for
+	/// @return Position in the store, size() if every element is less
+	size_t lower_bound(const T &value) const
+	{
+		refresh();
+		return search<false>(value);
+	}
+
+	/// @brief Position of the first element greater than value
+	/// @param value Value to search for
+	/// @return Position in the store, size() if no element is greater
+	size_t upper_bound(const T &value) const
+	{
+		refresh();
+		return search<true>(value);
+	}
+
+	/// @brief Check if value is present
+	/// @param value Value to search for
+	/// @return true if found
+	bool contains(const T &value) const
+	{
+		const size_t position = lower_bound(value);
+		return position < m_store->size() && !(value < (*m_store)[position]);
+	}
+
+	/// @brief Count elements equal to value, O(log n)
+	/// @param value Value to count
+	/// @return Number of occurrences
+	size_t count(const T &value) const
+	{
+		return upper_bound(value) - lower_bound(value);
+	}
+
+	/// @brief lower_bound for many values, interleaving the searches
+	/// @param values Values to search for
+	/// @return Position of each value, in input order
+	vector<size_t> lower_bound_all(const vector<T> &values) const
+	{
+		return search_all<false>(values);
+	}
+
+	/// @brief contains for many values, interleaving the searches
+	/// @param values Values to search for
+	/// @return For each value, whether it is present
+	vector<bool> contains_all(const vector<T> &values) const
+	{
+		const vector<size_t> positions = lower_bound_all(values);
+		vector<bool> result(values.size());
+		for (size_t i = 0; i < values.size(); ++i)
+		{
+			result[i] = positions[i] < m_store->size() && !(values[i] < (*m_store)[positions[i]]);
+		}
+		return result;
+	}
+};
+
+template <typename T, typename Alloc>
+Errors StoreSearch<T, Alloc>::s_error;
+
+// =======================
+// FrozenStore Template Class
+// =======================
+
+/// @brief Immutable store with exact-size storage and O(1) lookups
+/// @details Built once (see Store::freeze()). Distinct elements are deduped
+///          by sorting their 64-bit hashes, then a minimal perfect hash maps
+///          each to a slot holding the element's first position: about 3.5
+///          bits of hash plus 4 bytes per distinct element (8 beyond 4G
+///          elements). contains and find hash once, walk 1.6 bit levels on
+///          average and compare one element.
+/// @tparam T Element type (needs std::hash<T> and operator==)
+template <typename T>
+class FrozenStore
+{
+	static_assert(detail::is_hashable<T>::value, "FrozenStore requires std::hash<T>");
+
+  public:
+	/// @brief Position returned by find for absent values
+	static constexpr size_t npos = static_cast<size_t>(-1);
+
+	using value_type = T;
+	using size_type = size_t;
+	using const_reference = const T &;
+	using const_iterator = const T *;
+
+  private:
+	vector<T> m_data;					// Exact capacity
+	detail::MinimalPerfectHash m_hash;	// Distinct element -> slot
+	vector<uint32_t> m_first;			// Slot -> first position, when size() fits
+	vector<size_t> m_first_wide;		// Slot -> first position, otherwise
+	vector<size_t> m_overflow;			// First positions of elements without a slot
+	static Errors s_error;				// Error management
+
+	static uint64_t hash_of(const T &value)
 	{
-		if (auto_sort)
-		{
-			sort();
-		}
-		auto it = std::unique(m_data.begin(), m_data.end());
-		m_data.erase(it, m_data.end());
+		return detail::mix_hash(std::hash<T>()(value));
 	}
 
-	// =======================
-	// Type Conversion
-	// =======================
-
-	/// @brief Convert to store of integers
-	/// @tparam U Original type (deduced)
-	/// @return New store with integer values
-	template <typename U = T>
-	Store<int> to_int() const
+	size_t first_of(size_t slot) const noexcept
 	{
-		static_assert(std::is_arithmetic_v<U> || std::is_same_v<U, string>,
-					  "Type must be arithmetic or string for conversion to int");
+		return m_first.empty() ? m_first_wide[slot] : m_first[slot];
+	}
 
-		if (m_data.empty())
+	void build()
+	{
+		const size_t n = m_data.size();
+		vector<std::pair<uint64_t, size_t>> entries(n);
+		for (size_t i = 0; i < n; ++i)
 		{
-			s_error.throw_runtime_error();
+			entries[i] = {hash_of(m_data[i]), i};
 		}
+		std::sort(entries.begin(), entries.end());
 
-		Store<int> result;
-		for (const auto &val : m_data)
+		// One (hash, first position) per distinct element; distinct elements
+		// sharing a 64-bit hash beyond the first go to the overflow list
+		vector<uint64_t> hashes;
+		vector<size_t> firsts;
+		for (size_t i = 0; i < n;)
 		{
-			if constexpr (std::is_same_v<U, string>)
+			size_t end = i + 1;
+			while (end < n && entries[end].first == entries[i].first)
 			{
-				try
+				++end;
+			}
+			hashes.push_back(entries[i].first);
+			firsts.push_back(entries[i].second);
+			for (size_t j = i + 1; j < end; ++j)
+			{
+				const T &value = m_data[entries[j].second];
+				bool seen = value == m_data[entries[i].second];
+				for (size_t k = 0; k < m_overflow.size() && !seen; ++k)
 				{
-					result.push_back(std::stoi(val));
+					seen = value == m_data[m_overflow[k]];
 				}
-				catch (...)
+				if (!seen)
 				{
-					result.push_back(0);
+					m_overflow.push_back(entries[j].second);
 				}
 			}
+			i = end;
+		}
+		vector<std::pair<uint64_t, size_t>>().swap(entries);
+
+		vector<uint64_t> unplaced = m_hash.build(hashes);
+		std::sort(unplaced.begin(), unplaced.end());
+		const bool narrow = n <= std::numeric_limits<uint32_t>::max();
+		if (narrow)
+		{
+			m_first.resize(m_hash.size());
+		}
+		else
+		{
+			m_first_wide.resize(m_hash.size());
+		}
+		for (size_t k = 0; k < hashes.size(); ++k)
+		{
+			if (!unplaced.empty() && std::binary_search(unplaced.begin(), unplaced.end(), hashes[k]))
+			{
+				m_overflow.push_back(firsts[k]);
+				continue;
+			}
+			const size_t slot = m_hash.lookup(hashes[k]);
+			if (narrow)
+			{
+				m_first[slot] = static_cast<uint32_t>(firsts[k]);
+			}
 			else
 			{
-				result.push_back(static_cast<int>(val));
+				m_first_wide[slot] = firsts[k];
 			}
 		}
-		return result;
+		std::sort(m_overflow.begin(), m_overflow.end());
 	}
 
-	/// @brief Convert to store of doubles
-	/// @tparam U Original type (deduced)
-	/// @return New store with double values
-	template <typename U = T>
-	Store<double> to_double() const
+  public:
+	// =======================
+	// Constructors & Destructor
+	// =======================
+
+	/// @brief Default constructor (empty)
+	FrozenStore() = default;
+
+	/// @brief Constructor with iterator range, O(n log n)
+	/// @tparam Iterator Iterator type
+	/// @param begin Start iterator
+	/// @param end End iterator
+	template <typename Iterator>
+	FrozenStore(Iterator begin, Iterator end) : m_data(begin, end)
 	{
-		static_assert(std::is_arithmetic_v<U> || std::is_same_v<U, string>,
-					  "Type must be arithmetic or string for conversion to double");
+		m_data.shrink_to_fit();
+		build();
+	}
 
-		if (m_data.empty())
+	/// @brief Constructor with initializer list
+	/// @param list Initializer list of elements
+	FrozenStore(initializer_list<T> list) : FrozenStore(list.begin(), list.end()) {}
+
+	// =======================
+	// Element Access
+	// =======================
+
+	/// @brief Access element with bounds checking
+	/// @param pos Position of element
+	/// @return Const reference to element
+	/// @throws std::out_of_range if position is invalid
+	const T &at(size_t pos) const
+	{
+		if (pos >= m_data.size())
 		{
-			s_error.throw_runtime_error();
+			s_error.throw_out_of_range();
 		}
+		return m_data[pos];
+	}
 
-		Store<double> result;
-		for (const auto &val : m_data)
+	/// @brief Access element without bounds checking
+	/// @param pos Position of element
+	/// @return Const reference to element
+	const T &operator[](size_t pos) const noexcept
+	{
+		return m_data[pos];
+	}
+
+	/// @brief Get const raw pointer to data
+	/// @return Const pointer to underlying data array
+	const T *data() const noexcept
+	{
+		return m_data.data();
+	}
+
+	const_iterator begin() const noexcept
+	{
+		return m_data.data();
+	}
+
+	const_iterator end() const noexcept
+	{
+		return m_data.data() + m_data.size();
+	}
+
+	// =======================
+	// Capacity
+	// =======================
+
+	/// @brief Get number of elements
+	/// @return Number of elements
+	size_t size() const noexcept
+	{
+		return m_data.size();
+	}
+
+	/// @brief Check if store is empty
+	/// @return true if empty
+	bool empty() const noexcept
+	{
+		return m_data.empty();
+	}
+
+	/// @brief Get bytes held besides the elements themselves
+	/// @return Heap bytes of the hash and position tables
+	size_t metadata_bytes() const noexcept
+	{
+		return m_hash.bytes() + m_first.capacity() * sizeof(uint32_t) +
+			   (m_first_wide.capacity() + m_overflow.capacity()) * sizeof(size_t);
+	}
+
+	// =======================
+	// Search & Check
+	// =======================
+
+	/// @brief Find the first position of value, O(1)
+	/// @param value Value to search for
+	/// @return First position holding value, npos if absent
+	size_t find(const T &value) const
+	{
+		const size_t slot = m_hash.lookup(hash_of(value));
+		if (slot < m_hash.size())
 		{
-			if constexpr (std::is_same_v<U, string>)
+			const size_t position = first_of(slot);
+			if (m_data[position] == value)
 			{
-				try
-				{
-					result.push_back(std::stod(val));
-				}
-				catch (...)
-				{
-					result.push_back(0.0);
-				}
+				return position;
 			}
-			else
+		}
+		for (const size_t position : m_overflow)
+		{
+			if (m_data[position] == value)
 			{
-				result.push_back(static_cast<double>(val));
+				return position;
 			}
 		}
-		return result;
+		return npos;
 	}
 
-	/// @brief Convert to store of characters
-	/// @tparam U Original type (deduced)
-	/// @return New store with character values
-	template <typename U = T>
-	Store<char> to_char() const
+	/// @brief Check if value is present, O(1)
+	/// @param value Value to search for
+	/// @return true if found
+	bool contains(const T &value) const
 	{
-		static_assert(std::is_arithmetic_v<U> || std::is_same_v<U, string>,
-					  "Type must be arithmetic or string for conversion to char");
+		return find(value) != npos;
+	}
 
-		if (m_data.empty())
-		{
-			s_error.throw_runtime_error();
-		}
+	/// @brief Get number of distinct elements
+	/// @return Distinct element count
+	size_t distinct() const noexcept
+	{
+		return m_hash.size() + m_overflow.size();
+	}
 
-		Store<char> result;
-		for (const auto &val : m_data)
+	/// @brief Copy back into a modifiable Store
+	/// @return New store with the same elements
+	Store<T> thaw() const
+	{
+		return Store<T>(m_data.begin(), m_data.end());
+	}
+};
+
+template <typename T>
+Errors FrozenStore<T>::s_error;
+
+// =======================
+// LiveFilter Template Class
+// =======================
+
+/// @brief Materialized filter over a Store, refreshed from its change history
+/// @details Keeps the ascending positions of matching elements. A refresh
+///          after appends evaluates only the new tail; positions logged by
+///          replace_at are re-evaluated and inserted or erased in place.
+///          Anything else that may move existing elements (insert, erase,
+///          sort, mutable element access, mark_modified, ...) triggers a full
+///          rescan. Reading functions refresh first and may not run
+///          concurrently with each other or with modifications.
+/// @tparam T Element type
+/// @tparam Alloc Allocator of the filtered store
+/// @tparam Pred Predicate type
+template <typename T, typename Alloc, typename Pred>
+class LiveFilter
+{
+  private:
+	const Store<T, Alloc> *m_store;
+	Pred m_pred;
+	mutable uint64_t m_version = 0;
+	mutable size_t m_scanned = 0;		   // Store size at the last refresh
+	mutable vector<size_t> m_positions;	   // Ascending matching positions
+	mutable size_t m_evaluations = 0;	   // Predicate calls so far
+
+	bool matches(size_t pos) const
+	{
+		++m_evaluations;
+		return m_pred((*m_store)[pos]);
+	}
+
+	void scan_from(size_t first) const
+	{
+		for (size_t i = first; i < m_store->size(); ++i)
 		{
-			if constexpr (std::is_same_v<U, string>)
-			{
-				if (!val.empty())
-				{
-					result.push_back(val[0]);
-				}
-				else
-				{
-					result.push_back('\0');
-				}
-			}
-			else
+			if (matches(i))
 			{
-				result.push_back(static_cast<char>(val));
+				m_positions.push_back(i);
 			}
 		}
-		return result;
 	}
 
-	/// @brief Convert to store of strings
-	/// @tparam U Original type (deduced)
-	/// @return New store with string values
-	template <typename U = T>
-	Store<string> to_string() const
+	void recheck(size_t pos) const
 	{
-		if (m_data.empty())
+		const auto it = std::lower_bound(m_positions.begin(), m_positions.end(), pos);
+		const bool listed = it != m_positions.end() && *it == pos;
+		const bool match = matches(pos);
+		if (match && !listed)
 		{
-			s_error.throw_runtime_error();
+			m_positions.insert(it, pos);
+		}
+		else if (!match && listed)
+		{
+			m_positions.erase(it);
 		}
+	}
 
-		Store<string> result;
-		for (const auto &val : m_data)
+  public:
+	/// @brief Constructor, scans the store once
+	/// @param store Store to filter, must outlive the view
+	/// @param pred Predicate function
+	LiveFilter(const Store<T, Alloc> &store, Pred pred) : m_store(&store), m_pred(std::move(pred))
+	{
+		rebuild();
+	}
+
+	/// @brief Check if the store changed since the last refresh
+	/// @return true if the next access will refresh
+	bool stale() const noexcept
+	{
+		return m_version != m_store->version();
+	}
+
+	/// @brief Bring the view up to date, O(delta) after appends and replace_at
+	void refresh() const
+	{
+		if (!stale())
 		{
-			if constexpr (std::is_arithmetic_v<U>)
-			{
-				result.push_back(std::to_string(val));
-			}
-			else if constexpr (std::is_same_v<U, char>)
-			{
-				result.push_back(string(1, val));
-			}
-			else if constexpr (std::is_same_v<U, string>)
-			{
-				result.push_back(val);
-			}
-			else
+			return;
+		}
+		const Store<T, Alloc> &store = *m_store;
+		const detail::ChangeLog &changes = detail::StoreAccess::changes(store);
+		if (detail::StoreAccess::rewritten(store) > m_version || !changes.covers(m_version) ||
+			store.size() < m_scanned)
+		{
+			rebuild();
+			return;
+		}
+		changes.for_each_after(m_version, [&](size_t pos) {
+			if (pos < m_scanned)
 			{
-				// For other types, use string stream
-				std::ostringstream oss;
-				oss << val;
-				result.push_back(oss.str());
+				recheck(pos);
 			}
+		});
+		scan_from(m_scanned);
+		m_scanned = store.size();
+		m_version = store.version();
+	}
+
+	/// @brief Rescan the whole store, O(n)
+	void rebuild() const
+	{
+		m_positions.clear();
+		scan_from(0);
+		m_scanned = m_store->size();
+		m_version = m_store->version();
+	}
+
+	/// @brief Get number of matching elements
+	/// @return Match count
+	size_t size() const
+	{
+		refresh();
+		return m_positions.size();
+	}
+
+	/// @brief Check if no element matches
+	/// @return true if empty
+	bool empty() const
+	{
+		return size() == 0;
+	}
+
+	/// @brief Get the i-th matching element
+	/// @param i Index among the matches
+	/// @return Const reference to the element in the store
+	/// @throws std::out_of_range if i >= size()
+	const T &at(size_t i) const
+	{
+		refresh();
+		if (i >= m_positions.size())
+		{
+			Errors().throw_out_of_range();
+		}
+		return (*m_store)[m_positions[i]];
+	}
+
+	/// @brief Get positions of matching elements
+	/// @return Ascending positions, valid until the next refresh
+	const vector<size_t> &positions() const
+	{
+		refresh();
+		return m_positions;
+	}
+
+	/// @brief Copy the matching elements
+	/// @return New store, same as store.filter(pred)
+	Store<T, Alloc> to_store() const
+	{
+		refresh();
+		Store<T, Alloc> result(m_store->get_allocator());
+		result.reserve(m_positions.size());
+		for (const size_t pos : m_positions)
+		{
+			result.push_back((*m_store)[pos]);
 		}
 		return result;
 	}
+
+	/// @brief Get number of predicate calls made so far
+	/// @return Evaluation count, for checking that refreshes stay incremental
+	size_t evaluations() const noexcept
+	{
+		return m_evaluations;
+	}
 };
 
-// =======================
-// Static Member Initialization
-// =======================
+/// @brief Store using TrackingAllocator
 template <typename T>
-Errors Store<T>::s_error;
+using TrackedStore = Store<T, TrackingAllocator<T>>;
 
 } // namespace adv
\ No newline at end of file
@@ -0,0 +1,425 @@
+#pragma once
+#include "advance_store.hpp"
+#include <atomic>
+#include <new>
+#include <thread>
+
+namespace adv
+{
+
+// =======================
+// ConcurrentStore Template Class
+// =======================
+
+/// @brief Append-only store with lock-free multi-producer push_back
+/// @details Producers reserve a slot with one fetch-add and construct the
+///          element in segmented storage that never moves, so published
+///          elements stay valid while other threads append. Each segment is
+///          allocated once, by the producer reserving its first slot; others
+///          reaching it meanwhile wait for that allocation. Readers see the
+///          published prefix: every element up to the first slot still under
+///          construction. freeze() turns the contents into a regular Store.
+/// @tparam T Element type
+template <typename T>
+class ConcurrentStore
+{
+  private:
+	static_assert(std::is_nothrow_move_constructible_v<T>,
+				  "ConcurrentStore requires a nothrow move constructible type");
+
+	static constexpr size_t k_first_bits = 5; // First segment holds 32 elements
+	static constexpr size_t k_first_size = size_t(1) << k_first_bits;
+	static constexpr size_t k_max_segments = sizeof(size_t) * 8 - k_first_bits;
+	static constexpr size_t k_open = ~size_t(0); // m_sealed_at while pushes are accepted
+
+	/// @brief Element storage plus its publication flag
+	struct Slot
+	{
+		alignas(T) unsigned char storage[sizeof(T)];
+		std::atomic<bool> ready{false};
+
+		T &value() noexcept { return *std::launder(reinterpret_cast<T *>(storage)); }
+		const T &value() const noexcept { return *std::launder(reinterpret_cast<const T *>(storage)); }
+	};
+
+	std::atomic<Slot *> m_segments[k_max_segments] = {};	// Segment k holds 32 << k slots
+	alignas(64) std::atomic<size_t> m_reserved{0};			// Slots handed out to producers
+	alignas(64) mutable std::atomic<size_t> m_published{0}; // Known ready prefix (lazy watermark)
+	std::atomic<size_t> m_sealed_at{k_open};				// First index that can never be published
+	static Errors s_error;									// Error management
+
+  public:
+	/// @brief Read-only view of the published prefix at the time it was taken
+	class View
+	{
+	  private:
+		const ConcurrentStore *m_store;
+		size_t m_size;
+
+	  public:
+		/// @brief Random access iterator over the view
+		class const_iterator
+		{
+		  private:
+			const ConcurrentStore *m_store = nullptr;
+			size_t m_index = 0;
+
+		  public:
+			using iterator_category = std::random_access_iterator_tag;
+			using value_type = T;
+			using difference_type = std::ptrdiff_t;
+			using pointer = const T *;
+			using reference = const T &;
+
+			const_iterator() = default;
+			const_iterator(const ConcurrentStore *store, size_t index) : m_store(store), m_index(index) {}
+
+			reference operator*() const { return m_store->slot_at(m_index).value(); }
+			pointer operator->() const { return &**this; }
+			reference operator[](difference_type n) const { return *(*this + n); }
+
+			const_iterator &operator++() { ++m_index; return *this; }
+			const_iterator operator++(int) { const_iterator copy = *this; ++m_index; return copy; }
+			const_iterator &operator--() { --m_index; return *this; }
+			const_iterator operator--(int) { const_iterator copy = *this; --m_index; return copy; }
+			const_iterator &operator+=(difference_type n) { m_index += n; return *this; }
+			const_iterator &operator-=(difference_type n) { m_index -= n; return *this; }
+			const_iterator operator+(difference_type n) const { return const_iterator(m_store, m_index + n); }
+			const_iterator operator-(difference_type n) const { return const_iterator(m_store, m_index - n); }
+			difference_type operator-(const const_iterator &other) const
+			{
+				return static_cast<difference_type>(m_index) - static_cast<difference_type>(other.m_index);
+			}
+
+			bool operator==(const const_iterator &other) const { return m_index == other.m_index; }
+			bool operator!=(const const_iterator &other) const { return m_index != other.m_index; }
+			bool operator<(const const_iterator &other) const { return m_index < other.m_index; }
+			bool operator>(const const_iterator &other) const { return m_index > other.m_index; }
+			bool operator<=(const const_iterator &other) const { return m_index <= other.m_index; }
+			bool operator>=(const const_iterator &other) const { return m_index >= other.m_index; }
+		};
+
+		View(const ConcurrentStore *store, size_t size) : m_store(store), m_size(size) {}
+
+		/// @brief Get number of elements in the view
+		size_t size() const noexcept { return m_size; }
+		/// @brief Check if view is empty
+		bool empty() const noexcept { return m_size == 0; }
+
+		/// @brief Access element with bounds checking
+		/// @param pos Position to access
+		/// @return Const reference to element
+		/// @throws std::out_of_range if position is invalid
+		const T &at(size_t pos) const
+		{
+			if (pos >= m_size)
+			{
+				s_error.throw_out_of_range();
+			}
+			return m_store->slot_at(pos).value();
+		}
+
+		/// @brief Access element without bounds checking
+		const T &operator[](size_t pos) const noexcept { return m_store->slot_at(pos).value(); }
+
+		const_iterator begin() const { return const_iterator(m_store, 0); }
+		const_iterator end() const { return const_iterator(m_store, m_size); }
+	};
+
+	// =======================
+	// Constructors & Destructor
+	// =======================
+
+	/// @brief Default constructor
+	ConcurrentStore() = default;
+
+	ConcurrentStore(const ConcurrentStore &) = delete;
+	ConcurrentStore &operator=(const ConcurrentStore &) = delete;
+
+	/// @brief Destructor, destroys every element
+	/// @details No producer may be running.
+	~ConcurrentStore()
+	{
+		destroy_all();
+	}
+
+	// =======================
+	// Adding Elements (thread-safe)
+	// =======================
+
+	/// @brief Add value (lock-free)
+	/// @param value Value to add
+	/// @return Index of the new element
+	size_t push_back(const T &value)
+	{
+		return emplace_back(value);
+	}
+
+	/// @brief Add moved value (lock-free)
+	/// @param value Value to move
+	/// @return Index of the new element
+	size_t push_back(T &&value)
+	{
+		return emplace_back(std::move(value));
+	}
+
+	/// @brief Emplace element (lock-free)
+	/// @details When construction may throw, the element is built before a
+	///          slot is reserved so that a failure never leaves a hole.
+	/// @tparam Args Argument types
+	/// @param args Arguments to construct element
+	/// @return Index of the new element
+	template <typename... Args>
+	size_t emplace_back(Args &&... args)
+	{
+		if constexpr (std::is_nothrow_constructible_v<T, Args &&...>)
+		{
+			const size_t index = reserve_slot();
+			Slot &slot = slot_at(index);
+			::new (static_cast<void *>(slot.storage)) T(std::forward<Args>(args)...);
+			slot.ready.store(true, std::memory_order_release);
+			return index;
+		}
+		else
+		{
+			T value(std::forward<Args>(args)...);
+			return emplace_back(std::move(value));
+		}
+	}
+
+	// =======================
+	// Reading (thread-safe)
+	// =======================
+
+	/// @brief Get number of published elements
+	/// @details Advances the shared watermark over slots that became ready.
+	/// @return Length of the ready prefix
+	size_t size() const noexcept
+	{
+		size_t published = m_published.load(std::memory_order_acquire);
+		const size_t reserved = m_reserved.load(std::memory_order_acquire);
+		size_t ready = published;
+		while (ready < reserved && slot_ready(ready))
+		{
+			++ready;
+		}
+		while (ready > published &&
+			   !m_published.compare_exchange_weak(published, ready, std::memory_order_acq_rel))
+		{
+		}
+		return std::max(ready, published);
+	}
+
+	/// @brief Get number of reserved slots (published or under construction)
+	/// @return Reserved count
+	size_t reserved_size() const noexcept
+	{
+		return m_reserved.load(std::memory_order_acquire);
+	}
+
+	/// @brief Check if no element is published
+	/// @return true if empty
+	bool empty() const noexcept
+	{
+		return size() == 0;
+	}
+
+	/// @brief Take a view of the currently published prefix
+	/// @details Elements of the view never move or change while producers append.
+	/// @return View over [0, size())
+	View published() const noexcept
+	{
+		return View(this, size());
+	}
+
+	/// @brief Visit every published element
+	/// @tparam Func Function type
+	/// @param func Function called with each element
+	template <typename Func>
+	void for_each(Func func) const
+	{
+		for (const auto &value : published())
+		{
+			func(value);
+		}
+	}
+
+	// =======================
+	// Conversion (single-threaded)
+	// =======================
+
+	/// @brief Move every element into a contiguous Store and empty this store
+	/// @details Waits for producers that already reserved a slot to publish it.
+	///          No producer may start a new push while freeze() runs. The
+	///          emptied store accepts pushes again, even after a failed one.
+	/// @return Store with all elements in index order
+	Store<T> freeze()
+	{
+		const size_t reserved = std::min(m_reserved.load(std::memory_order_acquire),
+										 m_sealed_at.load(std::memory_order_acquire));
+		for (size_t i = 0; i < reserved; ++i)
+		{
+			while (!slot_ready(i))
+			{
+				std::this_thread::yield();
+			}
+		}
+
+		Store<T> result;
+		result.reserve(reserved);
+		for (size_t i = 0; i < reserved; ++i)
+		{
+			result.push_back(std::move(slot_at(i).value()));
+		}
+		destroy_all();
+		return result;
+	}
+
+	/// @brief Copy the published prefix into a Store
+	/// @return Store with published elements in index order
+	Store<T> to_store() const
+	{
+		const View view = published();
+		return Store<T>(view.begin(), view.end());
+	}
+
+  private:
+	/// @brief Map an index to (segment, offset)
+	static void locate(size_t index, size_t &segment, size_t &offset) noexcept
+	{
+		const size_t biased = (index >> k_first_bits) + 1;
+#if defined(__GNUC__) || defined(__clang__)
+		segment = 63 - static_cast<size_t>(__builtin_clzll(static_cast<unsigned long long>(biased)));
+#else
+		segment = 0;
+		while (biased >> (segment + 1))
+		{
+			++segment;
+		}
+#endif
+		offset = index - ((size_t(1) << segment) - 1) * k_first_size;
+	}
+
+	static size_t segment_size(size_t segment) noexcept
+	{
+		return k_first_size << segment;
+	}
+
+	/// @brief Reserve the next index and wait until its segment exists
+	/// @details One fetch-add per push. The producer that reserves the first
+	///          slot of a segment allocates it, after the previous segment
+	///          exists; producers landing later in the segment wait for the
+	///          pointer instead of allocating a copy of their own. If the
+	///          allocation fails the store is sealed at the segment start: the
+	///          published prefix ends there, pushes that reserved a later index
+	///          throw as well and nothing past the seal is ever published, so
+	///          size() and freeze() never wait for a hole.
+	/// @return Reserved index
+	/// @throws std::out_of_range if every segment is used
+	/// @throws std::bad_alloc if a segment cannot be allocated or the store is sealed
+	size_t reserve_slot()
+	{
+		if (m_sealed_at.load(std::memory_order_acquire) != k_open)
+		{
+			throw std::bad_alloc();
+		}
+		const size_t index = m_reserved.fetch_add(1, std::memory_order_relaxed);
+		size_t segment, offset;
+		locate(index, segment, offset);
+		if (segment >= k_max_segments)
+		{
+			seal(index);
+			s_error.throw_out_of_range();
+		}
+		if (offset != 0)
+		{
+			wait_for_segment(segment, index);
+			return index;
+		}
+		if (segment > 0)
+		{
+			wait_for_segment(segment - 1, index);
+		}
+		try
+		{
+			m_segments[segment].store(new Slot[segment_size(segment)], std::memory_order_release);
+		}
+		catch (...)
+		{
+			seal(index);
+			throw;
+		}
+		return index;
+	}
+
+	/// @brief Spin until a segment is installed
+	/// @throws std::bad_alloc if the store was sealed at or before index
+	void wait_for_segment(size_t segment, size_t index) const
+	{
+		while (!m_segments[segment].load(std::memory_order_acquire))
+		{
+			if (m_sealed_at.load(std::memory_order_acquire) <= index)
+			{
+				throw std::bad_alloc();
+			}
+			std::this_thread::yield();
+		}
+	}
+
+	/// @brief Stop publishing at index (keeps the smallest seal)
+	void seal(size_t index) noexcept
+	{
+		size_t sealed = m_sealed_at.load(std::memory_order_relaxed);
+		while (index < sealed &&
+			   !m_sealed_at.compare_exchange_weak(sealed, index, std::memory_order_release, std::memory_order_relaxed))
+		{
+		}
+	}
+
+	const Slot &slot_at(size_t index) const noexcept
+	{
+		size_t segment, offset;
+		locate(index, segment, offset);
+		return m_segments[segment].load(std::memory_order_acquire)[offset];
+	}
+
+	Slot &slot_at(size_t index) noexcept
+	{
+		return const_cast<Slot &>(static_cast<const ConcurrentStore *>(this)->slot_at(index));
+	}
+
+	bool slot_ready(size_t index) const noexcept
+	{
+		size_t segment, offset;
+		locate(index, segment, offset);
+		const Slot *slots = m_segments[segment].load(std::memory_order_acquire);
+		return slots && slots[offset].ready.load(std::memory_order_acquire);
+	}
+
+	void destroy_all() noexcept
+	{
+		const size_t reserved = m_reserved.load(std::memory_order_acquire);
+		for (size_t i = 0; i < reserved; ++i)
+		{
+			if (slot_ready(i))
+			{
+				slot_at(i).value().~T();
+			}
+		}
+		for (auto &segment : m_segments)
+		{
+			delete[] segment.exchange(nullptr, std::memory_order_acq_rel);
+		}
+		m_reserved.store(0, std::memory_order_release);
+		m_published.store(0, std::memory_order_release);
+		m_sealed_at.store(k_open, std::memory_order_release);
+	}
+};
+
+// =======================
+// Static Member Initialization
+// =======================
+template <typename T>
+Errors ConcurrentStore<T>::s_error;
+
+} // namespace adv
@@ -0,0 +1,659 @@
+#pragma once
+#include "advance_store.hpp"
+
+#if !defined(__cpp_impl_coroutine) || __cplusplus < 202002L
+#error "advance_store_coro.hpp requires C++20 coroutines (-std=c++20)"
+#endif
+
+#include <condition_variable>
+#include <coroutine>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <utility>
+
+namespace adv
+{
+
+// =======================
+// Generator
+// =======================
+
+/// @brief Synchronous coroutine generator, usable as an input range
+/// @tparam T Yielded type
+template <typename T>
+class generator
+{
+  public:
+	struct promise_type
+	{
+		std::optional<T> current;
+		std::exception_ptr error;
+
+		generator get_return_object() noexcept
+		{
+			return generator(std::coroutine_handle<promise_type>::from_promise(*this));
+		}
+
+		std::suspend_always initial_suspend() noexcept { return {}; }
+		std::suspend_always final_suspend() noexcept { return {}; }
+
+		template <typename U>
+		std::suspend_always yield_value(U &&value)
+		{
+			current.emplace(std::forward<U>(value));
+			return {};
+		}
+
+		void return_void() noexcept {}
+		void unhandled_exception() noexcept { error = std::current_exception(); }
+	};
+
+	/// @brief Input iterator over yielded values
+	class iterator
+	{
+	  private:
+		std::coroutine_handle<promise_type> m_handle;
+
+	  public:
+		using iterator_category = std::input_iterator_tag;
+		using value_type = T;
+		using difference_type = std::ptrdiff_t;
+		using pointer = T *;
+		using reference = T &;
+
+		iterator() = default;
+		explicit iterator(std::coroutine_handle<promise_type> handle) : m_handle(handle) {}
+
+		reference operator*() const { return *m_handle.promise().current; }
+		pointer operator->() const { return &*m_handle.promise().current; }
+
+		iterator &operator++()
+		{
+			advance(m_handle);
+			if (m_handle.done())
+			{
+				m_handle = nullptr;
+			}
+			return *this;
+		}
+
+		void operator++(int) { ++*this; }
+
+		bool operator==(const iterator &other) const { return m_handle == other.m_handle; }
+		bool operator!=(const iterator &other) const { return m_handle != other.m_handle; }
+	};
+
+	generator(generator &&other) noexcept : m_handle(std::exchange(other.m_handle, nullptr)) {}
+	generator(const generator &) = delete;
+	generator &operator=(const generator &) = delete;
+
+	generator &operator=(generator &&other) noexcept
+	{
+		if (this != &other)
+		{
+			reset();
+			m_handle = std::exchange(other.m_handle, nullptr);
+		}
+		return *this;
+	}
+
+	~generator()
+	{
+		reset();
+	}
+
+	/// @brief Start (or continue) the generator
+	/// @return Iterator to the next value, end() when exhausted
+	/// @throws Any exception thrown by the coroutine body
+	iterator begin()
+	{
+		if (!m_handle)
+		{
+			return end();
+		}
+		advance(m_handle);
+		return m_handle.done() ? end() : iterator(m_handle);
+	}
+
+	iterator end() noexcept
+	{
+		return iterator();
+	}
+
+  private:
+	std::coroutine_handle<promise_type> m_handle;
+
+	explicit generator(std::coroutine_handle<promise_type> handle) : m_handle(handle) {}
+
+	static void advance(std::coroutine_handle<promise_type> handle)
+	{
+		handle.promise().current.reset();
+		handle.resume();
+		if (handle.promise().error)
+		{
+			std::rethrow_exception(std::exchange(handle.promise().error, nullptr));
+		}
+	}
+
+	void reset() noexcept
+	{
+		if (m_handle)
+		{
+			m_handle.destroy();
+			m_handle = nullptr;
+		}
+	}
+};
+
+/// @brief Yield every element of a Store
+/// @tparam T Element type
+/// @param store Source store, must outlive the generator
+/// @return Generator of copies of the elements
+template <typename T>
+generator<T> from_store(const Store<T> &store)
+{
+	for (const auto &value : store)
+	{
+		co_yield value;
+	}
+}
+
+/// @brief Group a generator into Store-sized chunks
+/// @tparam T Element type
+/// @param source Element source
+/// @param chunk_size Elements per chunk (the last chunk may be shorter)
+/// @return Generator of chunks
+template <typename T>
+generator<Store<T>> chunked(generator<T> source, size_t chunk_size)
+{
+	chunk_size = std::max<size_t>(chunk_size, 1);
+	Store<T> chunk;
+	chunk.reserve(chunk_size);
+	for (auto &value : source)
+	{
+		chunk.push_back(std::move(value));
+		if (chunk.size() == chunk_size)
+		{
+			co_yield std::move(chunk);
+			chunk = Store<T>();
+			chunk.reserve(chunk_size);
+		}
+	}
+	if (!chunk.empty())
+	{
+		co_yield std::move(chunk);
+	}
+}
+
+// =======================
+// Scheduler & Task
+// =======================
+
+class Scheduler;
+
+/// @brief Lazily started pipeline coroutine, run by a scheduler
+class Task
+{
+  public:
+	struct promise_type
+	{
+		Scheduler *owner = nullptr;
+
+		Task get_return_object() noexcept
+		{
+			return Task(std::coroutine_handle<promise_type>::from_promise(*this));
+		}
+
+		std::suspend_always initial_suspend() noexcept { return {}; }
+		std::suspend_never final_suspend() noexcept;
+		void return_void() noexcept {}
+		void unhandled_exception() noexcept;
+	};
+
+	Task(Task &&other) noexcept : m_handle(std::exchange(other.m_handle, nullptr)) {}
+	Task(const Task &) = delete;
+	Task &operator=(const Task &) = delete;
+
+	~Task()
+	{
+		if (m_handle)
+		{
+			m_handle.destroy();
+		}
+	}
+
+  private:
+	friend class Scheduler;
+	std::coroutine_handle<promise_type> m_handle;
+
+	explicit Task(std::coroutine_handle<promise_type> handle) : m_handle(handle) {}
+};
+
+/// @brief Runs tasks on the thread calling run()
+/// @details Coroutines suspended on a channel are resumed on the scheduler
+///          they were running on, so stages spawned on schedulers driven by
+///          different threads run in parallel and hand chunks over through
+///          channels.
+class Scheduler
+{
+  private:
+	std::mutex m_mutex;
+	std::condition_variable m_wake;
+	std::deque<std::coroutine_handle<>> m_ready; // Runnable coroutines
+	size_t m_live = 0;							 // Spawned tasks not finished yet
+	std::exception_ptr m_error;					 // First exception escaping a task
+
+	static Scheduler *&current_slot() noexcept
+	{
+		thread_local Scheduler *s_current = nullptr;
+		return s_current;
+	}
+
+  public:
+	Scheduler() = default;
+	Scheduler(const Scheduler &) = delete;
+	Scheduler &operator=(const Scheduler &) = delete;
+
+	/// @brief Get the scheduler running on the calling thread
+	/// @return Scheduler or nullptr outside run()
+	static Scheduler *current() noexcept
+	{
+		return current_slot();
+	}
+
+	/// @brief Take ownership of a task and queue it
+	/// @param work Task to run
+	void spawn(Task work)
+	{
+		auto handle = std::exchange(work.m_handle, nullptr);
+		handle.promise().owner = this;
+		std::lock_guard<std::mutex> lock(m_mutex);
+		++m_live;
+		m_ready.push_back(handle);
+		m_wake.notify_one();
+	}
+
+	/// @brief Queue a suspended coroutine (thread-safe)
+	/// @param handle Coroutine to resume
+	void post(std::coroutine_handle<> handle)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_ready.push_back(handle);
+		m_wake.notify_one();
+	}
+
+	/// @brief Run until every spawned task has finished
+	/// @details A task suspended on a channel nobody will ever serve keeps
+	///          run() waiting; the built-in stages close their channels when
+	///          they stop, so a failing stage unblocks its neighbours.
+	/// @throws The first exception that escaped a task
+	void run()
+	{
+		Scheduler *const previous = std::exchange(current_slot(), this);
+		for (;;)
+		{
+			std::coroutine_handle<> next;
+			{
+				std::unique_lock<std::mutex> lock(m_mutex);
+				m_wake.wait(lock, [&] { return !m_ready.empty() || m_live == 0; });
+				if (m_ready.empty())
+				{
+					break;
+				}
+				next = m_ready.front();
+				m_ready.pop_front();
+			}
+			next.resume();
+		}
+		current_slot() = previous;
+		if (m_error)
+		{
+			std::rethrow_exception(std::exchange(m_error, nullptr));
+		}
+	}
+
+  private:
+	friend class Task;
+
+	void on_done(std::exception_ptr error) noexcept
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (error && !m_error)
+		{
+			m_error = error;
+		}
+		--m_live;
+		m_wake.notify_all();
+	}
+};
+
+inline std::suspend_never Task::promise_type::final_suspend() noexcept
+{
+	if (owner)
+	{
+		owner->on_done(nullptr);
+	}
+	return {};
+}
+
+inline void Task::promise_type::unhandled_exception() noexcept
+{
+	if (owner)
+	{
+		owner->on_done(std::current_exception());
+		owner = nullptr; // final_suspend must not count the task twice
+	}
+}
+
+// =======================
+// Channel
+// =======================
+
+/// @brief Bounded multi-producer multi-consumer channel with backpressure
+/// @details co_await send(v) suspends while the channel is full and
+///          co_await receive() suspends while it is empty. close() wakes every
+///          waiter: pending receives get std::nullopt once drained, sends fail.
+/// @tparam T Element type (typically Store<U> chunks)
+template <typename T>
+class Channel
+{
+  private:
+	struct Waiter
+	{
+		std::coroutine_handle<> handle;
+		Scheduler *owner;
+		T *send_value;				   // Sender: value to hand over
+		std::optional<T> *recv_value;  // Receiver: slot to fill
+		bool *ok;					   // Sender: whether the value was accepted
+	};
+
+	std::mutex m_mutex;
+	std::deque<T> m_buffer;
+	std::deque<Waiter> m_senders;
+	std::deque<Waiter> m_receivers;
+	size_t m_capacity;
+	bool m_closed = false;
+	static Errors s_error; // Error management
+
+	static void wake(const Waiter &waiter)
+	{
+		waiter.owner->post(waiter.handle);
+	}
+
+  public:
+	/// @brief Constructor with capacity
+	/// @param capacity Maximum buffered elements before senders suspend
+	/// @throws std::invalid_argument if capacity is zero
+	explicit Channel(size_t capacity) : m_capacity(capacity)
+	{
+		if (capacity == 0)
+		{
+			s_error.throw_invalid_argument();
+		}
+	}
+
+	Channel(const Channel &) = delete;
+	Channel &operator=(const Channel &) = delete;
+
+	/// @brief Awaitable returned by send()
+	class send_awaiter
+	{
+	  private:
+		Channel &m_channel;
+		T m_value;
+		bool m_ok = false;
+
+	  public:
+		send_awaiter(Channel &ch, T value) : m_channel(ch), m_value(std::move(value)) {}
+
+		bool await_ready() const noexcept { return false; }
+
+		bool await_suspend(std::coroutine_handle<> handle)
+		{
+			std::lock_guard<std::mutex> lock(m_channel.m_mutex);
+			if (m_channel.m_closed)
+			{
+				return false;
+			}
+			m_ok = true;
+			if (!m_channel.m_receivers.empty())
+			{
+				Waiter receiver = m_channel.m_receivers.front();
+				m_channel.m_receivers.pop_front();
+				receiver.recv_value->emplace(std::move(m_value));
+				wake(receiver);
+				return false;
+			}
+			if (m_channel.m_buffer.size() < m_channel.m_capacity)
+			{
+				m_channel.m_buffer.push_back(std::move(m_value));
+				return false;
+			}
+			m_ok = false;
+			m_channel.m_senders.push_back(Waiter{handle, current_or_throw(), &m_value, nullptr, &m_ok});
+			return true;
+		}
+
+		/// @return false if the channel was closed and the value dropped
+		bool await_resume() const noexcept { return m_ok; }
+	};
+
+	/// @brief Awaitable returned by receive()
+	class receive_awaiter
+	{
+	  private:
+		Channel &m_channel;
+		std::optional<T> m_value;
+
+	  public:
+		explicit receive_awaiter(Channel &ch) : m_channel(ch) {}
+
+		bool await_ready() const noexcept { return false; }
+
+		bool await_suspend(std::coroutine_handle<> handle)
+		{
+			std::lock_guard<std::mutex> lock(m_channel.m_mutex);
+			if (!m_channel.m_buffer.empty())
+			{
+				m_value.emplace(std::move(m_channel.m_buffer.front()));
+				m_channel.m_buffer.pop_front();
+				if (!m_channel.m_senders.empty())
+				{
+					// Room was made: move one blocked sender's value in
+					Waiter sender = m_channel.m_senders.front();
+					m_channel.m_senders.pop_front();
+					m_channel.m_buffer.push_back(std::move(*sender.send_value));
+					*sender.ok = true;
+					wake(sender);
+				}
+				return false;
+			}
+			if (!m_channel.m_senders.empty())
+			{
+				Waiter sender = m_channel.m_senders.front();
+				m_channel.m_senders.pop_front();
+				m_value.emplace(std::move(*sender.send_value));
+				*sender.ok = true;
+				wake(sender);
+				return false;
+			}
+			if (m_channel.m_closed)
+			{
+				return false;
+			}
+			m_channel.m_receivers.push_back(Waiter{handle, current_or_throw(), nullptr, &m_value, nullptr});
+			return true;
+		}
+
+		/// @return Next element, std::nullopt once closed and drained
+		std::optional<T> await_resume() { return std::move(m_value); }
+	};
+
+	/// @brief Send a value, suspending while the channel is full
+	/// @param value Value to send
+	/// @return Awaitable yielding false if the channel is closed
+	send_awaiter send(T value)
+	{
+		return send_awaiter(*this, std::move(value));
+	}
+
+	/// @brief Receive a value, suspending while the channel is empty
+	/// @return Awaitable yielding std::optional<T>
+	receive_awaiter receive()
+	{
+		return receive_awaiter(*this);
+	}
+
+	/// @brief Close the channel and wake every waiter
+	void close()
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_closed = true;
+		for (const auto &receiver : m_receivers)
+		{
+			wake(receiver);
+		}
+		for (const auto &sender : m_senders)
+		{
+			wake(sender);
+		}
+		m_receivers.clear();
+		m_senders.clear();
+	}
+
+	/// @brief Get number of buffered elements
+	/// @return Buffered count
+	size_t size()
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		return m_buffer.size();
+	}
+
+  private:
+	static Scheduler *current_or_throw()
+	{
+		Scheduler *owner = Scheduler::current();
+		if (!owner)
+		{
+			s_error.throw_runtime_error();
+		}
+		return owner;
+	}
+};
+
+// =======================
+// Static Member Initialization
+// =======================
+template <typename T>
+Errors Channel<T>::s_error;
+
+// =======================
+// Pipeline Stages
+// =======================
+
+namespace detail
+{
+/// @brief Closes a stage's channels when its coroutine frame goes away
+/// @details Closing the output ends downstream stages; closing the input makes
+///          upstream sends fail, so a stage that stops early or throws
+///          unblocks both neighbours instead of leaving them suspended.
+template <typename In, typename Out>
+struct StageGuard
+{
+	In *in;
+	Out *out;
+
+	~StageGuard()
+	{
+		if (in)
+		{
+			in->close();
+		}
+		if (out)
+		{
+			out->close();
+		}
+	}
+};
+} // namespace detail
+
+/// @brief Source stage: chunk a generator and send the chunks, then close
+/// @tparam T Element type
+/// @param source Element source
+/// @param chunk_size Elements per chunk
+/// @param out Output channel
+/// @return Task to spawn on a scheduler
+template <typename T>
+Task emit_chunks(generator<T> source, size_t chunk_size, Channel<Store<T>> &out)
+{
+	const detail::StageGuard<Channel<Store<T>>, Channel<Store<T>>> guard{nullptr, &out};
+	for (auto &chunk : chunked(std::move(source), chunk_size))
+	{
+		if (!co_await out.send(std::move(chunk)))
+		{
+			break;
+		}
+	}
+}
+
+/// @brief Filter stage: keep matching elements of every chunk
+/// @tparam T Element type
+/// @tparam Pred Predicate type
+/// @param in Input channel
+/// @param pred Predicate function
+/// @param out Output channel, closed when the input is drained
+/// @return Task to spawn on a scheduler
+template <typename T, typename Pred>
+Task filter_chunks(Channel<Store<T>> &in, Pred pred, Channel<Store<T>> &out)
+{
+	const detail::StageGuard<Channel<Store<T>>, Channel<Store<T>>> guard{&in, &out};
+	while (auto chunk = co_await in.receive())
+	{
+		Store<T> kept = chunk->filter(pred);
+		if (!kept.empty() && !co_await out.send(std::move(kept)))
+		{
+			break;
+		}
+	}
+}
+
+/// @brief Transform stage: apply a function to every element of every chunk
+/// @tparam T Element type
+/// @tparam Func Function type
+/// @param in Input channel
+/// @param func Transformation function (T -> T)
+/// @param out Output channel, closed when the input is drained
+/// @return Task to spawn on a scheduler
+template <typename T, typename Func>
+Task transform_chunks(Channel<Store<T>> &in, Func func, Channel<Store<T>> &out)
+{
+	const detail::StageGuard<Channel<Store<T>>, Channel<Store<T>>> guard{&in, &out};
+	while (auto chunk = co_await in.receive())
+	{
+		chunk->transform(func);
+		if (!co_await out.send(std::move(*chunk)))
+		{
+			break;
+		}
+	}
+}
+
+/// @brief Sink stage: call a function with every chunk
+/// @tparam T Element type
+/// @tparam Func Function type
+/// @param in Input channel
+/// @param func Function called with Store<T>& for each chunk
+/// @return Task to spawn on a scheduler
+template <typename T, typename Func>
+Task consume_chunks(Channel<Store<T>> &in, Func func)
+{
+	const detail::StageGuard<Channel<Store<T>>, Channel<Store<T>>> guard{&in, nullptr};
+	while (auto chunk = co_await in.receive())
+	{
+		func(*chunk);
+	}
+}
+
+} // namespace adv
@@ -0,0 +1,746 @@
+#pragma once
+#include "advance_store.hpp"
+#include <atomic>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <random>
+
+namespace adv
+{
+
+// =======================
+// External Codec
+// =======================
+
+/// @brief Serializer used by ExternalStore to write/read spilled runs
+/// @details Specialize for custom types. Built-in support covers
+///          trivially copyable types and std::string.
+template <typename T, typename Enable = void>
+struct ExternalCodec
+{
+	static_assert(std::is_trivially_copyable_v<T>,
+				  "ExternalStore requires a trivially copyable type, std::string, "
+				  "or a specialization of adv::ExternalCodec<T>");
+
+	/// @brief Write one value
+	/// @param out Output stream
+	/// @param value Value to write
+	static void write(std::ostream &out, const T &value)
+	{
+		out.write(reinterpret_cast<const char *>(&value), sizeof(T));
+	}
+
+	/// @brief Read one value
+	/// @param in Input stream
+	/// @param value Destination
+	/// @return true if a value was read, false at end of run
+	static bool read(std::istream &in, T &value)
+	{
+		return static_cast<bool>(in.read(reinterpret_cast<char *>(&value), sizeof(T)));
+	}
+
+	/// @brief Approximate in-memory footprint of one value
+	/// @param value Value to measure
+	/// @return Size in bytes
+	static size_t bytes(const T &) noexcept
+	{
+		return sizeof(T);
+	}
+};
+
+/// @brief Length-prefixed codec for std::string
+template <>
+struct ExternalCodec<string>
+{
+	static void write(std::ostream &out, const string &value)
+	{
+		const uint64_t length = value.size();
+		out.write(reinterpret_cast<const char *>(&length), sizeof(length));
+		out.write(value.data(), static_cast<std::streamsize>(length));
+	}
+
+	static bool read(std::istream &in, string &value)
+	{
+		uint64_t length = 0;
+		if (!in.read(reinterpret_cast<char *>(&length), sizeof(length)))
+		{
+			return false;
+		}
+		value.resize(static_cast<size_t>(length));
+		return length == 0 || static_cast<bool>(in.read(&value[0], static_cast<std::streamsize>(length)));
+	}
+
+	static size_t bytes(const string &value) noexcept
+	{
+		return sizeof(string) + value.capacity();
+	}
+};
+
+// =======================
+// ExternalStore Template Class
+// =======================
+
+/// @brief Out-of-core store that spills sorted runs to disk past a memory budget
+/// @details Appends are buffered in memory. When the buffer exceeds the byte
+///          budget it is sorted and written to a temporary run file. Iteration
+///          always yields elements in sorted order through a k-way merge of the
+///          runs and the in-memory buffer. Merging over disk runs first spills
+///          the buffer and releases it, and the per-run read buffers share the
+///          budget, so memory stays bounded by the budget.
+/// @tparam T Element type (see ExternalCodec)
+/// @tparam Compare Ordering used for runs, sort() and unique()
+template <typename T, typename Compare = std::less<T>>
+class ExternalStore
+{
+  private:
+	using Codec = ExternalCodec<T>;
+
+	vector<T> m_buffer;				   // In-memory (unsorted) tail
+	vector<string> m_runs;			   // Sorted run files on disk
+	size_t m_budget_bytes;			   // Memory budget for buffer + merge I/O
+	size_t m_buffer_bytes = 0;		   // Approximate bytes held by m_buffer
+	size_t m_size = 0;				   // Total number of elements
+	size_t m_max_fan_in = 64;		   // Max runs merged in one pass
+	std::filesystem::path m_temp_dir;  // Where run files are created
+	Compare m_comp;					   // Element ordering
+	static Errors s_error;			   // Error management
+
+	static constexpr size_t k_min_io_buffer = 4096;	   // Smallest read buffer fan-in is reduced for
+	static constexpr size_t k_max_io_buffer = 1 << 20; // Larger buffers stop paying off
+
+	/// @brief Merge source: either a run file or the sorted in-memory buffer
+	struct Source
+	{
+		std::unique_ptr<std::ifstream> file;
+		vector<char> io_buffer;
+		const vector<T> *memory = nullptr;
+		size_t memory_pos = 0;
+
+		bool next(T &out)
+		{
+			if (memory)
+			{
+				if (memory_pos >= memory->size())
+				{
+					return false;
+				}
+				out = (*memory)[memory_pos++];
+				return true;
+			}
+			return Codec::read(*file, out);
+		}
+	};
+
+	/// @brief Streaming k-way merge over a set of sources
+	class Merger
+	{
+	  private:
+		struct Head
+		{
+			T value;
+			size_t source;
+		};
+
+		struct HeadGreater
+		{
+			Compare comp;
+			bool operator()(const Head &a, const Head &b) const
+			{
+				return comp(b.value, a.value);
+			}
+		};
+
+		vector<Source> m_sources;
+		vector<Head> m_heap; // Min-heap of source heads
+		HeadGreater m_greater;
+		Compare m_comp;
+		bool m_dedupe;
+		bool m_has_last = false;
+		T m_last{};
+
+	  public:
+		Merger(vector<Source> sources, Compare comp, bool dedupe)
+			: m_sources(std::move(sources)), m_greater{comp}, m_comp(comp), m_dedupe(dedupe)
+		{
+			m_heap.reserve(m_sources.size());
+			for (size_t i = 0; i < m_sources.size(); ++i)
+			{
+				T value;
+				if (m_sources[i].next(value))
+				{
+					m_heap.push_back(Head{std::move(value), i});
+				}
+			}
+			std::make_heap(m_heap.begin(), m_heap.end(), m_greater);
+		}
+
+		/// @brief Pop the next element in merged order
+		/// @param out Destination
+		/// @return false when all sources are exhausted
+		bool next(T &out)
+		{
+			while (!m_heap.empty())
+			{
+				std::pop_heap(m_heap.begin(), m_heap.end(), m_greater);
+				Head head = std::move(m_heap.back());
+				m_heap.pop_back();
+
+				T value;
+				if (m_sources[head.source].next(value))
+				{
+					m_heap.push_back(Head{std::move(value), head.source});
+					std::push_heap(m_heap.begin(), m_heap.end(), m_greater);
+				}
+
+				if (m_dedupe && m_has_last && !m_comp(m_last, head.value) && !m_comp(head.value, m_last))
+				{
+					continue;
+				}
+				if (m_dedupe)
+				{
+					m_last = head.value;
+					m_has_last = true;
+				}
+				out = std::move(head.value);
+				return true;
+			}
+			return false;
+		}
+	};
+
+  public:
+	/// @brief Input iterator streaming elements in sorted order
+	class const_iterator
+	{
+	  private:
+		std::shared_ptr<Merger> m_merger;
+		T m_current{};
+
+	  public:
+		using iterator_category = std::input_iterator_tag;
+		using value_type = T;
+		using difference_type = std::ptrdiff_t;
+		using pointer = const T *;
+		using reference = const T &;
+
+		const_iterator() = default;
+
+		explicit const_iterator(std::shared_ptr<Merger> merger) : m_merger(std::move(merger))
+		{
+			++*this;
+		}
+
+		reference operator*() const { return m_current; }
+		pointer operator->() const { return &m_current; }
+
+		const_iterator &operator++()
+		{
+			if (m_merger && !m_merger->next(m_current))
+			{
+				m_merger.reset();
+			}
+			return *this;
+		}
+
+		bool operator==(const const_iterator &other) const { return m_merger == other.m_merger; }
+		bool operator!=(const const_iterator &other) const { return m_merger != other.m_merger; }
+	};
+
+	// =======================
+	// Constructors & Destructor
+	// =======================
+
+	/// @brief Constructor with memory budget
+	/// @param budget_bytes Maximum bytes kept in memory before spilling (default 64 MiB)
+	/// @param temp_dir Directory for run files (default: system temp directory)
+	/// @throws std::invalid_argument if budget is zero
+	explicit ExternalStore(size_t budget_bytes = size_t(64) << 20,
+						   const std::filesystem::path &temp_dir = std::filesystem::temp_directory_path(),
+						   Compare comp = Compare())
+		: m_budget_bytes(budget_bytes), m_temp_dir(temp_dir), m_comp(comp)
+	{
+		if (m_budget_bytes == 0)
+		{
+			s_error.throw_invalid_argument();
+		}
+	}
+
+	ExternalStore(const ExternalStore &) = delete;
+	ExternalStore &operator=(const ExternalStore &) = delete;
+
+	/// @brief Move constructor, takes ownership of the run files
+	ExternalStore(ExternalStore &&other) noexcept
+		: m_buffer(std::move(other.m_buffer)), m_runs(std::move(other.m_runs)),
+		  m_budget_bytes(other.m_budget_bytes), m_buffer_bytes(other.m_buffer_bytes),
+		  m_size(other.m_size), m_max_fan_in(other.m_max_fan_in),
+		  m_temp_dir(std::move(other.m_temp_dir)), m_comp(std::move(other.m_comp))
+	{
+		other.m_runs.clear();
+		other.m_buffer_bytes = 0;
+		other.m_size = 0;
+	}
+
+	/// @brief Destructor, removes all run files
+	~ExternalStore()
+	{
+		remove_runs();
+	}
+
+	// =======================
+	// Capacity
+	// =======================
+
+	/// @brief Get total number of elements (memory + disk)
+	/// @return Number of elements
+	size_t size() const noexcept
+	{
+		return m_size;
+	}
+
+	/// @brief Check if store is empty
+	/// @return true if store is empty, false otherwise
+	bool empty() const noexcept
+	{
+		return m_size == 0;
+	}
+
+	/// @brief Get number of sorted runs currently on disk
+	/// @return Run count
+	size_t run_count() const noexcept
+	{
+		return m_runs.size();
+	}
+
+	/// @brief Get approximate bytes held by the in-memory buffer
+	/// @return Buffered bytes
+	size_t buffered_bytes() const noexcept
+	{
+		return m_buffer_bytes;
+	}
+
+	/// @brief Get memory budget
+	/// @return Budget in bytes
+	size_t memory_budget() const noexcept
+	{
+		return m_budget_bytes;
+	}
+
+	/// @brief Set memory budget, spilling immediately if already exceeded
+	/// @param budget_bytes New budget in bytes
+	/// @throws std::invalid_argument if budget is zero
+	void set_memory_budget(size_t budget_bytes)
+	{
+		if (budget_bytes == 0)
+		{
+			s_error.throw_invalid_argument();
+		}
+		m_budget_bytes = budget_bytes;
+		if (m_buffer_bytes > m_budget_bytes)
+		{
+			spill();
+		}
+		if (m_buffer.capacity() > buffer_limit())
+		{
+			m_buffer.shrink_to_fit();
+		}
+	}
+
+	/// @brief Set maximum number of runs merged in a single pass
+	/// @param fan_in Fan-in, at least 2
+	/// @throws std::invalid_argument if fan_in is less than 2
+	void set_max_fan_in(size_t fan_in)
+	{
+		if (fan_in < 2)
+		{
+			s_error.throw_invalid_argument();
+		}
+		m_max_fan_in = fan_in;
+	}
+
+	// =======================
+	// Adding Elements
+	// =======================
+
+	/// @brief Add value
+	/// @param value Value to add
+	void push_back(const T &value)
+	{
+		reserve_slot();
+		m_buffer.push_back(value);
+		account_last();
+	}
+
+	/// @brief Add moved value
+	/// @param value Value to move
+	void push_back(T &&value)
+	{
+		reserve_slot();
+		m_buffer.push_back(std::move(value));
+		account_last();
+	}
+
+	/// @brief Add all elements of a container
+	/// @tparam Container Container type
+	/// @param container Container to add
+	template <typename Container>
+	void push_back(const Container &container)
+	{
+		for (const auto &value : container)
+		{
+			push_back(value);
+		}
+	}
+
+	/// @brief Emplace element
+	/// @tparam Args Argument types
+	/// @param args Arguments to construct element
+	template <typename... Args>
+	void emplace_back(Args &&... args)
+	{
+		reserve_slot();
+		m_buffer.emplace_back(std::forward<Args>(args)...);
+		account_last();
+	}
+
+	/// @brief Remove all elements and run files
+	void clear()
+	{
+		remove_runs();
+		m_buffer.clear();
+		m_buffer.shrink_to_fit();
+		m_buffer_bytes = 0;
+		m_size = 0;
+	}
+
+	// =======================
+	// Sorting
+	// =======================
+
+	/// @brief Consolidate everything into a single sorted run on disk
+	/// @details Uses multi-pass merging when there are more runs than the fan-in
+	///          (see set_max_fan_in(), further limited so every read buffer
+	///          gets at least 4 KiB of the budget when the budget allows it).
+	///          Iteration is always sorted; sort() bounds the number of files
+	///          opened by later iterations to one.
+	void sort()
+	{
+		consolidate(false);
+	}
+
+	/// @brief Sort and remove duplicate elements
+	/// @details Two elements are duplicates when neither compares less than the other.
+	void unique()
+	{
+		consolidate(true);
+	}
+
+	/// @brief Force the in-memory buffer to disk as a sorted run
+	void spill()
+	{
+		if (m_buffer.empty())
+		{
+			return;
+		}
+		std::sort(m_buffer.begin(), m_buffer.end(), m_comp);
+		const string path = new_run_path();
+		{
+			vector<char> no_buffer;
+			std::ofstream out = open_output(path, no_buffer);
+			for (const auto &value : m_buffer)
+			{
+				Codec::write(out, value);
+			}
+			finish_output(out, path);
+		}
+		m_runs.push_back(path);
+		m_buffer.clear(); // Keep capacity, the next run refills it
+		m_buffer_bytes = 0;
+	}
+
+	// =======================
+	// Iteration
+	// =======================
+
+	/// @brief Begin streaming iteration in sorted order
+	/// @details Sorts the in-memory buffer, or spills it when runs exist on disk.
+	///          Appending while iterating is undefined.
+	/// @return Input iterator to first element
+	const_iterator begin()
+	{
+		if (m_size == 0)
+		{
+			return end();
+		}
+		return const_iterator(make_merger(false));
+	}
+
+	/// @brief End sentinel
+	/// @return Past-the-end iterator
+	const_iterator end() const
+	{
+		return const_iterator();
+	}
+
+	/// @brief Visit every element in sorted order
+	/// @tparam Func Function type
+	/// @param func Function called with each element
+	template <typename Func>
+	void for_each(Func func)
+	{
+		if (m_size == 0)
+		{
+			return;
+		}
+		auto merger = make_merger(false);
+		T value;
+		while (merger->next(value))
+		{
+			func(value);
+		}
+	}
+
+	/// @brief Load all elements into an in-memory Store in sorted order
+	/// @return Store with every element
+	Store<T> to_store()
+	{
+		Store<T> result;
+		result.reserve(m_size);
+		for_each([&](const T &value) { result.push_back(value); });
+		return result;
+	}
+
+  private:
+	/// @brief Most elements the buffer may reserve without exceeding the budget
+	size_t buffer_limit() const noexcept
+	{
+		return std::max<size_t>(m_budget_bytes / sizeof(T), 1);
+	}
+
+	/// @brief Make room for one more element without overshooting the budget
+	/// @details Growth stays geometric but is capped at buffer_limit(), so the
+	///          reserved (not just used) buffer never exceeds the budget. A full
+	///          buffer at the cap is spilled instead of reallocated.
+	void reserve_slot()
+	{
+		if (m_buffer.size() < m_buffer.capacity())
+		{
+			return;
+		}
+		const size_t limit = buffer_limit();
+		if (m_buffer.size() >= limit)
+		{
+			spill();
+			if (m_buffer.capacity() != 0)
+			{
+				return;
+			}
+		}
+		m_buffer.reserve(std::min(std::max<size_t>(m_buffer.capacity() * 2, 16), limit));
+	}
+
+	void account_last()
+	{
+		m_buffer_bytes += Codec::bytes(m_buffer.back());
+		++m_size;
+		// Reserved but unused slots count too, the allocation holds them
+		if (m_buffer_bytes + (m_buffer.capacity() - m_buffer.size()) * sizeof(T) > m_budget_bytes)
+		{
+			spill();
+		}
+	}
+
+	string new_run_path() const
+	{
+		static std::atomic<unsigned long long> s_counter{0};
+		static const unsigned long long s_salt = std::random_device{}();
+		const auto id = s_counter.fetch_add(1, std::memory_order_relaxed);
+		return (m_temp_dir / ("adv_store_" + std::to_string(s_salt) + "_" + std::to_string(id) + ".run")).string();
+	}
+
+	/// @brief Open a run file for writing
+	/// @param buffer Write buffer to use, the stream's default when empty
+	std::ofstream open_output(const string &path, vector<char> &buffer) const
+	{
+		std::ofstream out;
+		if (!buffer.empty())
+		{
+			out.rdbuf()->pubsetbuf(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+		}
+		out.open(path, std::ios::binary | std::ios::trunc);
+		if (!out)
+		{
+			s_error.throw_runtime_error();
+		}
+		return out;
+	}
+
+	void finish_output(std::ofstream &out, const string &path) const
+	{
+		out.flush();
+		if (!out)
+		{
+			out.close();
+			std::remove(path.c_str());
+			s_error.throw_runtime_error();
+		}
+	}
+
+	/// @brief Per-source read buffer size so all sources fit the budget together
+	size_t io_buffer_size(size_t sources) const noexcept
+	{
+		return std::max<size_t>(1, std::min(m_budget_bytes / sources, k_max_io_buffer));
+	}
+
+	/// @brief Runs merged per pass, so each read buffer stays reasonably large
+	size_t merge_fan_in() const noexcept
+	{
+		return std::max<size_t>(2, std::min(m_max_fan_in, m_budget_bytes / k_min_io_buffer));
+	}
+
+	/// @brief Spill the buffer and free its storage before a disk merge
+	/// @details The read buffers of the merge take the whole budget.
+	void release_buffer()
+	{
+		spill();
+		vector<T>().swap(m_buffer);
+	}
+
+	Source open_run(const string &path, size_t buffer_size) const
+	{
+		Source source;
+		source.io_buffer.resize(buffer_size);
+		source.file = std::make_unique<std::ifstream>();
+		source.file->rdbuf()->pubsetbuf(source.io_buffer.data(), static_cast<std::streamsize>(buffer_size));
+		source.file->open(path, std::ios::binary);
+		if (!*source.file)
+		{
+			s_error.throw_runtime_error();
+		}
+		return source;
+	}
+
+	/// @brief Merge groups of runs until at most max_runs remain on disk
+	void reduce_runs(size_t max_runs, bool dedupe)
+	{
+		while (m_runs.size() > max_runs)
+		{
+			const size_t group = std::min(merge_fan_in(), m_runs.size() - max_runs + 1);
+			vector<string> inputs(m_runs.begin(), m_runs.begin() + group);
+			vector<Source> sources;
+			const size_t buffer_size = io_buffer_size(group + 1); // Inputs and the output
+			for (const auto &path : inputs)
+			{
+				sources.push_back(open_run(path, buffer_size));
+			}
+
+			const string path = new_run_path();
+			{
+				Merger merger(std::move(sources), m_comp, dedupe);
+				vector<char> out_buffer(buffer_size);
+				std::ofstream out = open_output(path, out_buffer);
+				T value;
+				while (merger.next(value))
+				{
+					Codec::write(out, value);
+				}
+				finish_output(out, path);
+			}
+
+			for (const auto &input : inputs)
+			{
+				std::remove(input.c_str());
+			}
+			m_runs.erase(m_runs.begin(), m_runs.begin() + group);
+			m_runs.push_back(path);
+		}
+	}
+
+	std::shared_ptr<Merger> make_merger(bool dedupe)
+	{
+		if (m_runs.empty())
+		{
+			// Everything fits in memory, no read buffers needed
+			std::sort(m_buffer.begin(), m_buffer.end(), m_comp);
+			Source memory;
+			memory.memory = &m_buffer;
+			vector<Source> sources;
+			sources.push_back(std::move(memory));
+			return std::make_shared<Merger>(std::move(sources), m_comp, dedupe);
+		}
+
+		release_buffer();
+		reduce_runs(merge_fan_in(), false);
+		vector<Source> sources;
+		const size_t buffer_size = io_buffer_size(m_runs.size());
+		for (const auto &path : m_runs)
+		{
+			sources.push_back(open_run(path, buffer_size));
+		}
+		return std::make_shared<Merger>(std::move(sources), m_comp, dedupe);
+	}
+
+	void consolidate(bool dedupe)
+	{
+		if (m_size == 0)
+		{
+			return;
+		}
+		release_buffer();
+		reduce_runs(merge_fan_in(), dedupe);
+		if (m_runs.size() > 1 || dedupe)
+		{
+			// Final pass always runs for dedupe so that it covers every run
+			merge_all(dedupe);
+		}
+	}
+
+	/// @brief Merge every run (at most fan-in) into one run
+	void merge_all(bool dedupe)
+	{
+		vector<Source> sources;
+		const size_t buffer_size = io_buffer_size(m_runs.size() + 1); // Inputs and the output
+		for (const auto &path : m_runs)
+		{
+			sources.push_back(open_run(path, buffer_size));
+		}
+
+		const string path = new_run_path();
+		size_t written = 0;
+		{
+			Merger merger(std::move(sources), m_comp, dedupe);
+			vector<char> out_buffer(buffer_size);
+			std::ofstream out = open_output(path, out_buffer);
+			T value;
+			while (merger.next(value))
+			{
+				Codec::write(out, value);
+				++written;
+			}
+			finish_output(out, path);
+		}
+
+		remove_runs();
+		m_runs.push_back(path);
+		m_size = written;
+	}
+
+	void remove_runs() noexcept
+	{
+		for (const auto &path : m_runs)
+		{
+			std::remove(path.c_str());
+		}
+		m_runs.clear();
+	}
+};
+
+// =======================
+// Static Member Initialization
+// =======================
+template <typename T, typename Compare>
+Errors ExternalStore<T, Compare>::s_error;
+
+} // namespace adv
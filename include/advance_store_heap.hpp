@@ -0,0 +1,582 @@
+#pragma once
+#include "advance_store.hpp"
+#include <functional>
+#include <limits>
+#include <utility>
+
+namespace adv
+{
+
+// =======================
+// Heap Kernels
+// =======================
+
+namespace detail
+{
+/// @brief No-op position callback for heaps without a position index
+struct NoHeapMove
+{
+	void operator()(size_t) const noexcept {}
+};
+
+/// @brief Move the element at pos towards the root while it beats its parent
+/// @details moved(i) is called for every slot that receives a new element.
+template <size_t Arity, typename T, typename Compare, typename Moved>
+void sift_up(T *heap, size_t pos, Compare &comp, Moved moved)
+{
+	T value = std::move(heap[pos]);
+	while (pos > 0)
+	{
+		const size_t parent = (pos - 1) / Arity;
+		if (!comp(heap[parent], value))
+		{
+			break;
+		}
+		heap[pos] = std::move(heap[parent]);
+		moved(pos);
+		pos = parent;
+	}
+	heap[pos] = std::move(value);
+	moved(pos);
+}
+
+/// @brief Move the element at pos towards the leaves while a child beats it
+/// @details The children of a node are adjacent, so with Arity 4 or 8 one
+///          level usually reads a single cache line.
+template <size_t Arity, typename T, typename Compare, typename Moved>
+void sift_down(T *heap, size_t size, size_t pos, Compare &comp, Moved moved)
+{
+	T value = std::move(heap[pos]);
+	while (true)
+	{
+		const size_t first = pos * Arity + 1;
+		if (first >= size)
+		{
+			break;
+		}
+		const size_t last = std::min(first + Arity, size);
+		size_t best = first;
+		for (size_t child = first + 1; child < last; ++child)
+		{
+			if (comp(heap[best], heap[child]))
+			{
+				best = child;
+			}
+		}
+		if (!comp(value, heap[best]))
+		{
+			break;
+		}
+		heap[pos] = std::move(heap[best]);
+		moved(pos);
+		pos = best;
+	}
+	heap[pos] = std::move(value);
+	moved(pos);
+}
+
+/// @brief Floyd's bottom-up heap construction, O(n)
+template <size_t Arity, typename T, typename Compare, typename Moved>
+void build_heap(T *heap, size_t size, Compare &comp, Moved moved)
+{
+	if (size < 2)
+	{
+		return;
+	}
+	for (size_t pos = (size - 2) / Arity + 1; pos-- > 0;)
+	{
+		sift_down<Arity>(heap, size, pos, comp, moved);
+	}
+}
+} // namespace detail
+
+// =======================
+// Heap Operations on Store
+// =======================
+// Same conventions as std::make_heap: with the default std::less the top is
+// the largest element, pass std::greater for a min-heap. Arity selects a
+// d-ary layout and must match across calls on the same store.
+
+/// @brief Rearrange a store into a heap, O(n)
+/// @tparam Arity Children per node (default 2)
+/// @tparam T Element type
+/// @tparam Alloc Allocator type
+/// @tparam Compare Comparator type
+/// @param store Store to rearrange
+/// @param comp Ordering (default std::less, max-heap)
+template <size_t Arity = 2, typename T, typename Alloc, typename Compare = std::less<T>>
+void make_heap(Store<T, Alloc> &store, Compare comp = Compare())
+{
+	static_assert(Arity >= 2, "heap arity must be at least 2");
+	detail::build_heap<Arity>(store.data(), store.size(), comp, detail::NoHeapMove());
+	store.mark_modified();
+}
+
+/// @brief Check if a store is a heap
+/// @tparam Arity Children per node (default 2)
+/// @param store Store to check
+/// @param comp Ordering (default std::less, max-heap)
+/// @return true if no element beats its parent
+template <size_t Arity = 2, typename T, typename Alloc, typename Compare = std::less<T>>
+bool is_heap(const Store<T, Alloc> &store, Compare comp = Compare())
+{
+	static_assert(Arity >= 2, "heap arity must be at least 2");
+	const T *heap = store.data();
+	for (size_t pos = 1; pos < store.size(); ++pos)
+	{
+		if (comp(heap[(pos - 1) / Arity], heap[pos]))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+/// @brief Add an element to a heap, O(log n)
+/// @tparam Arity Children per node (default 2)
+/// @param store Store holding a heap
+/// @param value Value to add
+/// @param comp Ordering (default std::less, max-heap)
+template <size_t Arity = 2, typename T, typename Alloc, typename U, typename Compare = std::less<T>>
+void heap_push(Store<T, Alloc> &store, U &&value, Compare comp = Compare())
+{
+	static_assert(Arity >= 2, "heap arity must be at least 2");
+	store.push_back(std::forward<U>(value));
+	detail::sift_up<Arity>(store.data(), store.size() - 1, comp, detail::NoHeapMove());
+	store.mark_modified();
+}
+
+/// @brief Get the top of a heap
+/// @param store Store holding a heap
+/// @return Const reference to the first element
+/// @throws std::out_of_range if store is empty
+template <typename T, typename Alloc>
+const T &heap_top(const Store<T, Alloc> &store)
+{
+	if (store.empty())
+	{
+		Errors().throw_out_of_range();
+	}
+	return store.data()[0];
+}
+
+/// @brief Remove and return the top of a heap, O(Arity log n)
+/// @tparam Arity Children per node (default 2)
+/// @param store Store holding a heap
+/// @param comp Ordering (default std::less, max-heap)
+/// @return Removed element
+/// @throws std::out_of_range if store is empty
+template <size_t Arity = 2, typename T, typename Alloc, typename Compare = std::less<T>>
+T heap_pop(Store<T, Alloc> &store, Compare comp = Compare())
+{
+	static_assert(Arity >= 2, "heap arity must be at least 2");
+	if (store.empty())
+	{
+		Errors().throw_out_of_range();
+	}
+	T *heap = store.data();
+	const size_t last = store.size() - 1;
+	std::swap(heap[0], heap[last]);
+	T top = std::move(heap[last]);
+	store.pop_back();
+	if (last > 1)
+	{
+		detail::sift_down<Arity>(store.data(), last, 0, comp, detail::NoHeapMove());
+		store.mark_modified();
+	}
+	return top;
+}
+
+// =======================
+// HeapStore Template Class
+// =======================
+
+/// @brief Priority queue kept as a d-ary heap in a Store
+/// @details top() is O(1), push O(log n), pop O(Arity log n). A 4-ary heap
+///          halves the depth of a binary one and keeps siblings on one cache
+///          line, which usually makes pops faster for small T.
+/// @tparam T Element type
+/// @tparam Compare Ordering (default std::less, largest on top)
+/// @tparam Arity Children per node (default 4)
+template <typename T, typename Compare = std::less<T>, size_t Arity = 4>
+class HeapStore
+{
+	static_assert(Arity >= 2, "heap arity must be at least 2");
+
+  private:
+	Store<T> m_data; // Heap-ordered elements
+	Compare m_comp;
+
+  public:
+	// =======================
+	// Constructors & Destructor
+	// =======================
+
+	/// @brief Constructor with comparator
+	/// @param comp Ordering
+	explicit HeapStore(Compare comp = Compare()) : m_comp(std::move(comp)) {}
+
+	/// @brief Constructor from a store, heapified in O(n)
+	/// @param data Elements in any order
+	/// @param comp Ordering
+	explicit HeapStore(Store<T> data, Compare comp = Compare()) : m_data(std::move(data)), m_comp(std::move(comp))
+	{
+		make_heap<Arity>(m_data, m_comp);
+	}
+
+	/// @brief Constructor with initializer list
+	/// @param list Elements in any order
+	HeapStore(initializer_list<T> list) : HeapStore(Store<T>(list)) {}
+
+	// =======================
+	// Capacity
+	// =======================
+
+	/// @brief Get number of elements
+	/// @return Number of elements
+	size_t size() const noexcept
+	{
+		return m_data.size();
+	}
+
+	/// @brief Check if heap is empty
+	/// @return true if empty
+	bool empty() const noexcept
+	{
+		return m_data.empty();
+	}
+
+	/// @brief Reserve capacity
+	/// @param capacity New capacity to reserve
+	void reserve(size_t capacity)
+	{
+		m_data.reserve(capacity);
+	}
+
+	/// @brief Remove all elements
+	void clear() noexcept
+	{
+		m_data.clear();
+	}
+
+	// =======================
+	// Heap Operations
+	// =======================
+
+	/// @brief Get the top element
+	/// @return Const reference to the element that beats all others
+	/// @throws std::out_of_range if heap is empty
+	const T &top() const
+	{
+		return heap_top(m_data);
+	}
+
+	/// @brief Add an element
+	/// @param value Value to add
+	void push(const T &value)
+	{
+		heap_push<Arity>(m_data, value, m_comp);
+	}
+
+	/// @brief Add a moved element
+	/// @param value Value to move
+	void push(T &&value)
+	{
+		heap_push<Arity>(m_data, std::move(value), m_comp);
+	}
+
+	/// @brief Construct an element in place
+	/// @tparam Args Argument types
+	/// @param args Arguments to construct element
+	template <typename... Args>
+	void emplace(Args &&... args)
+	{
+		m_data.emplace_back(std::forward<Args>(args)...);
+		detail::sift_up<Arity>(m_data.data(), m_data.size() - 1, m_comp, detail::NoHeapMove());
+		m_data.mark_modified();
+	}
+
+	/// @brief Remove and return the top element
+	/// @return Removed element
+	/// @throws std::out_of_range if heap is empty
+	T pop()
+	{
+		return heap_pop<Arity>(m_data, m_comp);
+	}
+
+	/// @brief Get the underlying store, in heap order
+	/// @return Const reference to the store
+	const Store<T> &store() const noexcept
+	{
+		return m_data;
+	}
+
+	/// @brief Remove all elements in priority order
+	/// @return Store with the top element first
+	Store<T> drain()
+	{
+		Store<T> result;
+		result.reserve(m_data.size());
+		while (!m_data.empty())
+		{
+			result.push_back(pop());
+		}
+		return result;
+	}
+};
+
+// =======================
+// IndexedHeap Template Class
+// =======================
+
+/// @brief Addressable d-ary heap of (key, priority) for decrease-key workloads
+/// @details Keys are dense integers (e.g. vertex ids) and index a position
+///          table, so contains/priority are O(1) and update/remove
+///          O(Arity log n). Priorities live in the heap next to their key so
+///          sifting never chases the table. For Dijkstra use std::greater:
+///          improve(v, dist) then lowers v's distance if it is shorter.
+/// @tparam T Priority type
+/// @tparam Compare Ordering (default std::less, largest priority on top)
+/// @tparam Arity Children per node (default 4)
+template <typename T, typename Compare = std::less<T>, size_t Arity = 4>
+class IndexedHeap
+{
+	static_assert(Arity >= 2, "heap arity must be at least 2");
+
+  public:
+	/// @brief Position of a key that is not in the heap
+	static constexpr size_t npos = std::numeric_limits<size_t>::max();
+
+  private:
+	struct Entry
+	{
+		T priority;
+		size_t key;
+	};
+
+	vector<Entry> m_heap;	// Heap-ordered entries
+	vector<size_t> m_pos;	// key -> index in m_heap, npos if absent
+	Compare m_comp;
+	static Errors s_error; // Error management
+
+	auto entry_comp()
+	{
+		return [this](const Entry &a, const Entry &b) { return m_comp(a.priority, b.priority); };
+	}
+
+	auto track()
+	{
+		return [this](size_t index) { m_pos[m_heap[index].key] = index; };
+	}
+
+	void check_key(size_t key) const
+	{
+		if (!contains(key))
+		{
+			s_error.throw_out_of_range();
+		}
+	}
+
+	void fix(size_t index)
+	{
+		auto comp = entry_comp();
+		if (index > 0 && comp(m_heap[(index - 1) / Arity], m_heap[index]))
+		{
+			detail::sift_up<Arity>(m_heap.data(), index, comp, track());
+		}
+		else
+		{
+			detail::sift_down<Arity>(m_heap.data(), m_heap.size(), index, comp, track());
+		}
+	}
+
+	void erase_at(size_t index)
+	{
+		m_pos[m_heap[index].key] = npos;
+		const size_t last = m_heap.size() - 1;
+		if (index != last)
+		{
+			m_heap[index] = std::move(m_heap[last]);
+			m_pos[m_heap[index].key] = index;
+		}
+		m_heap.pop_back();
+		if (index < m_heap.size())
+		{
+			fix(index);
+		}
+	}
+
+  public:
+	// =======================
+	// Constructors & Destructor
+	// =======================
+
+	/// @brief Constructor with key range
+	/// @param key_count Keys expected in [0, key_count), grows on demand
+	/// @param comp Ordering
+	explicit IndexedHeap(size_t key_count = 0, Compare comp = Compare())
+		: m_pos(key_count, npos), m_comp(std::move(comp))
+	{
+	}
+
+	// =======================
+	// Capacity
+	// =======================
+
+	/// @brief Get number of keys in the heap
+	/// @return Number of keys
+	size_t size() const noexcept
+	{
+		return m_heap.size();
+	}
+
+	/// @brief Check if heap is empty
+	/// @return true if empty
+	bool empty() const noexcept
+	{
+		return m_heap.empty();
+	}
+
+	/// @brief Remove all keys, O(size)
+	void clear() noexcept
+	{
+		for (const auto &entry : m_heap)
+		{
+			m_pos[entry.key] = npos;
+		}
+		m_heap.clear();
+	}
+
+	// =======================
+	// Search & Check
+	// =======================
+
+	/// @brief Check if a key is in the heap
+	/// @param key Key to look up
+	/// @return true if present
+	bool contains(size_t key) const noexcept
+	{
+		return key < m_pos.size() && m_pos[key] != npos;
+	}
+
+	/// @brief Get the priority of a key
+	/// @param key Key in the heap
+	/// @return Const reference to its priority
+	/// @throws std::out_of_range if key is not in the heap
+	const T &priority(size_t key) const
+	{
+		check_key(key);
+		return m_heap[m_pos[key]].priority;
+	}
+
+	/// @brief Get the key on top
+	/// @return Key whose priority beats all others
+	/// @throws std::out_of_range if heap is empty
+	size_t top_key() const
+	{
+		if (m_heap.empty())
+		{
+			s_error.throw_out_of_range();
+		}
+		return m_heap.front().key;
+	}
+
+	/// @brief Get the priority on top
+	/// @return Const reference to the winning priority
+	/// @throws std::out_of_range if heap is empty
+	const T &top_priority() const
+	{
+		if (m_heap.empty())
+		{
+			s_error.throw_out_of_range();
+		}
+		return m_heap.front().priority;
+	}
+
+	// =======================
+	// Heap Operations
+	// =======================
+
+	/// @brief Add a key
+	/// @param key Key not yet in the heap
+	/// @param priority Its priority
+	/// @throws std::invalid_argument if key is already in the heap
+	void push(size_t key, T priority)
+	{
+		if (contains(key))
+		{
+			s_error.throw_invalid_argument();
+		}
+		if (key >= m_pos.size())
+		{
+			m_pos.resize(key + 1, npos);
+		}
+		m_heap.push_back(Entry{std::move(priority), key});
+		auto comp = entry_comp();
+		detail::sift_up<Arity>(m_heap.data(), m_heap.size() - 1, comp, track());
+	}
+
+	/// @brief Change the priority of a key, in either direction
+	/// @param key Key in the heap
+	/// @param priority New priority
+	/// @throws std::out_of_range if key is not in the heap
+	void update(size_t key, T priority)
+	{
+		check_key(key);
+		const size_t index = m_pos[key];
+		m_heap[index].priority = std::move(priority);
+		fix(index);
+	}
+
+	/// @brief Push a key or move it towards the top if priority beats its current one
+	/// @details This is the relaxation step of Dijkstra/Prim (decrease-key
+	///          with std::greater). A worse priority leaves the key untouched.
+	/// @param key Key to add or improve
+	/// @param priority Candidate priority
+	/// @return true if the key was added or its priority changed
+	bool improve(size_t key, T priority)
+	{
+		if (!contains(key))
+		{
+			push(key, std::move(priority));
+			return true;
+		}
+		const size_t index = m_pos[key];
+		if (!m_comp(m_heap[index].priority, priority))
+		{
+			return false;
+		}
+		m_heap[index].priority = std::move(priority);
+		auto comp = entry_comp();
+		detail::sift_up<Arity>(m_heap.data(), index, comp, track());
+		return true;
+	}
+
+	/// @brief Remove and return the top key with its priority
+	/// @return (key, priority)
+	/// @throws std::out_of_range if heap is empty
+	std::pair<size_t, T> pop()
+	{
+		if (m_heap.empty())
+		{
+			s_error.throw_out_of_range();
+		}
+		std::pair<size_t, T> top(m_heap.front().key, std::move(m_heap.front().priority));
+		erase_at(0);
+		return top;
+	}
+
+	/// @brief Remove a key
+	/// @param key Key in the heap
+	/// @throws std::out_of_range if key is not in the heap
+	void remove(size_t key)
+	{
+		check_key(key);
+		erase_at(m_pos[key]);
+	}
+};
+
+template <typename T, typename Compare, size_t Arity>
+Errors IndexedHeap<T, Compare, Arity>::s_error;
+
+} // namespace adv
@@ -0,0 +1,797 @@
+#pragma once
+#include "advance_store.hpp"
+#include <iterator>
+#include <memory>
+#include <utility>
+
+namespace adv
+{
+
+// =======================
+// IndexedStore Template Class
+// =======================
+
+/// @brief Sequence backed by a counted B+tree for positional edits
+/// @details Elements live in leaves of up to leaf_capacity contiguous items
+///          chained for iteration; internal nodes keep the element count of
+///          each child. at, insert and remove_at descend by counts in
+///          O(log n) and shift at most one leaf, instead of moving the whole
+///          tail as Store does. Sequential scans stay within contiguous
+///          leaves. Iterators are bidirectional and invalidated by edits.
+/// @tparam T Element type
+template <typename T>
+class IndexedStore
+{
+  public:
+	/// @brief Maximum elements per leaf (about 1 KiB of T)
+	static constexpr size_t leaf_capacity = std::max<size_t>(8, 1024 / sizeof(T));
+
+	/// @brief Maximum children per internal node
+	static constexpr size_t fanout = 64;
+
+  private:
+	struct Node
+	{
+		explicit Node(bool is_leaf) noexcept : leaf(is_leaf) {}
+		virtual ~Node() = default;
+		const bool leaf;
+	};
+
+	struct Leaf : Node
+	{
+		Leaf() : Node(true)
+		{
+			items.reserve(leaf_capacity + 1);
+		}
+		vector<T> items;
+		Leaf *prev = nullptr;
+		Leaf *next = nullptr;
+	};
+
+	struct Inner : Node
+	{
+		Inner() : Node(false)
+		{
+			children.reserve(fanout + 1);
+			counts.reserve(fanout + 1);
+		}
+		vector<std::unique_ptr<Node>> children;
+		vector<size_t> counts; // Elements under each child
+	};
+
+	std::unique_ptr<Node> m_root;
+	Leaf *m_first; // Leftmost leaf, never null
+	Leaf *m_last;  // Rightmost leaf, never null
+	size_t m_size = 0;
+	static Errors s_error; // Error management
+
+	static size_t node_size(const Node *node) noexcept
+	{
+		if (node->leaf)
+		{
+			return static_cast<const Leaf *>(node)->items.size();
+		}
+		const auto *inner = static_cast<const Inner *>(node);
+		return std::accumulate(inner->counts.begin(), inner->counts.end(), size_t(0));
+	}
+
+	/// @brief Leaf holding position pos and the offset inside it
+	std::pair<Leaf *, size_t> locate(size_t pos) const noexcept
+	{
+		Node *node = m_root.get();
+		while (!node->leaf)
+		{
+			auto *inner = static_cast<Inner *>(node);
+			size_t child = 0;
+			while (pos >= inner->counts[child])
+			{
+				pos -= inner->counts[child];
+				++child;
+			}
+			node = inner->children[child].get();
+		}
+		return {static_cast<Leaf *>(node), pos};
+	}
+
+	void link_after(Leaf *leaf, Leaf *added) noexcept
+	{
+		added->prev = leaf;
+		added->next = leaf->next;
+		if (leaf->next)
+		{
+			leaf->next->prev = added;
+		}
+		else
+		{
+			m_last = added;
+		}
+		leaf->next = added;
+	}
+
+	void unlink(Leaf *leaf) noexcept
+	{
+		if (leaf->prev)
+		{
+			leaf->prev->next = leaf->next;
+		}
+		else
+		{
+			m_first = leaf->next;
+		}
+		if (leaf->next)
+		{
+			leaf->next->prev = leaf->prev;
+		}
+		else
+		{
+			m_last = leaf->prev;
+		}
+	}
+
+	/// @brief Insert below node, returns the new right sibling if node split
+	template <typename... Args>
+	std::unique_ptr<Node> insert_into(Node *node, size_t pos, Args &&... args)
+	{
+		if (node->leaf)
+		{
+			auto *leaf = static_cast<Leaf *>(node);
+			leaf->items.emplace(leaf->items.begin() + pos, std::forward<Args>(args)...);
+			if (leaf->items.size() <= leaf_capacity)
+			{
+				return nullptr;
+			}
+			auto right = std::make_unique<Leaf>();
+			const size_t half = leaf->items.size() / 2;
+			right->items.assign(std::make_move_iterator(leaf->items.begin() + half),
+								std::make_move_iterator(leaf->items.end()));
+			leaf->items.erase(leaf->items.begin() + half, leaf->items.end());
+			link_after(leaf, right.get());
+			return right;
+		}
+
+		auto *inner = static_cast<Inner *>(node);
+		size_t child = 0;
+		while (child + 1 < inner->counts.size() && pos > inner->counts[child])
+		{
+			pos -= inner->counts[child];
+			++child;
+		}
+		auto split = insert_into(inner->children[child].get(), pos, std::forward<Args>(args)...);
+		++inner->counts[child];
+		if (!split)
+		{
+			return nullptr;
+		}
+		const size_t moved = node_size(split.get());
+		inner->counts[child] -= moved;
+		inner->children.insert(inner->children.begin() + child + 1, std::move(split));
+		inner->counts.insert(inner->counts.begin() + child + 1, moved);
+		if (inner->children.size() <= fanout)
+		{
+			return nullptr;
+		}
+		auto right = std::make_unique<Inner>();
+		const size_t half = inner->children.size() / 2;
+		right->children.assign(std::make_move_iterator(inner->children.begin() + half),
+							   std::make_move_iterator(inner->children.end()));
+		right->counts.assign(inner->counts.begin() + half, inner->counts.end());
+		inner->children.erase(inner->children.begin() + half, inner->children.end());
+		inner->counts.erase(inner->counts.begin() + half, inner->counts.end());
+		return right;
+	}
+
+	/// @brief Merge or even out children first and first + 1 of inner
+	void rebalance(Inner *inner, size_t first)
+	{
+		Node *left_node = inner->children[first].get();
+		Node *right_node = inner->children[first + 1].get();
+		bool merged;
+		if (left_node->leaf)
+		{
+			auto &left = static_cast<Leaf *>(left_node)->items;
+			auto &right = static_cast<Leaf *>(right_node)->items;
+			merged = left.size() + right.size() <= leaf_capacity;
+			if (merged)
+			{
+				left.insert(left.end(), std::make_move_iterator(right.begin()), std::make_move_iterator(right.end()));
+				unlink(static_cast<Leaf *>(right_node));
+			}
+			else if (left.size() < right.size())
+			{
+				const size_t take = (right.size() - left.size()) / 2;
+				left.insert(left.end(), std::make_move_iterator(right.begin()),
+							std::make_move_iterator(right.begin() + take));
+				right.erase(right.begin(), right.begin() + take);
+			}
+			else
+			{
+				const size_t take = (left.size() - right.size()) / 2;
+				right.insert(right.begin(), std::make_move_iterator(left.end() - take),
+							 std::make_move_iterator(left.end()));
+				left.erase(left.end() - take, left.end());
+			}
+		}
+		else
+		{
+			auto *left = static_cast<Inner *>(left_node);
+			auto *right = static_cast<Inner *>(right_node);
+			merged = left->children.size() + right->children.size() <= fanout;
+			size_t take;
+			if (merged)
+			{
+				take = right->children.size();
+			}
+			else
+			{
+				take = left->children.size() < right->children.size()
+						   ? (right->children.size() - left->children.size()) / 2
+						   : 0;
+			}
+			left->children.insert(left->children.end(), std::make_move_iterator(right->children.begin()),
+								  std::make_move_iterator(right->children.begin() + take));
+			left->counts.insert(left->counts.end(), right->counts.begin(), right->counts.begin() + take);
+			right->children.erase(right->children.begin(), right->children.begin() + take);
+			right->counts.erase(right->counts.begin(), right->counts.begin() + take);
+			if (!merged && left->children.size() > right->children.size())
+			{
+				const size_t give = (left->children.size() - right->children.size()) / 2;
+				right->children.insert(right->children.begin(), std::make_move_iterator(left->children.end() - give),
+									   std::make_move_iterator(left->children.end()));
+				right->counts.insert(right->counts.begin(), left->counts.end() - give, left->counts.end());
+				left->children.erase(left->children.end() - give, left->children.end());
+				left->counts.erase(left->counts.end() - give, left->counts.end());
+			}
+		}
+
+		if (merged)
+		{
+			inner->counts[first] += inner->counts[first + 1];
+			inner->children.erase(inner->children.begin() + first + 1);
+			inner->counts.erase(inner->counts.begin() + first + 1);
+		}
+		else
+		{
+			const size_t total = inner->counts[first] + inner->counts[first + 1];
+			inner->counts[first] = node_size(left_node);
+			inner->counts[first + 1] = total - inner->counts[first];
+		}
+	}
+
+	/// @brief Check if a child has fallen below half occupancy
+	static bool underfull(const Node *node) noexcept
+	{
+		if (node->leaf)
+		{
+			return static_cast<const Leaf *>(node)->items.size() < leaf_capacity / 2;
+		}
+		return static_cast<const Inner *>(node)->children.size() < fanout / 2;
+	}
+
+	T remove_from(Node *node, size_t pos)
+	{
+		if (node->leaf)
+		{
+			auto &items = static_cast<Leaf *>(node)->items;
+			T removed = std::move(items[pos]);
+			items.erase(items.begin() + pos);
+			return removed;
+		}
+
+		auto *inner = static_cast<Inner *>(node);
+		size_t child = 0;
+		while (pos >= inner->counts[child])
+		{
+			pos -= inner->counts[child];
+			++child;
+		}
+		T removed = remove_from(inner->children[child].get(), pos);
+		--inner->counts[child];
+		if (inner->children.size() > 1 && underfull(inner->children[child].get()))
+		{
+			rebalance(inner, child + 1 < inner->children.size() ? child : child - 1);
+		}
+		return removed;
+	}
+
+	/// @brief Build a balanced tree from a sequence in O(n)
+	/// @details Elements and children are spread evenly so every node but a
+	///          lone root starts at least half full.
+	template <typename Iterator>
+	void build(Iterator first, Iterator last)
+	{
+		const vector<T> items(first, last);
+		m_size = items.size();
+		const size_t leaves = std::max<size_t>(1, (m_size + leaf_capacity - 1) / leaf_capacity);
+		vector<std::unique_ptr<Node>> level;
+		vector<size_t> sizes;
+		Leaf *previous = nullptr;
+		for (size_t i = 0, begin = 0; i < leaves; ++i)
+		{
+			const size_t end = m_size * (i + 1) / leaves;
+			auto leaf = std::make_unique<Leaf>();
+			leaf->items.assign(items.begin() + begin, items.begin() + end);
+			begin = end;
+			if (previous)
+			{
+				previous->next = leaf.get();
+			}
+			else
+			{
+				m_first = leaf.get();
+			}
+			leaf->prev = previous;
+			previous = leaf.get();
+			sizes.push_back(leaf->items.size());
+			level.push_back(std::move(leaf));
+		}
+		m_last = previous;
+
+		while (level.size() > 1)
+		{
+			const size_t groups = (level.size() + fanout - 1) / fanout;
+			vector<std::unique_ptr<Node>> parents;
+			vector<size_t> parent_sizes;
+			for (size_t i = 0, begin = 0; i < groups; ++i)
+			{
+				const size_t end = level.size() * (i + 1) / groups;
+				auto inner = std::make_unique<Inner>();
+				size_t total = 0;
+				for (size_t j = begin; j < end; ++j)
+				{
+					inner->children.push_back(std::move(level[j]));
+					inner->counts.push_back(sizes[j]);
+					total += sizes[j];
+				}
+				begin = end;
+				parents.push_back(std::move(inner));
+				parent_sizes.push_back(total);
+			}
+			level = std::move(parents);
+			sizes = std::move(parent_sizes);
+		}
+		m_root = std::move(level.front());
+	}
+
+	void reset()
+	{
+		auto leaf = std::make_unique<Leaf>();
+		m_first = m_last = leaf.get();
+		m_root = std::move(leaf);
+		m_size = 0;
+	}
+
+	template <bool Const>
+	class Iter
+	{
+		friend class IndexedStore;
+		using owner_type = std::conditional_t<Const, const IndexedStore, IndexedStore>;
+
+		owner_type *m_owner = nullptr;
+		Leaf *m_leaf = nullptr; // nullptr at end
+		size_t m_index = 0;
+
+		Iter(owner_type *owner, Leaf *leaf, size_t index) noexcept : m_owner(owner), m_leaf(leaf), m_index(index) {}
+
+	  public:
+		using iterator_category = std::bidirectional_iterator_tag;
+		using value_type = T;
+		using difference_type = std::ptrdiff_t;
+		using pointer = std::conditional_t<Const, const T *, T *>;
+		using reference = std::conditional_t<Const, const T &, T &>;
+
+		Iter() = default;
+
+		/// @brief Conversion from a mutable iterator
+		template <bool C = Const, typename = std::enable_if_t<C>>
+		Iter(const Iter<false> &other) noexcept : m_owner(other.m_owner), m_leaf(other.m_leaf), m_index(other.m_index)
+		{
+		}
+
+		reference operator*() const noexcept
+		{
+			return m_leaf->items[m_index];
+		}
+
+		pointer operator->() const noexcept
+		{
+			return &m_leaf->items[m_index];
+		}
+
+		Iter &operator++() noexcept
+		{
+			if (++m_index == m_leaf->items.size())
+			{
+				m_leaf = m_leaf->next;
+				m_index = 0;
+			}
+			return *this;
+		}
+
+		Iter operator++(int) noexcept
+		{
+			Iter copy = *this;
+			++*this;
+			return copy;
+		}
+
+		Iter &operator--() noexcept
+		{
+			if (!m_leaf)
+			{
+				m_leaf = m_owner->m_last;
+				m_index = m_leaf->items.size();
+			}
+			if (m_index == 0)
+			{
+				m_leaf = m_leaf->prev;
+				m_index = m_leaf->items.size();
+			}
+			--m_index;
+			return *this;
+		}
+
+		Iter operator--(int) noexcept
+		{
+			Iter copy = *this;
+			--*this;
+			return copy;
+		}
+
+		friend bool operator==(const Iter &a, const Iter &b) noexcept
+		{
+			return a.m_leaf == b.m_leaf && a.m_index == b.m_index;
+		}
+
+		friend bool operator!=(const Iter &a, const Iter &b) noexcept
+		{
+			return !(a == b);
+		}
+
+		friend class Iter<!Const>;
+	};
+
+  public:
+	using value_type = T;
+	using size_type = size_t;
+	using reference = T &;
+	using const_reference = const T &;
+	using iterator = Iter<false>;
+	using const_iterator = Iter<true>;
+
+	// =======================
+	// Constructors & Destructor
+	// =======================
+
+	/// @brief Default constructor
+	IndexedStore()
+	{
+		reset();
+	}
+
+	/// @brief Constructor with initializer list
+	/// @param list Initializer list of elements
+	IndexedStore(initializer_list<T> list)
+	{
+		build(list.begin(), list.end());
+	}
+
+	/// @brief Constructor with iterator range, O(n)
+	/// @tparam Iterator Iterator type
+	/// @param begin Start iterator
+	/// @param end End iterator
+	template <typename Iterator>
+	IndexedStore(Iterator begin, Iterator end)
+	{
+		build(begin, end);
+	}
+
+	/// @brief Constructor from a store, O(n)
+	/// @param store Elements to copy
+	template <typename Alloc>
+	explicit IndexedStore(const Store<T, Alloc> &store)
+	{
+		build(store.begin(), store.end());
+	}
+
+	/// @brief Copy constructor, rebuilds a balanced tree
+	IndexedStore(const IndexedStore &other)
+	{
+		build(other.begin(), other.end());
+	}
+
+	/// @brief Move constructor, leaves other empty
+	IndexedStore(IndexedStore &&other) : IndexedStore()
+	{
+		swap(other);
+	}
+
+	/// @brief Copy/move assignment
+	IndexedStore &operator=(IndexedStore other) noexcept
+	{
+		swap(other);
+		return *this;
+	}
+
+	/// @brief Swap contents with another IndexedStore
+	/// @param other Other store
+	void swap(IndexedStore &other) noexcept
+	{
+		std::swap(m_root, other.m_root);
+		std::swap(m_first, other.m_first);
+		std::swap(m_last, other.m_last);
+		std::swap(m_size, other.m_size);
+	}
+
+	// =======================
+	// Element Access
+	// =======================
+
+	/// @brief Access element with bounds checking, O(log n)
+	/// @param pos Position of element
+	/// @return Reference to element
+	/// @throws std::out_of_range if position is invalid
+	T &at(size_t pos)
+	{
+		if (pos >= m_size)
+		{
+			s_error.throw_out_of_range();
+		}
+		return (*this)[pos];
+	}
+
+	/// @brief Access element with bounds checking (const), O(log n)
+	/// @param pos Position of element
+	/// @return Const reference to element
+	/// @throws std::out_of_range if position is invalid
+	const T &at(size_t pos) const
+	{
+		if (pos >= m_size)
+		{
+			s_error.throw_out_of_range();
+		}
+		return (*this)[pos];
+	}
+
+	/// @brief Access element without bounds checking, O(log n)
+	/// @param pos Position of element
+	/// @return Reference to element
+	T &operator[](size_t pos) noexcept
+	{
+		const auto [leaf, offset] = locate(pos);
+		return leaf->items[offset];
+	}
+
+	/// @brief Access element without bounds checking (const), O(log n)
+	/// @param pos Position of element
+	/// @return Const reference to element
+	const T &operator[](size_t pos) const noexcept
+	{
+		const auto [leaf, offset] = locate(pos);
+		return leaf->items[offset];
+	}
+
+	/// @brief Get first element, O(1)
+	/// @return Const reference to first element
+	/// @throws std::out_of_range if store is empty
+	const T &front() const
+	{
+		if (m_size == 0)
+		{
+			s_error.throw_out_of_range();
+		}
+		return m_first->items.front();
+	}
+
+	/// @brief Get last element, O(1)
+	/// @return Const reference to last element
+	/// @throws std::out_of_range if store is empty
+	const T &back() const
+	{
+		if (m_size == 0)
+		{
+			s_error.throw_out_of_range();
+		}
+		return m_last->items.back();
+	}
+
+	// =======================
+	// Capacity
+	// =======================
+
+	/// @brief Get number of elements
+	/// @return Number of elements
+	size_t size() const noexcept
+	{
+		return m_size;
+	}
+
+	/// @brief Check if store is empty
+	/// @return true if empty
+	bool empty() const noexcept
+	{
+		return m_size == 0;
+	}
+
+	/// @brief Clear all elements
+	void clear()
+	{
+		reset();
+	}
+
+	// =======================
+	// Iterators
+	// =======================
+
+	iterator begin() noexcept
+	{
+		return iterator(this, m_size ? m_first : nullptr, 0);
+	}
+
+	iterator end() noexcept
+	{
+		return iterator(this, nullptr, 0);
+	}
+
+	const_iterator begin() const noexcept
+	{
+		return const_iterator(this, m_size ? m_first : nullptr, 0);
+	}
+
+	const_iterator end() const noexcept
+	{
+		return const_iterator(this, nullptr, 0);
+	}
+
+	const_iterator cbegin() const noexcept
+	{
+		return begin();
+	}
+
+	const_iterator cend() const noexcept
+	{
+		return end();
+	}
+
+	// =======================
+	// Adding Elements
+	// =======================
+
+	/// @brief Insert value at position, O(log n)
+	/// @param pos Position to insert at (0 to size)
+	/// @param value Value to insert
+	/// @throws std::out_of_range if position is invalid
+	void insert(size_t pos, const T &value)
+	{
+		emplace(pos, value);
+	}
+
+	/// @brief Insert moved value at position, O(log n)
+	/// @param pos Position to insert at (0 to size)
+	/// @param value Value to move
+	/// @throws std::out_of_range if position is invalid
+	void insert(size_t pos, T &&value)
+	{
+		emplace(pos, std::move(value));
+	}
+
+	/// @brief Emplace element at position, O(log n)
+	/// @tparam Args Argument types
+	/// @param pos Position to insert at (0 to size)
+	/// @param args Arguments to construct element
+	/// @throws std::out_of_range if position is invalid
+	template <typename... Args>
+	void emplace(size_t pos, Args &&... args)
+	{
+		if (pos > m_size)
+		{
+			s_error.throw_out_of_range();
+		}
+		auto split = insert_into(m_root.get(), pos, std::forward<Args>(args)...);
+		++m_size;
+		if (split)
+		{
+			auto root = std::make_unique<Inner>();
+			const size_t right = node_size(split.get());
+			root->counts.push_back(m_size - right);
+			root->counts.push_back(right);
+			root->children.push_back(std::move(m_root));
+			root->children.push_back(std::move(split));
+			m_root = std::move(root);
+		}
+	}
+
+	/// @brief Add value to back
+	/// @param value Value to add
+	void push_back(const T &value)
+	{
+		emplace(m_size, value);
+	}
+
+	/// @brief Add moved value to back
+	/// @param value Value to move
+	void push_back(T &&value)
+	{
+		emplace(m_size, std::move(value));
+	}
+
+	/// @brief Add value to front
+	/// @param value Value to add
+	void push_front(const T &value)
+	{
+		emplace(0, value);
+	}
+
+	/// @brief Add moved value to front
+	/// @param value Value to move
+	void push_front(T &&value)
+	{
+		emplace(0, std::move(value));
+	}
+
+	// =======================
+	// Removing Elements
+	// =======================
+
+	/// @brief Remove element at position, O(log n)
+	/// @param pos Position to remove
+	/// @return Removed element
+	/// @throws std::out_of_range if position is invalid
+	T remove_at(size_t pos)
+	{
+		if (pos >= m_size)
+		{
+			s_error.throw_out_of_range();
+		}
+		T removed = remove_from(m_root.get(), pos);
+		--m_size;
+		while (!m_root->leaf && static_cast<Inner *>(m_root.get())->children.size() == 1)
+		{
+			std::unique_ptr<Node> child = std::move(static_cast<Inner *>(m_root.get())->children.front());
+			m_root = std::move(child);
+		}
+		return removed;
+	}
+
+	/// @brief Remove first element
+	/// @throws std::out_of_range if store is empty
+	void pop_front()
+	{
+		remove_at(0);
+	}
+
+	/// @brief Remove last element
+	/// @throws std::out_of_range if store is empty
+	void pop_back()
+	{
+		if (m_size == 0)
+		{
+			s_error.throw_out_of_range();
+		}
+		remove_at(m_size - 1);
+	}
+
+	// =======================
+	// Type Conversion
+	// =======================
+
+	/// @brief Copy elements into a contiguous Store
+	/// @return New store in sequence order
+	Store<T> to_store() const
+	{
+		Store<T> result;
+		result.reserve(m_size);
+		for (const Leaf *leaf = m_first; leaf; leaf = leaf->next)
+		{
+			for (const auto &item : leaf->items)
+			{
+				result.push_back(item);
+			}
+		}
+		return result;
+	}
+};
+
+template <typename T>
+Errors IndexedStore<T>::s_error;
+
+} // namespace adv
@@ -0,0 +1,469 @@
+#pragma once
+#include "advance_store.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define ADV_STORE_MATH_SSE2 1
+#endif
+
+namespace adv
+{
+
+// =======================
+// Dot Product Kernels
+// =======================
+
+namespace detail
+{
+/// @brief Sum of x[i] * y[i] with four independent accumulators
+/// @details Splitting the sum breaks the add dependency chain; floating
+///          point results may differ from a left-to-right sum in the last bits.
+template <typename T>
+T dot_scalar(const T *x, const T *y, size_t n) noexcept
+{
+	T acc[4] = {T(), T(), T(), T()};
+	size_t i = 0;
+	for (; i + 4 <= n; i += 4)
+	{
+		acc[0] += x[i] * y[i];
+		acc[1] += x[i + 1] * y[i + 1];
+		acc[2] += x[i + 2] * y[i + 2];
+		acc[3] += x[i + 3] * y[i + 3];
+	}
+	for (; i < n; ++i)
+	{
+		acc[0] += x[i] * y[i];
+	}
+	return (acc[0] + acc[1]) + (acc[2] + acc[3]);
+}
+
+#ifdef ADV_STORE_MATH_SSE2
+/// @brief Double dot product, two SSE2 accumulators of two lanes
+inline double dot_sse2(const double *x, const double *y, size_t n) noexcept
+{
+	__m128d acc0 = _mm_setzero_pd();
+	__m128d acc1 = _mm_setzero_pd();
+	size_t i = 0;
+	for (; i + 4 <= n; i += 4)
+	{
+		acc0 = _mm_add_pd(acc0, _mm_mul_pd(_mm_loadu_pd(x + i), _mm_loadu_pd(y + i)));
+		acc1 = _mm_add_pd(acc1, _mm_mul_pd(_mm_loadu_pd(x + i + 2), _mm_loadu_pd(y + i + 2)));
+	}
+	double lanes[2];
+	_mm_storeu_pd(lanes, _mm_add_pd(acc0, acc1));
+	double total = lanes[0] + lanes[1];
+	for (; i < n; ++i)
+	{
+		total += x[i] * y[i];
+	}
+	return total;
+}
+
+/// @brief Float dot product, two SSE2 accumulators of four lanes
+inline float dot_sse2(const float *x, const float *y, size_t n) noexcept
+{
+	__m128 acc0 = _mm_setzero_ps();
+	__m128 acc1 = _mm_setzero_ps();
+	size_t i = 0;
+	for (; i + 8 <= n; i += 8)
+	{
+		acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(x + i), _mm_loadu_ps(y + i)));
+		acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(x + i + 4), _mm_loadu_ps(y + i + 4)));
+	}
+	float lanes[4];
+	_mm_storeu_ps(lanes, _mm_add_ps(acc0, acc1));
+	float total = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+	for (; i < n; ++i)
+	{
+		total += x[i] * y[i];
+	}
+	return total;
+}
+#endif
+
+/// @brief Pick the widest available kernel for T
+template <typename T>
+T dot_kernel(const T *x, const T *y, size_t n) noexcept
+{
+#ifdef ADV_STORE_MATH_SSE2
+	if constexpr (std::is_same_v<T, double> || std::is_same_v<T, float>)
+	{
+		return dot_sse2(x, y, n);
+	}
+	else
+#endif
+	{
+		return dot_scalar(x, y, n);
+	}
+}
+} // namespace detail
+
+// =======================
+// Expression Templates
+// =======================
+// Elementwise operators live in adv::ops because Store::operator+= already
+// means "append". Once one operand is an expression, argument-dependent
+// lookup finds the operators; combining two plain Stores needs
+// `using namespace adv::ops;`. Nothing is computed until evaluate() or
+// sum(), which run one fused loop without temporaries. Operands combine in
+// their common type, so Store<int> * 0.5 evaluates to a Store<double>.
+
+namespace ops
+{
+/// @brief Size reported by scalar terms, compatible with any length
+inline constexpr size_t k_any_size = static_cast<size_t>(-1);
+
+/// @brief Leaf reading a Store
+template <typename T>
+struct StoreTerm
+{
+	using value_type = T;
+	const T *data;
+	size_t count;
+
+	T at(size_t i) const noexcept { return data[i]; }
+	size_t size() const noexcept { return count; }
+};
+
+/// @brief Leaf broadcasting a scalar
+template <typename T>
+struct ScalarTerm
+{
+	using value_type = T;
+	T value;
+
+	T at(size_t) const noexcept { return value; }
+	size_t size() const noexcept { return k_any_size; }
+};
+
+struct Add
+{
+	template <typename T>
+	static T apply(T a, T b) noexcept { return a + b; }
+};
+
+struct Subtract
+{
+	template <typename T>
+	static T apply(T a, T b) noexcept { return a - b; }
+};
+
+struct Multiply
+{
+	template <typename T>
+	static T apply(T a, T b) noexcept { return a * b; }
+};
+
+struct Divide
+{
+	template <typename T>
+	static T apply(T a, T b) noexcept { return a / b; }
+};
+
+/// @brief Elementwise combination of two terms, in their common type
+template <typename Op, typename L, typename R>
+struct BinaryTerm
+{
+	using value_type = std::common_type_t<typename L::value_type, typename R::value_type>;
+	L left;
+	R right;
+	size_t count;
+
+	value_type at(size_t i) const noexcept
+	{
+		return Op::apply(static_cast<value_type>(left.at(i)), static_cast<value_type>(right.at(i)));
+	}
+	size_t size() const noexcept { return count; }
+};
+
+/// @brief Lazy elementwise expression over Stores and scalars
+/// @tparam Term Expression tree
+template <typename Term>
+class Expr
+{
+  public:
+	using value_type = typename Term::value_type;
+
+	explicit Expr(Term term) : m_term(std::move(term)) {}
+
+	/// @brief Get the element count, checked when the expression was built
+	/// @return Length shared by all Store operands
+	size_t size() const noexcept
+	{
+		return m_term.size();
+	}
+
+	/// @brief Compute one element
+	/// @param i Position
+	/// @return Value at position i
+	value_type operator[](size_t i) const noexcept
+	{
+		return m_term.at(i);
+	}
+
+	const Term &term() const noexcept
+	{
+		return m_term;
+	}
+
+  private:
+	Term m_term;
+};
+
+/// @brief Wrap a Store as an expression
+/// @param store Store to read (must outlive the expression)
+/// @return Expression reading store
+template <typename T, typename Alloc>
+Expr<StoreTerm<T>> expr(const Store<T, Alloc> &store) noexcept
+{
+	return Expr<StoreTerm<T>>(StoreTerm<T>{store.data(), store.size()});
+}
+
+namespace detail
+{
+template <typename X>
+struct is_expr : std::false_type
+{
+};
+
+template <typename Term>
+struct is_expr<Expr<Term>> : std::true_type
+{
+};
+
+template <typename X>
+struct is_store : std::false_type
+{
+};
+
+template <typename T, typename Alloc>
+struct is_store<Store<T, Alloc>> : std::true_type
+{
+};
+
+/// @brief Check if X can be a non-scalar operand
+template <typename X>
+inline constexpr bool is_vector_operand = is_expr<X>::value || is_store<X>::value;
+
+/// @brief Operand pairs accepted by the operators: at least one non-scalar
+template <typename L, typename R>
+inline constexpr bool is_operand_pair =
+	(is_vector_operand<L> && (is_vector_operand<R> || std::is_arithmetic_v<R>)) ||
+	(std::is_arithmetic_v<L> && is_vector_operand<R>);
+
+template <typename X>
+struct element_of
+{
+	using type = X;
+};
+
+template <typename Term>
+struct element_of<Expr<Term>>
+{
+	using type = typename Term::value_type;
+};
+
+template <typename T, typename Alloc>
+struct element_of<Store<T, Alloc>>
+{
+	using type = T;
+};
+
+template <typename X, typename Y>
+inline constexpr bool both_floating =
+	std::is_floating_point_v<typename element_of<X>::type> && std::is_floating_point_v<typename element_of<Y>::type>;
+
+/// @brief Element type of an operation between L and R
+/// @details The usual arithmetic conversions, except that a floating point
+///          scalar keeps the precision of a floating point operand:
+///          Store<int> * 0.5 is double, Store<float> * 0.5 stays float.
+template <typename L, typename R>
+using result_t = std::conditional_t<
+	!is_vector_operand<L> && both_floating<L, R>, typename element_of<R>::type,
+	std::conditional_t<!is_vector_operand<R> && both_floating<L, R>, typename element_of<L>::type,
+					   std::common_type_t<typename element_of<L>::type, typename element_of<R>::type>>>;
+
+/// @brief Turn an operand into a term, scalars are converted to T
+template <typename T, typename X>
+auto to_term(const X &operand)
+{
+	if constexpr (is_expr<X>::value)
+	{
+		return operand.term();
+	}
+	else if constexpr (is_store<X>::value)
+	{
+		using U = typename element_of<X>::type;
+		return StoreTerm<U>{operand.data(), operand.size()};
+	}
+	else
+	{
+		return ScalarTerm<T>{static_cast<T>(operand)};
+	}
+}
+
+template <typename Op, typename L, typename R>
+auto combine(const L &left, const R &right)
+{
+	using T = result_t<L, R>;
+	auto l = to_term<T>(left);
+	auto r = to_term<T>(right);
+	const size_t ls = l.size();
+	const size_t rs = r.size();
+	if (ls != k_any_size && rs != k_any_size && ls != rs)
+	{
+		Errors().throw_invalid_argument();
+	}
+	const size_t count = ls == k_any_size ? rs : ls;
+	return Expr<BinaryTerm<Op, decltype(l), decltype(r)>>({std::move(l), std::move(r), count});
+}
+} // namespace detail
+
+/// @brief Elementwise sum (lazy)
+/// @throws std::invalid_argument if two Store operands differ in length
+template <typename L, typename R, typename = std::enable_if_t<detail::is_operand_pair<L, R>>>
+auto operator+(const L &left, const R &right)
+{
+	return detail::combine<Add>(left, right);
+}
+
+/// @brief Elementwise difference (lazy)
+/// @throws std::invalid_argument if two Store operands differ in length
+template <typename L, typename R, typename = std::enable_if_t<detail::is_operand_pair<L, R>>>
+auto operator-(const L &left, const R &right)
+{
+	return detail::combine<Subtract>(left, right);
+}
+
+/// @brief Elementwise product (lazy)
+/// @throws std::invalid_argument if two Store operands differ in length
+template <typename L, typename R, typename = std::enable_if_t<detail::is_operand_pair<L, R>>>
+auto operator*(const L &left, const R &right)
+{
+	return detail::combine<Multiply>(left, right);
+}
+
+/// @brief Elementwise quotient (lazy)
+/// @throws std::invalid_argument if two Store operands differ in length
+template <typename L, typename R, typename = std::enable_if_t<detail::is_operand_pair<L, R>>>
+auto operator/(const L &left, const R &right)
+{
+	return detail::combine<Divide>(left, right);
+}
+} // namespace ops
+
+// =======================
+// Vector Arithmetic
+// =======================
+
+/// @brief Dot product of two stores
+/// @details Uses SSE2 for float and double, four accumulators otherwise;
+///          floating point results may differ from a sequential sum in the
+///          last bits.
+/// @tparam T Arithmetic element type
+/// @tparam Alloc Allocator type
+/// @param a First store
+/// @param b Second store
+/// @return Sum of a[i] * b[i]
+/// @throws std::invalid_argument if the stores differ in length
+template <typename T, typename Alloc>
+T dot(const Store<T, Alloc> &a, const Store<T, Alloc> &b)
+{
+	static_assert(std::is_arithmetic_v<T>, "dot requires an arithmetic element type");
+	if (a.size() != b.size())
+	{
+		Errors().throw_invalid_argument();
+	}
+	return detail::dot_kernel(a.data(), b.data(), a.size());
+}
+
+/// @brief y += alpha * x, in place
+/// @tparam T Arithmetic element type
+/// @tparam Alloc Allocator type
+/// @param alpha Scale factor
+/// @param x Input store
+/// @param y Store updated in place
+/// @throws std::invalid_argument if the stores differ in length
+template <typename T, typename Alloc>
+void axpy(T alpha, const Store<T, Alloc> &x, Store<T, Alloc> &y)
+{
+	static_assert(std::is_arithmetic_v<T>, "axpy requires an arithmetic element type");
+	if (x.size() != y.size())
+	{
+		Errors().throw_invalid_argument();
+	}
+	const T *in = x.data();
+	T *out = y.data();
+	const size_t n = y.size();
+	for (size_t i = 0; i < n; ++i)
+	{
+		out[i] += alpha * in[i];
+	}
+	y.mark_modified();
+}
+
+/// @brief Evaluate an expression into a store in one fused loop
+/// @details out is resized to the expression length; it may also appear in
+///          the expression (e.g. a = a * b + c) since element i only reads
+///          position i.
+/// @tparam T Element type
+/// @tparam Alloc Allocator type
+/// @tparam Term Expression tree
+/// @param out Destination store, its capacity is reused
+/// @param e Expression to evaluate
+template <typename T, typename Alloc, typename Term>
+void evaluate(Store<T, Alloc> &out, const ops::Expr<Term> &e)
+{
+	const size_t n = e.size();
+	out.resize(n);
+	T *dst = out.data();
+	const Term &term = e.term();
+	for (size_t i = 0; i < n; ++i)
+	{
+		dst[i] = static_cast<T>(term.at(i));
+	}
+	out.mark_modified();
+}
+
+/// @brief Evaluate an expression into a new store
+/// @tparam Term Expression tree
+/// @param e Expression to evaluate
+/// @return New store of e.size() elements
+template <typename Term>
+Store<typename Term::value_type> evaluate(const ops::Expr<Term> &e)
+{
+	Store<typename Term::value_type> out;
+	evaluate(out, e);
+	return out;
+}
+
+/// @brief Sum an expression without materializing it
+/// @details sum(price * quantity) is a fused dot product. Four accumulators,
+///          so floating point results may differ from a sequential sum in
+///          the last bits.
+/// @tparam Term Expression tree
+/// @param e Expression to sum
+/// @return Sum of all elements
+template <typename Term>
+typename Term::value_type sum(const ops::Expr<Term> &e)
+{
+	using T = typename Term::value_type;
+	const Term &term = e.term();
+	const size_t n = e.size();
+	T acc[4] = {T(), T(), T(), T()};
+	size_t i = 0;
+	for (; i + 4 <= n; i += 4)
+	{
+		acc[0] += term.at(i);
+		acc[1] += term.at(i + 1);
+		acc[2] += term.at(i + 2);
+		acc[3] += term.at(i + 3);
+	}
+	for (; i < n; ++i)
+	{
+		acc[0] += term.at(i);
+	}
+	return (acc[0] + acc[1]) + (acc[2] + acc[3]);
+}
+
+} // namespace adv
@@ -0,0 +1,216 @@
+#pragma once
+#include "advance_store.hpp"
+#include <functional>
+
+namespace adv
+{
+
+// =======================
+// Loser Tree
+// =======================
+
+namespace detail
+{
+/// @brief Tournament tree over k sorted runs
+/// @details Internal nodes keep the loser of their match and node 0 the
+///          overall winner, so replacing the winner costs one comparison per
+///          level (log2 k) against a binary heap's two. Ties go to the run
+///          with the lower index, which keeps the merge stable.
+template <typename T, typename Alloc, typename Compare>
+class LoserTree
+{
+  private:
+	vector<const T *> m_head; // Next element of each run
+	vector<const T *> m_end;  // End of each run
+	vector<size_t> m_tree;	  // [0] winner, [1, k) losers
+	Compare m_comp;
+	size_t m_k;
+
+	bool exhausted(size_t run) const noexcept
+	{
+		return m_head[run] == m_end[run];
+	}
+
+	bool beats(size_t a, size_t b) const
+	{
+		if (exhausted(a))
+		{
+			return false;
+		}
+		if (exhausted(b))
+		{
+			return true;
+		}
+		const T &x = *m_head[a];
+		const T &y = *m_head[b];
+		if (m_comp(x, y))
+		{
+			return true;
+		}
+		if (m_comp(y, x))
+		{
+			return false;
+		}
+		return a < b;
+	}
+
+  public:
+	LoserTree(const vector<const Store<T, Alloc> *> &runs, Compare comp)
+		: m_head(runs.size()), m_end(runs.size()), m_tree(std::max<size_t>(runs.size(), 1), 0),
+		  m_comp(std::move(comp)), m_k(runs.size())
+	{
+		for (size_t i = 0; i < m_k; ++i)
+		{
+			m_head[i] = runs[i]->data();
+			m_end[i] = runs[i]->data() + runs[i]->size();
+		}
+		if (m_k == 0)
+		{
+			return;
+		}
+		// Play the initial tournament bottom-up, leaves are nodes [k, 2k)
+		vector<size_t> winner(2 * m_k);
+		for (size_t i = 0; i < m_k; ++i)
+		{
+			winner[m_k + i] = i;
+		}
+		for (size_t node = m_k - 1; node >= 1; --node)
+		{
+			const size_t left = winner[2 * node];
+			const size_t right = winner[2 * node + 1];
+			const bool left_wins = beats(left, right);
+			winner[node] = left_wins ? left : right;
+			m_tree[node] = left_wins ? right : left;
+		}
+		m_tree[0] = m_k == 1 ? 0 : winner[1];
+	}
+
+	/// @brief Check if every run is exhausted
+	bool empty() const noexcept
+	{
+		return m_k == 0 || exhausted(m_tree[0]);
+	}
+
+	/// @brief Smallest remaining element
+	const T &top() const noexcept
+	{
+		return *m_head[m_tree[0]];
+	}
+
+	/// @brief Advance the winning run and replay its path to the root
+	void pop()
+	{
+		size_t winner = m_tree[0];
+		++m_head[winner];
+		for (size_t node = (m_k + winner) / 2; node >= 1; node /= 2)
+		{
+			if (beats(m_tree[node], winner))
+			{
+				std::swap(m_tree[node], winner);
+			}
+		}
+		m_tree[0] = winner;
+	}
+};
+} // namespace detail
+
+// =======================
+// K-way Merge
+// =======================
+
+/// @brief Merge sorted stores into one sorted store
+/// @details Runs known to be sorted by comp (see Store::sort_order) are not
+///          checked, others are verified in O(n). The result is marked sorted
+///          when comp is std::less or std::greater.
+/// @tparam T Element type
+/// @tparam Alloc Allocator type
+/// @tparam Compare Comparator type
+/// @param runs Stores, each sorted by comp
+/// @param dedupe Whether to keep only the first of equal elements
+/// @param comp Ordering (default ascending)
+/// @return Merged store
+/// @throws std::invalid_argument if a run is not sorted by comp
+template <typename T, typename Alloc, typename Compare = std::less<T>>
+Store<T, Alloc> merge_runs(const vector<const Store<T, Alloc> *> &runs, bool dedupe = false,
+						   Compare comp = Compare())
+{
+	constexpr SortOrder order = detail::order_of<Compare, T>();
+	size_t total = 0;
+	for (const auto *run : runs)
+	{
+		if ((order == SortOrder::unknown || run->sort_order() != order) &&
+			!std::is_sorted(run->begin(), run->end(), comp))
+		{
+			Errors().throw_invalid_argument();
+		}
+		total += run->size();
+	}
+
+	Store<T, Alloc> result(runs.empty() ? Alloc() : runs.front()->get_allocator());
+	result.reserve(total);
+	detail::LoserTree<T, Alloc, Compare> tree(runs, comp);
+	while (!tree.empty())
+	{
+		const T &value = tree.top();
+		if (!dedupe || result.empty() || comp(result.back(), value))
+		{
+			result.push_back(value);
+		}
+		tree.pop();
+	}
+	detail::StoreAccess::set_sort_order(result, order);
+	return result;
+}
+
+/// @brief Merge a list of sorted stores into one sorted store
+/// @tparam T Element type
+/// @tparam Alloc Allocator type
+/// @tparam Compare Comparator type
+/// @param runs Stores, each sorted by comp
+/// @param dedupe Whether to keep only the first of equal elements
+/// @param comp Ordering (default ascending)
+/// @return Merged store
+/// @throws std::invalid_argument if a run is not sorted by comp
+template <typename T, typename Alloc, typename Compare = std::less<T>>
+Store<T, Alloc> merge(const vector<Store<T, Alloc>> &runs, bool dedupe = false, Compare comp = Compare())
+{
+	vector<const Store<T, Alloc> *> pointers;
+	pointers.reserve(runs.size());
+	for (const auto &run : runs)
+	{
+		pointers.push_back(&run);
+	}
+	return merge_runs(pointers, dedupe, std::move(comp));
+}
+
+/// @brief Merge ascending sorted stores, keeping duplicates
+/// @tparam T Element type
+/// @tparam Alloc Allocator type
+/// @tparam Rest More Store<T, Alloc> types
+/// @param first First store
+/// @param rest Other stores
+/// @return Ascending merged store
+/// @throws std::invalid_argument if a store is not sorted ascending
+template <typename T, typename Alloc, typename... Rest>
+Store<T, Alloc> merge(const Store<T, Alloc> &first, const Rest &... rest)
+{
+	const vector<const Store<T, Alloc> *> pointers{&first, &rest...};
+	return merge_runs(pointers, false, std::less<T>());
+}
+
+/// @brief Merge ascending sorted stores, keeping one of equal elements
+/// @tparam T Element type
+/// @tparam Alloc Allocator type
+/// @tparam Rest More Store<T, Alloc> types
+/// @param first First store
+/// @param rest Other stores
+/// @return Ascending merged store without duplicates
+/// @throws std::invalid_argument if a store is not sorted ascending
+template <typename T, typename Alloc, typename... Rest>
+Store<T, Alloc> merge_unique(const Store<T, Alloc> &first, const Rest &... rest)
+{
+	const vector<const Store<T, Alloc> *> pointers{&first, &rest...};
+	return merge_runs(pointers, true, std::less<T>());
+}
+
+} // namespace adv
@@ -0,0 +1,601 @@
+#pragma once
+#include "advance_store.hpp"
+#include <atomic>
+#include <new>
+
+namespace adv
+{
+
+// =======================
+// RingStore Template Class
+// =======================
+
+/// @brief Concurrency mode of a RingStore
+enum class RingMode
+{
+	spsc, // One producer thread, one consumer thread, wait-free
+	mpmc  // Any number of producers and consumers, lock-free
+};
+
+/// @brief Cache line size used to pad indices apart
+inline constexpr size_t k_ring_cache_line = 64;
+
+namespace detail
+{
+/// @brief Round up to a power of two (at least 2)
+/// @return Capacity, or 0 if requested is zero or above the largest power of two
+inline size_t ring_capacity(size_t requested) noexcept
+{
+	constexpr size_t k_largest = (std::numeric_limits<size_t>::max() >> 1) + 1;
+	if (requested == 0 || requested > k_largest)
+	{
+		return 0;
+	}
+	size_t capacity = 2;
+	while (capacity < requested)
+	{
+		capacity <<= 1;
+	}
+	return capacity;
+}
+} // namespace detail
+
+/// @brief Bounded ring buffer queue for producer-consumer pipelines
+/// @details push_back appends at the tail, pop_front removes from the head,
+///          both O(1) and never allocate after construction. Operations
+///          return false / a short count instead of blocking when the ring
+///          is full or empty. The capacity is rounded up to a power of two.
+/// @tparam T Element type
+/// @tparam Mode RingMode::spsc or RingMode::mpmc
+template <typename T, RingMode Mode = RingMode::spsc>
+class RingStore;
+
+/// @brief Single-producer single-consumer ring, wait-free
+/// @details Each side owns one index on its own cache line and keeps a cached
+///          copy of the other side's index, so the shared line is only read
+///          when the cached view says full/empty. Batch operations publish
+///          all elements with a single release store.
+template <typename T>
+class RingStore<T, RingMode::spsc>
+{
+  private:
+	struct alignas(k_ring_cache_line) ProducerSide
+	{
+		std::atomic<size_t> tail{0}; // Next slot to write
+		size_t cached_head = 0;		 // Producer's view of head
+	};
+
+	struct alignas(k_ring_cache_line) ConsumerSide
+	{
+		std::atomic<size_t> head{0}; // Next slot to read
+		size_t cached_tail = 0;		 // Consumer's view of tail
+	};
+
+	struct Slot
+	{
+		alignas(T) unsigned char storage[sizeof(T)];
+	};
+
+	const size_t m_capacity; // Power of two
+	const size_t m_mask;	 // m_capacity - 1
+	std::unique_ptr<Slot[]> m_slots;
+	ProducerSide m_producer;
+	ConsumerSide m_consumer;
+	static Errors s_error; // Error management
+
+	T *slot(size_t index) noexcept
+	{
+		return std::launder(reinterpret_cast<T *>(m_slots[index & m_mask].storage));
+	}
+
+	static size_t checked_capacity(size_t requested)
+	{
+		const size_t capacity = detail::ring_capacity(requested);
+		if (capacity == 0)
+		{
+			s_error.throw_invalid_argument();
+		}
+		return capacity;
+	}
+
+  public:
+	// =======================
+	// Constructors & Destructor
+	// =======================
+
+	/// @brief Constructor with capacity
+	/// @param capacity Minimum number of elements (rounded up to a power of two)
+	/// @throws std::invalid_argument if capacity is zero or cannot be rounded up
+	explicit RingStore(size_t capacity)
+		: m_capacity(checked_capacity(capacity)), m_mask(m_capacity - 1), m_slots(new Slot[m_capacity])
+	{
+	}
+
+	RingStore(const RingStore &) = delete;
+	RingStore &operator=(const RingStore &) = delete;
+
+	/// @brief Destructor, destroys remaining elements
+	~RingStore()
+	{
+		const size_t tail = m_producer.tail.load(std::memory_order_acquire);
+		for (size_t i = m_consumer.head.load(std::memory_order_relaxed); i != tail; ++i)
+		{
+			slot(i)->~T();
+		}
+	}
+
+	// =======================
+	// Capacity
+	// =======================
+
+	/// @brief Get capacity
+	/// @return Maximum number of elements
+	size_t capacity() const noexcept
+	{
+		return m_capacity;
+	}
+
+	/// @brief Get approximate number of elements
+	/// @return Elements between head and tail at the time of the call
+	size_t size() const noexcept
+	{
+		const size_t head = m_consumer.head.load(std::memory_order_acquire);
+		const size_t tail = m_producer.tail.load(std::memory_order_acquire);
+		return tail - head;
+	}
+
+	/// @brief Check if ring is (approximately) empty
+	/// @return true if empty
+	bool empty() const noexcept
+	{
+		return size() == 0;
+	}
+
+	// =======================
+	// Producer
+	// =======================
+
+	/// @brief Emplace element at back (producer thread only)
+	/// @tparam Args Argument types
+	/// @param args Arguments to construct element
+	/// @return false if the ring is full
+	template <typename... Args>
+	bool emplace_back(Args &&... args)
+	{
+		const size_t tail = m_producer.tail.load(std::memory_order_relaxed);
+		if (tail - m_producer.cached_head == m_capacity)
+		{
+			m_producer.cached_head = m_consumer.head.load(std::memory_order_acquire);
+			if (tail - m_producer.cached_head == m_capacity)
+			{
+				return false;
+			}
+		}
+		::new (static_cast<void *>(slot(tail))) T(std::forward<Args>(args)...);
+		m_producer.tail.store(tail + 1, std::memory_order_release);
+		return true;
+	}
+
+	/// @brief Add value at back (producer thread only)
+	/// @param value Value to add
+	/// @return false if the ring is full
+	bool push_back(const T &value)
+	{
+		return emplace_back(value);
+	}
+
+	/// @brief Add moved value at back (producer thread only)
+	/// @param value Value to move
+	/// @return false if the ring is full
+	bool push_back(T &&value)
+	{
+		return emplace_back(std::move(value));
+	}
+
+	/// @brief Add as many elements of a range as fit (producer thread only)
+	/// @details If copying an element throws, the elements added before it are
+	///          published and the exception propagates.
+	/// @tparam Iterator Input iterator type
+	/// @param first Start of range
+	/// @param last End of range
+	/// @return Number of elements added
+	template <typename Iterator>
+	size_t push_back(Iterator first, Iterator last)
+	{
+		const size_t tail = m_producer.tail.load(std::memory_order_relaxed);
+		m_producer.cached_head = m_consumer.head.load(std::memory_order_acquire);
+		const size_t room = m_capacity - (tail - m_producer.cached_head);
+		size_t added = 0;
+		try
+		{
+			for (; added < room && first != last; ++added, ++first)
+			{
+				::new (static_cast<void *>(slot(tail + added))) T(*first);
+			}
+		}
+		catch (...)
+		{
+			// Elements built before the throw are complete, hand them to the consumer
+			m_producer.tail.store(tail + added, std::memory_order_release);
+			throw;
+		}
+		m_producer.tail.store(tail + added, std::memory_order_release);
+		return added;
+	}
+
+	/// @brief Add as many elements of a container as fit (producer thread only)
+	/// @tparam Container Container type
+	/// @param container Container to add from
+	/// @return Number of elements added
+	template <typename Container>
+	size_t push_back(const Container &container)
+	{
+		return push_back(container.begin(), container.end());
+	}
+
+	// =======================
+	// Consumer
+	// =======================
+
+	/// @brief Remove front element (consumer thread only)
+	/// @param out Receives the element
+	/// @return false if the ring is empty
+	bool pop_front(T &out)
+	{
+		const size_t head = m_consumer.head.load(std::memory_order_relaxed);
+		if (head == m_consumer.cached_tail)
+		{
+			m_consumer.cached_tail = m_producer.tail.load(std::memory_order_acquire);
+			if (head == m_consumer.cached_tail)
+			{
+				return false;
+			}
+		}
+		T *value = slot(head);
+		out = std::move(*value);
+		value->~T();
+		m_consumer.head.store(head + 1, std::memory_order_release);
+		return true;
+	}
+
+	/// @brief Remove up to n front elements (consumer thread only)
+	/// @tparam OutputIt Output iterator type
+	/// @param out Receives the elements in order
+	/// @param n Maximum number of elements
+	/// @return Number of elements removed
+	template <typename OutputIt>
+	size_t pop_front(OutputIt out, size_t n)
+	{
+		const size_t head = m_consumer.head.load(std::memory_order_relaxed);
+		m_consumer.cached_tail = m_producer.tail.load(std::memory_order_acquire);
+		const size_t count = std::min(n, m_consumer.cached_tail - head);
+		size_t i = 0;
+		try
+		{
+			for (; i < count; ++i)
+			{
+				T *value = slot(head + i);
+				*out++ = std::move(*value);
+				value->~T();
+			}
+		}
+		catch (...)
+		{
+			// Elements already handed out are gone, the failed one stays at the front
+			m_consumer.head.store(head + i, std::memory_order_release);
+			throw;
+		}
+		m_consumer.head.store(head + count, std::memory_order_release);
+		return count;
+	}
+
+	/// @brief Remove up to n front elements into a Store (consumer thread only)
+	/// @details Named apart from pop_front(T&) so RingStore<size_t> stays unambiguous.
+	/// @param n Maximum number of elements
+	/// @return Store with the removed elements
+	Store<T> pop_front_n(size_t n)
+	{
+		Store<T> result;
+		result.reserve(std::min(n, size()));
+		pop_front(std::back_inserter(result), n);
+		return result;
+	}
+};
+
+/// @brief Multi-producer multi-consumer ring, lock-free (bounded Vyukov queue)
+/// @details Every slot carries a sequence number telling whether it is ready
+///          for the producer or the consumer of a given lap. A thread claims a
+///          slot with one CAS on the shared index, then publishes it with a
+///          release store on the slot. Batch operations claim slots one by one.
+template <typename T>
+class RingStore<T, RingMode::mpmc>
+{
+  private:
+	// A claimed slot must be published whatever happens, or every thread that
+	// later reaches it waits forever; only nothrow moves touch claimed slots.
+	static_assert(std::is_nothrow_move_constructible_v<T>,
+				  "RingStore<T, RingMode::mpmc> requires a nothrow move constructible type");
+
+	struct Slot
+	{
+		std::atomic<size_t> sequence;
+		alignas(T) unsigned char storage[sizeof(T)];
+
+		T *value() noexcept { return std::launder(reinterpret_cast<T *>(storage)); }
+	};
+
+	const size_t m_capacity; // Power of two
+	const size_t m_mask;	 // m_capacity - 1
+	std::unique_ptr<Slot[]> m_slots;
+	alignas(k_ring_cache_line) std::atomic<size_t> m_tail{0}; // Next position to claim for push
+	alignas(k_ring_cache_line) std::atomic<size_t> m_head{0}; // Next position to claim for pop
+	static Errors s_error;									   // Error management
+
+	static size_t checked_capacity(size_t requested)
+	{
+		const size_t capacity = detail::ring_capacity(requested);
+		if (capacity == 0)
+		{
+			s_error.throw_invalid_argument();
+		}
+		return capacity;
+	}
+
+	/// @brief Claim a slot to write, or nullptr when full
+	Slot *claim_push(size_t &position) noexcept
+	{
+		position = m_tail.load(std::memory_order_relaxed);
+		for (;;)
+		{
+			Slot &cell = m_slots[position & m_mask];
+			const size_t sequence = cell.sequence.load(std::memory_order_acquire);
+			const auto diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position);
+			if (diff == 0)
+			{
+				if (m_tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+				{
+					return &cell;
+				}
+			}
+			else if (diff < 0)
+			{
+				return nullptr;
+			}
+			else
+			{
+				position = m_tail.load(std::memory_order_relaxed);
+			}
+		}
+	}
+
+	/// @brief Claim a slot to read, or nullptr when empty
+	Slot *claim_pop(size_t &position) noexcept
+	{
+		position = m_head.load(std::memory_order_relaxed);
+		for (;;)
+		{
+			Slot &cell = m_slots[position & m_mask];
+			const size_t sequence = cell.sequence.load(std::memory_order_acquire);
+			const auto diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position + 1);
+			if (diff == 0)
+			{
+				if (m_head.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+				{
+					return &cell;
+				}
+			}
+			else if (diff < 0)
+			{
+				return nullptr;
+			}
+			else
+			{
+				position = m_head.load(std::memory_order_relaxed);
+			}
+		}
+	}
+
+	/// @brief Move the value out of a claimed slot and release the slot
+	/// @details The slot is freed before the caller assigns the value anywhere,
+	///          so a throwing assignment loses that element but never the ring.
+	T take(Slot &cell, size_t position) noexcept
+	{
+		T *value = cell.value();
+		T result(std::move(*value));
+		value->~T();
+		cell.sequence.store(position + m_capacity, std::memory_order_release);
+		return result;
+	}
+
+  public:
+	// =======================
+	// Constructors & Destructor
+	// =======================
+
+	/// @brief Constructor with capacity
+	/// @param capacity Minimum number of elements (rounded up to a power of two)
+	/// @throws std::invalid_argument if capacity is zero or cannot be rounded up
+	explicit RingStore(size_t capacity)
+		: m_capacity(checked_capacity(capacity)), m_mask(m_capacity - 1), m_slots(new Slot[m_capacity])
+	{
+		for (size_t i = 0; i < m_capacity; ++i)
+		{
+			m_slots[i].sequence.store(i, std::memory_order_relaxed);
+		}
+	}
+
+	RingStore(const RingStore &) = delete;
+	RingStore &operator=(const RingStore &) = delete;
+
+	/// @brief Destructor, destroys remaining elements
+	~RingStore()
+	{
+		const size_t tail = m_tail.load(std::memory_order_acquire);
+		for (size_t i = m_head.load(std::memory_order_relaxed); i != tail; ++i)
+		{
+			m_slots[i & m_mask].value()->~T();
+		}
+	}
+
+	// =======================
+	// Capacity
+	// =======================
+
+	/// @brief Get capacity
+	/// @return Maximum number of elements
+	size_t capacity() const noexcept
+	{
+		return m_capacity;
+	}
+
+	/// @brief Get approximate number of elements
+	/// @return Claimed pushes minus claimed pops, clamped to [0, capacity]
+	size_t size() const noexcept
+	{
+		const size_t head = m_head.load(std::memory_order_acquire);
+		const size_t tail = m_tail.load(std::memory_order_acquire);
+		const auto diff = static_cast<std::ptrdiff_t>(tail - head);
+		return diff <= 0 ? 0 : std::min(static_cast<size_t>(diff), m_capacity);
+	}
+
+	/// @brief Check if ring is (approximately) empty
+	/// @return true if empty
+	bool empty() const noexcept
+	{
+		return size() == 0;
+	}
+
+	// =======================
+	// Producers
+	// =======================
+
+	/// @brief Emplace element at back (any thread)
+	/// @details When construction may throw, the element is built before a
+	///          slot is claimed, so a failure leaves the ring untouched.
+	/// @tparam Args Argument types
+	/// @param args Arguments to construct element
+	/// @return false if the ring is full
+	template <typename... Args>
+	bool emplace_back(Args &&... args)
+	{
+		if constexpr (std::is_nothrow_constructible_v<T, Args &&...>)
+		{
+			size_t position;
+			Slot *cell = claim_push(position);
+			if (!cell)
+			{
+				return false;
+			}
+			::new (static_cast<void *>(cell->storage)) T(std::forward<Args>(args)...);
+			cell->sequence.store(position + 1, std::memory_order_release);
+			return true;
+		}
+		else
+		{
+			// Build first: a throw must not happen after a slot is claimed
+			T value(std::forward<Args>(args)...);
+			return emplace_back(std::move(value));
+		}
+	}
+
+	/// @brief Add value at back (any thread)
+	/// @param value Value to add
+	/// @return false if the ring is full
+	bool push_back(const T &value)
+	{
+		return emplace_back(value);
+	}
+
+	/// @brief Add moved value at back (any thread)
+	/// @param value Value to move
+	/// @return false if the ring is full
+	bool push_back(T &&value)
+	{
+		return emplace_back(std::move(value));
+	}
+
+	/// @brief Add elements of a range until the ring is full (any thread)
+	/// @tparam Iterator Input iterator type
+	/// @param first Start of range
+	/// @param last End of range
+	/// @return Number of elements added
+	template <typename Iterator>
+	size_t push_back(Iterator first, Iterator last)
+	{
+		size_t added = 0;
+		for (; first != last && emplace_back(*first); ++first)
+		{
+			++added;
+		}
+		return added;
+	}
+
+	/// @brief Add elements of a container until the ring is full (any thread)
+	/// @tparam Container Container type
+	/// @param container Container to add from
+	/// @return Number of elements added
+	template <typename Container>
+	size_t push_back(const Container &container)
+	{
+		return push_back(container.begin(), container.end());
+	}
+
+	// =======================
+	// Consumers
+	// =======================
+
+	/// @brief Remove front element (any thread)
+	/// @param out Receives the element
+	/// @return false if the ring is empty
+	bool pop_front(T &out)
+	{
+		size_t position;
+		Slot *cell = claim_pop(position);
+		if (!cell)
+		{
+			return false;
+		}
+		out = take(*cell, position);
+		return true;
+	}
+
+	/// @brief Remove up to n front elements (any thread)
+	/// @tparam OutputIt Output iterator type
+	/// @param out Receives the elements
+	/// @param n Maximum number of elements
+	/// @return Number of elements removed
+	template <typename OutputIt>
+	size_t pop_front(OutputIt out, size_t n)
+	{
+		size_t count = 0;
+		size_t position;
+		for (Slot *cell; count < n && (cell = claim_pop(position)) != nullptr; ++count)
+		{
+			*out++ = take(*cell, position);
+		}
+		return count;
+	}
+
+	/// @brief Remove up to n front elements into a Store (any thread)
+	/// @details Named apart from pop_front(T&) so RingStore<size_t> stays unambiguous.
+	/// @param n Maximum number of elements
+	/// @return Store with the removed elements
+	Store<T> pop_front_n(size_t n)
+	{
+		Store<T> result;
+		result.reserve(std::min(n, m_capacity));
+		pop_front(std::back_inserter(result), n);
+		return result;
+	}
+};
+
+// =======================
+// Static Member Initialization
+// =======================
+template <typename T>
+Errors RingStore<T, RingMode::spsc>::s_error;
+
+template <typename T>
+Errors RingStore<T, RingMode::mpmc>::s_error;
+
+} // namespace adv
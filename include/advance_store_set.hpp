@@ -0,0 +1,422 @@
+#pragma once
+#include "advance_store.hpp"
+#include <functional>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define ADV_STORE_SET_SSE2 1
+#endif
+
+namespace adv
+{
+
+// =======================
+// Set Operation Kernels
+// =======================
+
+namespace detail
+{
+/// @brief Size ratio from which the small side is galloped through the large one
+inline constexpr size_t k_gallop_ratio = 32;
+
+/// @brief lower_bound starting at first, probing 1, 2, 4, ... ahead first
+/// @details O(log d) where d is the distance to the result, so walking a
+///          large sorted range with many gallops costs O(m log(n / m)).
+template <typename T, typename Compare>
+const T *gallop(const T *first, const T *last, const T &value, Compare &comp)
+{
+	size_t step = 1;
+	const T *low = first;
+	while (low + step < last && comp(low[step], value))
+	{
+		low += step;
+		step <<= 1;
+	}
+	const T *high = low + step < last ? low + step + 1 : last;
+	return std::lower_bound(low, high, value, comp);
+}
+
+/// @brief Which elements a set operation keeps
+struct SetKeep
+{
+	bool a_only;
+	bool b_only;
+	bool common;
+};
+
+/// @brief Linear merge walk (std::set_* multiset semantics)
+template <typename T, typename Alloc, typename Compare>
+void set_merge(const T *a, const T *a_end, const T *b, const T *b_end, Store<T, Alloc> &out, SetKeep keep,
+			   Compare &comp)
+{
+	while (a != a_end && b != b_end)
+	{
+		if (comp(*a, *b))
+		{
+			if (keep.a_only)
+			{
+				out.push_back(*a);
+			}
+			++a;
+		}
+		else if (comp(*b, *a))
+		{
+			if (keep.b_only)
+			{
+				out.push_back(*b);
+			}
+			++b;
+		}
+		else
+		{
+			if (keep.common)
+			{
+				out.push_back(*a);
+			}
+			++a;
+			++b;
+		}
+	}
+	for (; keep.a_only && a != a_end; ++a)
+	{
+		out.push_back(*a);
+	}
+	for (; keep.b_only && b != b_end; ++b)
+	{
+		out.push_back(*b);
+	}
+}
+
+/// @brief Walk the small side, galloping through the large side
+/// @details small_is_a tells which input the small side is, so that common
+///          elements are still taken from a as in the linear walk.
+template <typename T, typename Alloc, typename Compare>
+void set_gallop(const T *small, const T *small_end, const T *large, const T *large_end, bool small_is_a,
+				Store<T, Alloc> &out, SetKeep keep, Compare &comp)
+{
+	const bool keep_small = small_is_a ? keep.a_only : keep.b_only;
+	const bool keep_large = small_is_a ? keep.b_only : keep.a_only;
+	for (; small != small_end; ++small)
+	{
+		const T *next = gallop(large, large_end, *small, comp);
+		for (; keep_large && large != next; ++large)
+		{
+			out.push_back(*large);
+		}
+		large = next;
+		if (large != large_end && !comp(*small, *large))
+		{
+			if (keep.common)
+			{
+				out.push_back(small_is_a ? *small : *large);
+			}
+			++large;
+		}
+		else if (keep_small)
+		{
+			out.push_back(*small);
+		}
+	}
+	for (; keep_large && large != large_end; ++large)
+	{
+		out.push_back(*large);
+	}
+}
+
+#ifdef ADV_STORE_SET_SSE2
+/// @brief Branchless compaction of the lanes of a block whose bit is set in mask
+template <typename T>
+T *emit_lanes(const T *block, size_t lanes, int mask, T *dst) noexcept
+{
+	for (size_t lane = 0; lane < lanes; ++lane)
+	{
+		*dst = block[lane];
+		dst += (mask >> lane) & 1;
+	}
+	return dst;
+}
+
+/// @brief Scalar tail of the block kernels
+template <typename T>
+T *intersect_tail(const T *a, const T *a_end, const T *b, const T *b_end, T *dst) noexcept
+{
+	while (a != a_end && b != b_end)
+	{
+		if (*a < *b)
+		{
+			++a;
+		}
+		else if (*b < *a)
+		{
+			++b;
+		}
+		else
+		{
+			*dst++ = *a;
+			++a;
+			++b;
+		}
+	}
+	return dst;
+}
+
+/// @brief Intersection of strictly increasing 32-bit integer ranges, 4x4 blocks
+/// @return End of the output written at dst
+template <typename T>
+T *intersect_simd32(const T *a, const T *a_end, const T *b, const T *b_end, T *dst) noexcept
+{
+	while (a_end - a >= 4 && b_end - b >= 4)
+	{
+		const __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i *>(a));
+		const __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i *>(b));
+		// Compare every lane of a with every lane of b through rotations of b
+		__m128i eq = _mm_cmpeq_epi32(va, vb);
+		eq = _mm_or_si128(eq, _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(0, 3, 2, 1))));
+		eq = _mm_or_si128(eq, _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(1, 0, 3, 2))));
+		eq = _mm_or_si128(eq, _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(2, 1, 0, 3))));
+		dst = emit_lanes(a, 4, _mm_movemask_ps(_mm_castsi128_ps(eq)), dst);
+
+		const T a_max = a[3];
+		const T b_max = b[3];
+		a += a_max <= b_max ? 4 : 0;
+		b += b_max <= a_max ? 4 : 0;
+	}
+	return intersect_tail(a, a_end, b, b_end, dst);
+}
+
+/// @brief Intersection of strictly increasing 64-bit integer ranges, 2x2 blocks
+/// @return End of the output written at dst
+template <typename T>
+T *intersect_simd64(const T *a, const T *a_end, const T *b, const T *b_end, T *dst) noexcept
+{
+	while (a_end - a >= 2 && b_end - b >= 2)
+	{
+		const __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i *>(a));
+		const __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i *>(b));
+		const __m128i eq_same = _mm_cmpeq_epi32(va, vb);
+		const __m128i eq_swap = _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(1, 0, 3, 2)));
+		// SSE2 has no 64-bit compare: a lane matches when both 32-bit halves do
+		const __m128i eq = _mm_or_si128(_mm_and_si128(eq_same, _mm_shuffle_epi32(eq_same, _MM_SHUFFLE(2, 3, 0, 1))),
+										_mm_and_si128(eq_swap, _mm_shuffle_epi32(eq_swap, _MM_SHUFFLE(2, 3, 0, 1))));
+		dst = emit_lanes(a, 2, _mm_movemask_pd(_mm_castsi128_pd(eq)), dst);
+
+		const T a_max = a[1];
+		const T b_max = b[1];
+		a += a_max <= b_max ? 2 : 0;
+		b += b_max <= a_max ? 2 : 0;
+	}
+	return intersect_tail(a, a_end, b, b_end, dst);
+}
+#endif
+
+/// @brief Check if a sorted range has no equal neighbours
+template <typename T, typename Compare>
+bool strictly_sorted(const T *first, const T *last, Compare &comp)
+{
+	return std::adjacent_find(first, last, [&](const T &x, const T &y) { return !comp(x, y); }) == last;
+}
+
+/// @brief Validate inputs, pick a kernel and fill out
+template <typename T, typename Alloc, typename Compare>
+void set_operation(const Store<T, Alloc> &a, const Store<T, Alloc> &b, Store<T, Alloc> &out, SetKeep keep,
+				   Compare comp)
+{
+	constexpr SortOrder order = order_of<Compare, T>();
+	if (&out == &a || &out == &b)
+	{
+		Errors().throw_invalid_argument();
+	}
+	for (const auto *input : {&a, &b})
+	{
+		if ((order == SortOrder::unknown || input->sort_order() != order) &&
+			!std::is_sorted(input->begin(), input->end(), comp))
+		{
+			Errors().throw_invalid_argument();
+		}
+	}
+
+	const T *a_first = a.data();
+	const T *a_last = a_first + a.size();
+	const T *b_first = b.data();
+	const T *b_last = b_first + b.size();
+
+	size_t bound = 0;
+	if (keep.a_only)
+	{
+		bound += a.size();
+	}
+	if (keep.b_only)
+	{
+		bound += b.size();
+	}
+	if (keep.common && !keep.a_only && !keep.b_only)
+	{
+		bound = std::min(a.size(), b.size());
+	}
+
+	const size_t small = std::min(a.size(), b.size());
+	const size_t large = std::max(a.size(), b.size());
+	const bool gallop = small != 0 && large / small >= k_gallop_ratio;
+#ifdef ADV_STORE_SET_SSE2
+	constexpr bool k_block_type = std::is_integral_v<T> && (sizeof(T) == 4 || sizeof(T) == 8) &&
+								  order == SortOrder::ascending;
+#else
+	constexpr bool k_block_type = false;
+#endif
+	// The block kernels assume no duplicates inside an input
+	const bool block = k_block_type && !gallop && !keep.a_only && !keep.b_only && keep.common &&
+					   strictly_sorted(a_first, a_last, comp) && strictly_sorted(b_first, b_last, comp);
+
+	out.clear();
+	// emit_lanes stores one lane past the last match, so the block kernels need spare room
+	out.reserve(block ? bound + 4 : bound);
+
+	if (gallop)
+	{
+		if (a.size() <= b.size())
+		{
+			set_gallop(a_first, a_last, b_first, b_last, true, out, keep, comp);
+		}
+		else
+		{
+			set_gallop(b_first, b_last, a_first, a_last, false, out, keep, comp);
+		}
+	}
+	else if (block)
+	{
+#ifdef ADV_STORE_SET_SSE2
+		if constexpr (k_block_type)
+		{
+			// Write straight into the buffer, sized once within the reserved capacity
+			out.resize(bound + 4);
+			T *const dst = out.data();
+			T *dst_end;
+			if constexpr (sizeof(T) == 4)
+			{
+				dst_end = intersect_simd32(a_first, a_last, b_first, b_last, dst);
+			}
+			else
+			{
+				dst_end = intersect_simd64(a_first, a_last, b_first, b_last, dst);
+			}
+			out.resize(static_cast<size_t>(dst_end - dst));
+		}
+#endif
+	}
+	else
+	{
+		set_merge(a_first, a_last, b_first, b_last, out, keep, comp);
+	}
+	StoreAccess::set_sort_order(out, order);
+}
+} // namespace detail
+
+// =======================
+// Set Operations
+// =======================
+
+/// @brief Elements present in both sorted stores
+/// @details Multiset semantics of std::set_intersection. Skewed sizes use
+///          galloping search, strictly increasing 32/64-bit integer inputs
+///          use an SSE2 block kernel.
+/// @tparam T Element type
+/// @tparam Alloc Allocator type
+/// @tparam Compare Comparator type
+/// @param a First store, sorted by comp
+/// @param b Second store, sorted by comp
+/// @param out Output store, cleared first; its capacity is reused
+/// @param comp Ordering (default ascending)
+/// @throws std::invalid_argument if an input is not sorted or out aliases an input
+template <typename T, typename Alloc, typename Compare = std::less<T>>
+void intersect(const Store<T, Alloc> &a, const Store<T, Alloc> &b, Store<T, Alloc> &out, Compare comp = Compare())
+{
+	detail::set_operation(a, b, out, detail::SetKeep{false, false, true}, std::move(comp));
+}
+
+/// @brief Elements present in either sorted store
+/// @tparam T Element type
+/// @tparam Alloc Allocator type
+/// @tparam Compare Comparator type
+/// @param a First store, sorted by comp
+/// @param b Second store, sorted by comp
+/// @param out Output store, cleared first; its capacity is reused
+/// @param comp Ordering (default ascending)
+/// @throws std::invalid_argument if an input is not sorted or out aliases an input
+template <typename T, typename Alloc, typename Compare = std::less<T>>
+void unite(const Store<T, Alloc> &a, const Store<T, Alloc> &b, Store<T, Alloc> &out, Compare comp = Compare())
+{
+	detail::set_operation(a, b, out, detail::SetKeep{true, true, true}, std::move(comp));
+}
+
+/// @brief Elements of a not present in b
+/// @tparam T Element type
+/// @tparam Alloc Allocator type
+/// @tparam Compare Comparator type
+/// @param a First store, sorted by comp
+/// @param b Second store, sorted by comp
+/// @param out Output store, cleared first; its capacity is reused
+/// @param comp Ordering (default ascending)
+/// @throws std::invalid_argument if an input is not sorted or out aliases an input
+template <typename T, typename Alloc, typename Compare = std::less<T>>
+void difference(const Store<T, Alloc> &a, const Store<T, Alloc> &b, Store<T, Alloc> &out, Compare comp = Compare())
+{
+	detail::set_operation(a, b, out, detail::SetKeep{true, false, false}, std::move(comp));
+}
+
+/// @brief Elements present in exactly one of the sorted stores
+/// @tparam T Element type
+/// @tparam Alloc Allocator type
+/// @tparam Compare Comparator type
+/// @param a First store, sorted by comp
+/// @param b Second store, sorted by comp
+/// @param out Output store, cleared first; its capacity is reused
+/// @param comp Ordering (default ascending)
+/// @throws std::invalid_argument if an input is not sorted or out aliases an input
+template <typename T, typename Alloc, typename Compare = std::less<T>>
+void symmetric_difference(const Store<T, Alloc> &a, const Store<T, Alloc> &b, Store<T, Alloc> &out,
+						  Compare comp = Compare())
+{
+	detail::set_operation(a, b, out, detail::SetKeep{true, true, false}, std::move(comp));
+}
+
+/// @brief Elements present in both ascending stores
+/// @return New ascending store
+template <typename T, typename Alloc>
+Store<T, Alloc> intersect(const Store<T, Alloc> &a, const Store<T, Alloc> &b)
+{
+	Store<T, Alloc> out(a.get_allocator());
+	intersect(a, b, out);
+	return out;
+}
+
+/// @brief Elements present in either ascending store
+/// @return New ascending store
+template <typename T, typename Alloc>
+Store<T, Alloc> unite(const Store<T, Alloc> &a, const Store<T, Alloc> &b)
+{
+	Store<T, Alloc> out(a.get_allocator());
+	unite(a, b, out);
+	return out;
+}
+
+/// @brief Elements of ascending store a not present in b
+/// @return New ascending store
+template <typename T, typename Alloc>
+Store<T, Alloc> difference(const Store<T, Alloc> &a, const Store<T, Alloc> &b)
+{
+	Store<T, Alloc> out(a.get_allocator());
+	difference(a, b, out);
+	return out;
+}
+
+/// @brief Elements present in exactly one of the ascending stores
+/// @return New ascending store
+template <typename T, typename Alloc>
+Store<T, Alloc> symmetric_difference(const Store<T, Alloc> &a, const Store<T, Alloc> &b)
+{
+	Store<T, Alloc> out(a.get_allocator());
+	symmetric_difference(a, b, out);
+	return out;
+}
+
+} // namespace adv
@@ -0,0 +1,334 @@
+#pragma once
+#include "advance_store.hpp"
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace adv
+{
+
+// =======================
+// ShardedStore Template Class
+// =======================
+
+/// @brief Store made of one private shard per producer thread
+/// @details Appends go to the calling thread's shard without locks or shared
+///          writes; shards are cache-line aligned so producers never false
+///          share. collect() concatenates the shards with one reservation,
+///          collect_sorted() k-way merges them. Reading functions (size,
+///          collect, filter, ...) must not run concurrently with appends.
+/// @tparam T Element type
+template <typename T>
+class ShardedStore
+{
+  private:
+	/// @brief Per-thread shard, padded to its own cache lines
+	struct alignas(64) Shard
+	{
+		Store<T> data;
+		std::thread::id owner;
+	};
+
+	/// @brief Thread-local (store id -> shard) cache entry
+	struct CacheEntry
+	{
+		uint64_t store_id = 0;
+		Shard *shard = nullptr;
+	};
+
+	static constexpr size_t k_cache_size = 8; // Stores remembered per thread
+
+	mutable std::mutex m_mutex;			 // Guards m_shards (registration only)
+	vector<std::unique_ptr<Shard>> m_shards; // All shards, in registration order
+	uint64_t m_id;						 // Never reused, keys the thread-local cache
+
+	static uint64_t next_id() noexcept
+	{
+		static std::atomic<uint64_t> s_next{1};
+		return s_next.fetch_add(1, std::memory_order_relaxed);
+	}
+
+  public:
+	// =======================
+	// Constructors & Destructor
+	// =======================
+
+	/// @brief Default constructor
+	ShardedStore() : m_id(next_id()) {}
+
+	ShardedStore(const ShardedStore &) = delete;
+	ShardedStore &operator=(const ShardedStore &) = delete;
+
+	// =======================
+	// Adding Elements (thread-safe)
+	// =======================
+
+	/// @brief Get the calling thread's shard
+	/// @details First call per thread registers a shard under a mutex; later
+	///          calls hit a thread-local cache.
+	/// @return Reference to the private shard
+	Store<T> &local()
+	{
+		thread_local CacheEntry t_cache[k_cache_size];
+		thread_local size_t t_next = 0;
+
+		for (const auto &entry : t_cache)
+		{
+			if (entry.store_id == m_id)
+			{
+				return entry.shard->data;
+			}
+		}
+
+		Shard *shard = find_or_register();
+		t_cache[t_next] = CacheEntry{m_id, shard};
+		t_next = (t_next + 1) % k_cache_size;
+		return shard->data;
+	}
+
+	/// @brief Add value to the calling thread's shard
+	/// @param value Value to add
+	void push_back(const T &value)
+	{
+		local().push_back(value);
+	}
+
+	/// @brief Add moved value to the calling thread's shard
+	/// @param value Value to move
+	void push_back(T &&value)
+	{
+		local().push_back(std::move(value));
+	}
+
+	/// @brief Emplace element in the calling thread's shard
+	/// @tparam Args Argument types
+	/// @param args Arguments to construct element
+	template <typename... Args>
+	void emplace_back(Args &&... args)
+	{
+		local().emplace_back(std::forward<Args>(args)...);
+	}
+
+	// =======================
+	// Capacity (quiescent)
+	// =======================
+
+	/// @brief Get total number of elements over all shards
+	/// @return Number of elements
+	size_t size() const
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		size_t total = 0;
+		for (const auto &shard : m_shards)
+		{
+			total += shard->data.size();
+		}
+		return total;
+	}
+
+	/// @brief Check if every shard is empty
+	/// @return true if empty
+	bool empty() const
+	{
+		return size() == 0;
+	}
+
+	/// @brief Get number of registered shards
+	/// @return Shard count
+	size_t shard_count() const
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		return m_shards.size();
+	}
+
+	/// @brief Clear every shard, shards stay registered
+	void clear()
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		for (auto &shard : m_shards)
+		{
+			shard->data.clear();
+		}
+	}
+
+	// =======================
+	// Collecting (quiescent)
+	// =======================
+
+	/// @brief Move all shards into one Store, in shard registration order
+	/// @details Reserves the exact total once, then empties the shards.
+	/// @return Store with every element
+	Store<T> collect()
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		size_t total = 0;
+		for (const auto &shard : m_shards)
+		{
+			total += shard->data.size();
+		}
+
+		Store<T> result;
+		result.reserve(total);
+		for (auto &shard : m_shards)
+		{
+			for (auto &value : shard->data)
+			{
+				result.push_back(std::move(value));
+			}
+			shard->data.clear();
+		}
+		return result;
+	}
+
+	/// @brief Sort every shard, then k-way merge them into one Store
+	/// @details Shards that are already sorted by comp are not re-sorted.
+	///          Empties the shards.
+	/// @tparam Compare Comparator type
+	/// @param comp Ordering (default ascending)
+	/// @return Sorted Store with every element
+	template <typename Compare = std::less<T>>
+	Store<T> collect_sorted(Compare comp = Compare())
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		size_t total = 0;
+		vector<Store<T> *> runs;
+		for (auto &shard : m_shards)
+		{
+			Store<T> &data = shard->data;
+			if (data.empty())
+			{
+				continue;
+			}
+			if (!std::is_sorted(data.begin(), data.end(), comp))
+			{
+				data.sort(comp);
+			}
+			total += data.size();
+			runs.push_back(&data);
+		}
+
+		// Min-heap of (run, position), ordered by the run's current head
+		vector<std::pair<size_t, size_t>> heap;
+		heap.reserve(runs.size());
+		for (size_t i = 0; i < runs.size(); ++i)
+		{
+			heap.emplace_back(i, 0);
+		}
+		const auto greater = [&](const std::pair<size_t, size_t> &a, const std::pair<size_t, size_t> &b) {
+			return comp((*runs[b.first])[b.second], (*runs[a.first])[a.second]);
+		};
+		std::make_heap(heap.begin(), heap.end(), greater);
+
+		Store<T> result;
+		result.reserve(total);
+		while (!heap.empty())
+		{
+			std::pop_heap(heap.begin(), heap.end(), greater);
+			auto &head = heap.back();
+			result.push_back(std::move((*runs[head.first])[head.second]));
+			if (++head.second < runs[head.first]->size())
+			{
+				std::push_heap(heap.begin(), heap.end(), greater);
+			}
+			else
+			{
+				heap.pop_back();
+			}
+		}
+
+		for (auto *run : runs)
+		{
+			run->clear();
+		}
+		return result;
+	}
+
+	// =======================
+	// Algorithms (quiescent)
+	// =======================
+
+	/// @brief Visit every element, shard by shard
+	/// @tparam Func Function type
+	/// @param func Function called with each element
+	template <typename Func>
+	void for_each(Func func) const
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		for (const auto &shard : m_shards)
+		{
+			for (const auto &value : shard->data)
+			{
+				func(value);
+			}
+		}
+	}
+
+	/// @brief Filter elements of every shard without collecting first
+	/// @tparam Pred Predicate type
+	/// @param pred Predicate function
+	/// @return New store with matching elements, in collect() order
+	template <typename Pred>
+	Store<T> filter(Pred pred) const
+	{
+		Store<T> result;
+		for_each([&](const T &value) {
+			if (pred(value))
+			{
+				result.push_back(value);
+			}
+		});
+		return result;
+	}
+
+	/// @brief Find all positions satisfying predicate
+	/// @tparam Pred Predicate type
+	/// @param pred Predicate function
+	/// @return Positions in the order collect() would produce
+	template <typename Pred>
+	vector<size_t> find_all_if(Pred pred) const
+	{
+		vector<size_t> positions;
+		size_t index = 0;
+		for_each([&](const T &value) {
+			if (pred(value))
+			{
+				positions.push_back(index);
+			}
+			++index;
+		});
+		return positions;
+	}
+
+	/// @brief Count elements satisfying predicate
+	/// @tparam Pred Predicate type
+	/// @param pred Predicate function
+	/// @return Number of matching elements
+	template <typename Pred>
+	size_t count_if(Pred pred) const
+	{
+		size_t count = 0;
+		for_each([&](const T &value) { count += pred(value) ? 1 : 0; });
+		return count;
+	}
+
+  private:
+	Shard *find_or_register()
+	{
+		const std::thread::id self = std::this_thread::get_id();
+		std::lock_guard<std::mutex> lock(m_mutex);
+		for (const auto &shard : m_shards)
+		{
+			if (shard->owner == self)
+			{
+				return shard.get();
+			}
+		}
+		m_shards.push_back(std::make_unique<Shard>());
+		m_shards.back()->owner = self;
+		return m_shards.back().get();
+	}
+};
+
+} // namespace adv
@@ -0,0 +1,372 @@
+#pragma once
+#include "advance_store.hpp"
+#include <atomic>
+#include <cassert>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace adv
+{
+
+// =======================
+// Epoch-Based Reclamation
+// =======================
+
+namespace detail
+{
+/// @brief Per-thread epoch record, one per cache line
+struct alignas(64) EpochRecord
+{
+	std::atomic<uint64_t> epoch{0};	  // Epoch observed when the thread pinned
+	std::atomic<bool> active{false};  // Thread is inside a read section
+	std::atomic<bool> in_use{false};  // Record is owned by a live thread
+	unsigned depth = 0;				  // Nesting of pins, owner thread only
+};
+
+/// @brief Process-wide epoch state shared by every SnapshotStore
+/// @details Readers publish the global epoch in their record while they hold
+///          a snapshot. Retired objects are freed once every active reader
+///          has moved past the epoch in which they were retired.
+class EpochDomain
+{
+  private:
+	struct Retired
+	{
+		uint64_t epoch;
+		std::function<void()> deleter;
+	};
+
+	std::atomic<uint64_t> m_epoch{1};
+	std::mutex m_mutex; // Guards m_records growth and m_retired
+	vector<std::unique_ptr<EpochRecord>> m_records;
+	std::atomic<size_t> m_record_count{0};
+	vector<Retired> m_retired;
+	std::atomic<size_t> m_pending{0}; // m_retired.size(), readable without the mutex
+
+  public:
+	static EpochDomain &instance()
+	{
+		// Leaked on purpose so thread_local records may outlive static destruction
+		static EpochDomain *s_instance = new EpochDomain();
+		return *s_instance;
+	}
+
+	EpochRecord *acquire_record()
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		for (size_t i = 0; i < m_records.size(); ++i)
+		{
+			bool expected = false;
+			if (m_records[i]->in_use.compare_exchange_strong(expected, true))
+			{
+				return m_records[i].get();
+			}
+		}
+		m_records.push_back(std::make_unique<EpochRecord>());
+		m_records.back()->in_use.store(true);
+		m_record_count.store(m_records.size(), std::memory_order_release);
+		return m_records.back().get();
+	}
+
+	void release_record(EpochRecord *record) noexcept
+	{
+		record->in_use.store(false, std::memory_order_release);
+	}
+
+	/// @brief Enter a read section (lock-free)
+	void pin(EpochRecord &record) noexcept
+	{
+		if (record.depth++ == 0)
+		{
+			record.active.store(true, std::memory_order_seq_cst);
+			record.epoch.store(m_epoch.load(std::memory_order_seq_cst), std::memory_order_seq_cst);
+		}
+	}
+
+	/// @brief Leave a read section
+	/// @details Leaving the outermost section frees whatever that section was
+	///          holding back, unless another thread is already collecting.
+	void unpin(EpochRecord &record) noexcept
+	{
+		if (--record.depth == 0)
+		{
+			record.active.store(false, std::memory_order_seq_cst);
+			if (m_pending.load(std::memory_order_relaxed) != 0)
+			{
+				try_collect();
+			}
+		}
+	}
+
+	/// @brief Defer destruction until no reader can still see the object
+	/// @param deleter Function freeing the object
+	void retire(std::function<void()> deleter)
+	{
+		const uint64_t epoch = m_epoch.fetch_add(1, std::memory_order_seq_cst);
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_retired.push_back(Retired{epoch, std::move(deleter)});
+			m_pending.store(m_retired.size(), std::memory_order_relaxed);
+		}
+		collect();
+	}
+
+	/// @brief Free every retired object no active reader can reach
+	void collect()
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		reclaim(lock);
+	}
+
+	/// @brief Like collect(), but returns at once if the domain is busy
+	void try_collect() noexcept
+	{
+		std::unique_lock<std::mutex> lock(m_mutex, std::try_to_lock);
+		if (!lock.owns_lock())
+		{
+			return;
+		}
+		try
+		{
+			reclaim(lock);
+		}
+		catch (...)
+		{
+			// Out of memory for the ready list, the next retire() or unpin retries
+		}
+	}
+
+	/// @brief Number of objects waiting for reclamation
+	size_t pending()
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		return m_retired.size();
+	}
+
+  private:
+	/// @brief Split off reclaimable objects under the lock, free them after it
+	/// @param lock Held lock on m_mutex, released before running deleters
+	void reclaim(std::unique_lock<std::mutex> &lock)
+	{
+		uint64_t oldest = m_epoch.load(std::memory_order_seq_cst);
+		for (const auto &record : m_records)
+		{
+			if (record->active.load(std::memory_order_seq_cst))
+			{
+				oldest = std::min(oldest, record->epoch.load(std::memory_order_seq_cst));
+			}
+		}
+		auto it = std::partition(m_retired.begin(), m_retired.end(),
+								 [&](const Retired &r) { return r.epoch >= oldest; });
+		vector<Retired> ready(std::make_move_iterator(it), std::make_move_iterator(m_retired.end()));
+		m_retired.erase(it, m_retired.end());
+		m_pending.store(m_retired.size(), std::memory_order_relaxed);
+		lock.unlock();
+		for (auto &retired : ready)
+		{
+			retired.deleter();
+		}
+	}
+};
+
+/// @brief Thread-local owner of an epoch record
+struct EpochRecordHandle
+{
+	EpochRecord *record = EpochDomain::instance().acquire_record();
+
+	~EpochRecordHandle()
+	{
+		EpochDomain::instance().release_record(record);
+	}
+};
+
+inline EpochRecord &local_epoch_record()
+{
+	thread_local EpochRecordHandle s_handle;
+	return *s_handle.record;
+}
+} // namespace detail
+
+// =======================
+// SnapshotStore Template Class
+// =======================
+
+/// @brief Read-mostly store with lock-free immutable snapshots (RCU style)
+/// @details Readers load the current version through an atomic pointer and
+///          keep it alive with an epoch pin, no lock and no reference count
+///          write on shared data. Writers copy the current version, modify
+///          the copy and publish it; old versions are freed by epoch-based
+///          reclamation once no reader can still hold them. Writers are
+///          serialized by a mutex.
+/// @tparam T Element type
+template <typename T>
+class SnapshotStore
+{
+  private:
+	std::atomic<const Store<T> *> m_current; // Published version
+	std::mutex m_write_mutex;				 // Serializes writers
+	std::atomic<uint64_t> m_version{0};		 // Number of publications
+
+  public:
+	/// @brief Pinned, immutable view of one version
+	/// @details Keep handles short-lived: an open handle delays reclamation of
+	///          every version retired after it was taken. A snapshot pins the
+	///          epoch record of the thread that took it, so it must be destroyed
+	///          on that thread; it may be moved, but not handed to another
+	///          thread (checked by assert in debug builds).
+	class Snapshot
+	{
+	  private:
+		const Store<T> *m_store = nullptr;
+		detail::EpochRecord *m_record = nullptr;
+#ifndef NDEBUG
+		std::thread::id m_owner = std::this_thread::get_id();
+#endif
+
+	  public:
+		Snapshot(const Store<T> *store, detail::EpochRecord *record) : m_store(store), m_record(record) {}
+
+		Snapshot(const Snapshot &) = delete;
+		Snapshot &operator=(const Snapshot &) = delete;
+
+		Snapshot(Snapshot &&other) noexcept : m_store(other.m_store), m_record(other.m_record)
+		{
+			other.m_record = nullptr;
+#ifndef NDEBUG
+			m_owner = other.m_owner;
+#endif
+		}
+
+		~Snapshot()
+		{
+			if (m_record)
+			{
+				assert(m_owner == std::this_thread::get_id() && "Snapshot destroyed on a thread that did not take it");
+				detail::EpochDomain::instance().unpin(*m_record);
+			}
+		}
+
+		const Store<T> &operator*() const noexcept { return *m_store; }
+		const Store<T> *operator->() const noexcept { return m_store; }
+		const Store<T> &get() const noexcept { return *m_store; }
+	};
+
+	// =======================
+	// Constructors & Destructor
+	// =======================
+
+	/// @brief Default constructor, publishes an empty version
+	SnapshotStore() : m_current(new Store<T>()) {}
+
+	/// @brief Constructor with initial contents
+	/// @param initial First version
+	explicit SnapshotStore(Store<T> initial) : m_current(new Store<T>(std::move(initial))) {}
+
+	SnapshotStore(const SnapshotStore &) = delete;
+	SnapshotStore &operator=(const SnapshotStore &) = delete;
+
+	/// @brief Destructor
+	/// @details No reader may hold a snapshot of this store any more.
+	~SnapshotStore()
+	{
+		delete m_current.load(std::memory_order_acquire);
+		detail::EpochDomain::instance().collect();
+	}
+
+	// =======================
+	// Readers (lock-free)
+	// =======================
+
+	/// @brief Get a pinned snapshot of the current version
+	/// @return Snapshot handle, valid until destroyed
+	Snapshot snapshot() const
+	{
+		detail::EpochRecord &record = detail::local_epoch_record();
+		detail::EpochDomain::instance().pin(record);
+		return Snapshot(m_current.load(std::memory_order_acquire), &record);
+	}
+
+	/// @brief Run a function on the current version inside a read section
+	/// @tparam Func Function type
+	/// @param func Function called with const Store<T>&
+	/// @return Whatever func returns
+	template <typename Func>
+	auto read(Func func) const
+	{
+		const Snapshot snap = snapshot();
+		return func(*snap);
+	}
+
+	/// @brief Check if current version contains value
+	/// @param value Value to search for
+	/// @return true if value found
+	bool contains(const T &value) const
+	{
+		return read([&](const Store<T> &store) { return store.contains(value); });
+	}
+
+	/// @brief Find all positions of value in the current version
+	/// @param value Value to find
+	/// @return Positions where value appears
+	vector<size_t> find_all(const T &value) const
+	{
+		return read([&](const Store<T> &store) { return store.find_all(value); });
+	}
+
+	/// @brief Get size of the current version
+	/// @return Number of elements
+	size_t size() const
+	{
+		return read([](const Store<T> &store) { return store.size(); });
+	}
+
+	/// @brief Get number of versions published since construction
+	/// @return Publication count
+	uint64_t version() const noexcept
+	{
+		return m_version.load(std::memory_order_acquire);
+	}
+
+	// =======================
+	// Writers (serialized)
+	// =======================
+
+	/// @brief Copy the current version, modify the copy, publish it
+	/// @tparam Func Function type
+	/// @param func Function called with Store<T>& (the new version)
+	template <typename Func>
+	void update(Func func)
+	{
+		std::lock_guard<std::mutex> lock(m_write_mutex);
+		auto next = std::make_unique<Store<T>>(*m_current.load(std::memory_order_acquire));
+		func(*next);
+		publish_locked(next.release());
+	}
+
+	/// @brief Replace the whole contents with a new version
+	/// @param next New version
+	void publish(Store<T> next)
+	{
+		std::lock_guard<std::mutex> lock(m_write_mutex);
+		publish_locked(new Store<T>(std::move(next)));
+	}
+
+	/// @brief Add value (copies the current version)
+	/// @param value Value to add
+	void push_back(const T &value)
+	{
+		update([&](Store<T> &store) { store.push_back(value); });
+	}
+
+  private:
+	void publish_locked(const Store<T> *next)
+	{
+		const Store<T> *old = m_current.exchange(next, std::memory_order_acq_rel);
+		m_version.fetch_add(1, std::memory_order_release);
+		detail::EpochDomain::instance().retire([old] { delete old; });
+	}
+};
+
+} // namespace adv
@@ -0,0 +1,68 @@
+/**
+ * @file test_check.hpp
+ * @brief Bộ kiểm tra tối giản dùng chung cho các chương trình trong tests/
+ *
+ * Mỗi file test là một chương trình độc lập: CHECK ghi lại lỗi (không dừng
+ * như assert, không bị NDEBUG tắt), main trả về 0 khi mọi CHECK đều đúng.
+ */
+
+#pragma once
+#include <cstdio>
+#include <cstdlib>
+
+namespace test
+{
+
+// =======================
+// Harness
+// =======================
+
+/// @brief Number of failed checks so far
+inline int &failures()
+{
+	static int s_failures = 0;
+	return s_failures;
+}
+
+/// @brief Record one check, printing the location when it fails
+/// @param ok Result of the checked expression
+/// @param expr Expression text
+/// @param file Source file
+/// @param line Source line
+inline void check(bool ok, const char *expr, const char *file, int line)
+{
+	if (!ok)
+	{
+		++failures();
+		std::fprintf(stderr, "%s:%d: CHECK failed: %s\n", file, line, expr);
+	}
+}
+
+/// @brief Run one named test case
+/// @tparam Body Callable without arguments
+/// @param name Printed test name
+/// @param body Test body
+template <typename Body>
+void run(const char *name, Body body)
+{
+	const int before = failures();
+	body();
+	std::printf("%-40s %s\n", name, failures() == before ? "ok" : "FAILED");
+}
+
+/// @brief Print the summary
+/// @return Process exit code (0 when every check passed)
+inline int report()
+{
+	if (failures() != 0)
+	{
+		std::printf("%d check(s) failed\n", failures());
+		return EXIT_FAILURE;
+	}
+	std::printf("all checks passed\n");
+	return EXIT_SUCCESS;
+}
+
+} // namespace test
+
+#define CHECK(expr) ::test::check(static_cast<bool>(expr), #expr, __FILE__, __LINE__)
@@ -0,0 +1,405 @@
+/**
+ * @file test_concurrent.cpp
+ * @brief Kiểm tra các kiểu đa luồng
+ *
+ * Mỗi test chạy nhiều luồng ghi/đọc cùng lúc rồi so kết quả với giá trị tính
+ * trước (số phần tử, không mất/không trùng). Nên chạy dưới ThreadSanitizer để
+ * phát hiện data race, kể cả khi kết quả vẫn đúng.
+ *
+ * Build & chạy (TSan):
+ *   g++ -std=c++17 -O1 -g -fsanitize=thread -I<thư mục chứa advance/> tests/test_concurrent.cpp -o test_concurrent -pthread && ./test_concurrent
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include "advance/store/include/advance_store_concurrent.hpp"
+#include "advance/store/include/advance_store_ring.hpp"
+#include "advance/store/include/advance_store_sharded.hpp"
+#include "advance/store/include/advance_store_snapshot.hpp"
+#include "test_check.hpp"
+
+// =======================
+// Array Allocation Hook
+// =======================
+// ConcurrentStore allocates its segments with new[], standard containers never
+// do, so counting and failing new[] targets exactly the segment allocations.
+
+namespace
+{
+std::atomic<size_t> g_array_news{0};
+std::atomic<bool> g_fail_array_new{false};
+} // namespace
+
+void *operator new[](size_t bytes)
+{
+	if (g_fail_array_new.load())
+	{
+		throw std::bad_alloc();
+	}
+	g_array_news.fetch_add(1);
+	if (void *ptr = std::malloc(bytes ? bytes : 1))
+	{
+		return ptr;
+	}
+	throw std::bad_alloc();
+}
+
+void operator delete[](void *ptr) noexcept
+{
+	std::free(ptr);
+}
+
+void operator delete[](void *ptr, size_t) noexcept
+{
+	std::free(ptr);
+}
+
+namespace
+{
+
+const size_t k_threads = 4;
+const size_t k_per_thread = 20000;
+
+/// @brief Start count threads running body(thread index) and join them
+template <typename Body>
+void run_threads(size_t count, Body body)
+{
+	std::vector<std::thread> threads;
+	for (size_t t = 0; t < count; ++t)
+	{
+		threads.emplace_back(body, t);
+	}
+	for (std::thread &thread : threads)
+	{
+		thread.join();
+	}
+}
+
+/// @brief Check that values hold each of 0..count-1 exactly once
+bool is_permutation_of_iota(std::vector<size_t> values, size_t count)
+{
+	if (values.size() != count)
+	{
+		return false;
+	}
+	std::sort(values.begin(), values.end());
+	for (size_t i = 0; i < count; ++i)
+	{
+		if (values[i] != i)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+} // namespace
+
+int main()
+{
+	test::run("ConcurrentStore producers and readers", [] {
+		adv::ConcurrentStore<size_t> store;
+		const size_t news_before = g_array_news.load();
+		std::atomic<bool> done{false};
+		std::atomic<size_t> bad_reads{0};
+		std::thread reader([&] {
+			// The published prefix only grows and every value in it is complete
+			size_t last = 0;
+			while (!done.load(std::memory_order_acquire))
+			{
+				const auto view = store.published();
+				if (view.size() < last)
+				{
+					++bad_reads;
+				}
+				last = view.size();
+				for (const size_t value : view)
+				{
+					if (value >= k_threads * k_per_thread)
+					{
+						++bad_reads;
+					}
+				}
+			}
+		});
+		run_threads(k_threads, [&](size_t t) {
+			for (size_t i = 0; i < k_per_thread; ++i)
+			{
+				store.push_back(t * k_per_thread + i);
+			}
+		});
+		done.store(true, std::memory_order_release);
+		reader.join();
+		CHECK(bad_reads.load() == 0);
+		CHECK(store.size() == k_threads * k_per_thread);
+
+		// Exactly one allocation per segment: 32 << k slots for k = 0..11 hold 80000
+		CHECK(g_array_news.load() - news_before == 12);
+
+		const adv::Store<size_t> frozen = store.freeze();
+		CHECK(is_permutation_of_iota(std::vector<size_t>(frozen.begin(), frozen.end()), k_threads * k_per_thread));
+		CHECK(store.empty() && store.reserved_size() == 0);
+	});
+
+	test::run("ConcurrentStore failed segment seals", [] {
+		adv::ConcurrentStore<size_t> store;
+		for (size_t i = 0; i < 32; ++i) // Fills segment 0
+		{
+			store.push_back(i);
+		}
+		g_fail_array_new.store(true);
+		std::atomic<size_t> failures{0};
+		run_threads(k_threads, [&](size_t) {
+			for (int i = 0; i < 10; ++i)
+			{
+				try
+				{
+					store.push_back(0);
+				}
+				catch (const std::bad_alloc &)
+				{
+					++failures;
+				}
+			}
+		});
+		g_fail_array_new.store(false);
+
+		// Every push past segment 0 failed and nothing waits for a hole
+		CHECK(failures.load() == k_threads * 10);
+		CHECK(store.size() == 32);
+		bool threw = false;
+		try
+		{
+			store.push_back(99);
+		}
+		catch (const std::bad_alloc &)
+		{
+			threw = true;
+		}
+		CHECK(threw);
+		const adv::Store<size_t> frozen = store.freeze();
+		CHECK(frozen.size() == 32 && frozen[31] == 31);
+
+		// The emptied store accepts pushes again
+		store.push_back(7);
+		CHECK(store.size() == 1 && store.published()[0] == 7);
+	});
+
+	test::run("ShardedStore collect", [] {
+		adv::ShardedStore<size_t> store;
+		run_threads(k_threads, [&](size_t t) {
+			for (size_t i = 0; i < k_per_thread; ++i)
+			{
+				store.push_back(t * k_per_thread + i);
+			}
+		});
+		CHECK(store.size() == k_threads * k_per_thread);
+		CHECK(store.shard_count() == k_threads);
+		CHECK(store.count_if([](size_t value) { return value % 2 == 0; }) == k_threads * k_per_thread / 2);
+		CHECK(store.find_all_if([](size_t value) { return value < 10; }).size() == 10);
+		const adv::Store<size_t> sorted = store.collect_sorted();
+		CHECK(std::is_sorted(sorted.begin(), sorted.end()));
+		CHECK(is_permutation_of_iota(std::vector<size_t>(sorted.begin(), sorted.end()), k_threads * k_per_thread));
+		CHECK(store.empty());
+
+		// collect() keeps each shard's push order
+		run_threads(k_threads, [&](size_t t) {
+			for (size_t i = 0; i < 100; ++i)
+			{
+				store.push_back(t * 100 + i);
+			}
+		});
+		const adv::Store<size_t> collected = store.collect();
+		bool in_order = collected.size() == k_threads * 100;
+		for (size_t i = 1; i < collected.size() && in_order; ++i)
+		{
+			in_order = i % 100 == 0 || collected[i] == collected[i - 1] + 1;
+		}
+		CHECK(in_order);
+	});
+
+	test::run("ShardedStore shards are per store", [] {
+		// Two stores used by the same thread must not share its cached shard
+		adv::ShardedStore<int> first;
+		adv::ShardedStore<int> second;
+		first.push_back(1);
+		second.push_back(2);
+		second.push_back(3);
+		CHECK(first.size() == 1 && second.size() == 2);
+		CHECK(first.collect()[0] == 1);
+	});
+
+	test::run("SnapshotStore readers during updates", [] {
+		adv::Store<int> initial(1000);
+		std::iota(initial.begin(), initial.end(), 0);
+		adv::SnapshotStore<int> store(std::move(initial));
+		std::atomic<bool> done{false};
+		std::atomic<size_t> bad_reads{0};
+		run_threads(k_threads + 1, [&](size_t t) {
+			if (t == 0)
+			{
+				// Writer: every version is 0..n-1, so readers can verify it
+				for (int n = 1001; n <= 1200; ++n)
+				{
+					store.update([n](adv::Store<int> &next) { next.push_back(n - 1); });
+				}
+				done.store(true, std::memory_order_release);
+				return;
+			}
+			while (!done.load(std::memory_order_acquire))
+			{
+				const bool ok = store.read([](const adv::Store<int> &version) {
+					const int n = static_cast<int>(version.size());
+					long long total = 0;
+					for (const int value : version)
+					{
+						total += value;
+					}
+					return version.contains(n - 1) && !version.contains(n) && total == 1LL * n * (n - 1) / 2;
+				});
+				if (!ok)
+				{
+					++bad_reads;
+				}
+				std::this_thread::yield();
+			}
+		});
+		CHECK(bad_reads.load() == 0);
+		CHECK(store.size() == 1200);
+		CHECK(store.version() == 200);
+	});
+
+	test::run("SnapshotStore pin outlives updates", [] {
+		adv::detail::EpochDomain &domain = adv::detail::EpochDomain::instance();
+		adv::SnapshotStore<int> store(adv::Store<int>{1, 2, 3});
+		{
+			const auto pinned = store.snapshot();
+			store.push_back(4);
+			store.publish(adv::Store<int>{9});
+			// The old versions cannot be freed while the snapshot is open
+			CHECK(domain.pending() >= 1);
+			CHECK(pinned->size() == 3 && (*pinned)[2] == 3);
+			CHECK(store.size() == 1 && store.contains(9));
+		}
+		domain.collect();
+		CHECK(domain.pending() == 0);
+	});
+
+	test::run("RingStore SPSC keeps order", [] {
+		adv::RingStore<size_t> ring(64);
+		const size_t count = 100000;
+		std::vector<size_t> received;
+		std::thread consumer([&] {
+			while (received.size() < count)
+			{
+				size_t value;
+				if (ring.pop_front(value))
+				{
+					received.push_back(value);
+				}
+				else
+				{
+					const adv::Store<size_t> batch = ring.pop_front_n(16);
+					received.insert(received.end(), batch.begin(), batch.end());
+					if (batch.empty())
+					{
+						std::this_thread::yield();
+					}
+				}
+			}
+		});
+		for (size_t i = 0; i < count;)
+		{
+			if (ring.push_back(i))
+			{
+				++i;
+			}
+			else
+			{
+				std::this_thread::yield(); // Full, let the consumer run
+			}
+		}
+		consumer.join();
+		std::vector<size_t> expected(count);
+		std::iota(expected.begin(), expected.end(), size_t(0));
+		CHECK(received == expected);
+		CHECK(ring.empty());
+	});
+
+	test::run("RingStore MPMC loses nothing", [] {
+		adv::RingStore<std::unique_ptr<size_t>, adv::RingMode::mpmc> ring(128);
+		const size_t total = k_threads * k_per_thread;
+		std::atomic<size_t> consumed{0};
+		std::vector<std::vector<size_t>> received(k_threads);
+		run_threads(2 * k_threads, [&](size_t t) {
+			if (t < k_threads)
+			{
+				for (size_t i = 0; i < k_per_thread;)
+				{
+					if (ring.push_back(std::make_unique<size_t>(t * k_per_thread + i)))
+					{
+						++i;
+					}
+					else
+					{
+						std::this_thread::yield();
+					}
+				}
+				return;
+			}
+			std::vector<size_t> &mine = received[t - k_threads];
+			while (consumed.load(std::memory_order_relaxed) < total)
+			{
+				std::unique_ptr<size_t> value;
+				if (ring.pop_front(value))
+				{
+					mine.push_back(*value);
+					consumed.fetch_add(1, std::memory_order_relaxed);
+				}
+				else
+				{
+					std::this_thread::yield();
+				}
+			}
+		});
+		std::vector<size_t> all;
+		for (const std::vector<size_t> &part : received)
+		{
+			all.insert(all.end(), part.begin(), part.end());
+		}
+		CHECK(is_permutation_of_iota(all, total));
+		CHECK(ring.empty());
+	});
+
+	test::run("RingStore capacity and batches", [] {
+		adv::RingStore<int> ring(5); // Rounded up to 8
+		CHECK(ring.capacity() == 8);
+		const std::vector<int> values{0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+		CHECK(ring.push_back(values) == 8); // Only what fits
+		CHECK(!ring.push_back(10));
+		const adv::Store<int> front = ring.pop_front_n(3);
+		CHECK(front.size() == 3 && front[0] == 0 && front[2] == 2);
+		CHECK(ring.push_back(values.begin() + 8, values.end()) == 2);
+		CHECK(ring.pop_front_n(100).size() == 7 && ring.empty());
+
+		bool threw = false;
+		try
+		{
+			adv::RingStore<int, adv::RingMode::mpmc> invalid(0);
+		}
+		catch (const std::invalid_argument &)
+		{
+			threw = true;
+		}
+		CHECK(threw);
+	});
+
+	return test::report();
+}
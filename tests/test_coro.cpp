@@ -0,0 +1,148 @@
+/**
+ * @file test_coro.cpp
+ * @brief Kiểm tra pipeline coroutine: generator, chunked, Channel, Scheduler
+ *
+ * Pipeline emit -> filter -> transform -> consume được so với kết quả tính
+ * tuần tự, chạy trên một Scheduler và trên hai Scheduler ở hai thread. Channel
+ * không bao giờ giữ quá capacity phần tử; stage ném exception phải làm các
+ * stage còn lại dừng và run() ném lại exception đó.
+ *
+ * Build & chạy (C++20):
+ *   g++ -std=c++20 -O2 -I<thư mục chứa advance/> tests/test_coro.cpp -o test_coro -pthread && ./test_coro
+ */
+
+#include <algorithm>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include "advance/store/include/advance_store_coro.hpp"
+#include "test_check.hpp"
+
+namespace
+{
+
+const int k_count = 10000;
+
+/// @brief Store holding 0..count-1
+adv::Store<int> iota_store(int count)
+{
+	adv::Store<int> store;
+	for (int i = 0; i < count; ++i)
+	{
+		store.push_back(i);
+	}
+	return store;
+}
+
+/// @brief Result of the test pipeline computed without coroutines
+std::vector<int> expected_output()
+{
+	std::vector<int> expected;
+	for (int i = 0; i < k_count; i += 2)
+	{
+		expected.push_back(i * 3);
+	}
+	return expected;
+}
+
+} // namespace
+
+int main()
+{
+	test::run("generator and chunked", [] {
+		const adv::Store<int> source = iota_store(10);
+		std::vector<int> seen;
+		for (const int value : adv::from_store(source))
+		{
+			seen.push_back(value);
+		}
+		CHECK(seen.size() == 10 && seen[9] == 9);
+
+		std::vector<size_t> sizes;
+		for (const adv::Store<int> &chunk : adv::chunked(adv::from_store(source), 4))
+		{
+			sizes.push_back(chunk.size());
+		}
+		CHECK((sizes == std::vector<size_t>{4, 4, 2}));
+	});
+
+	test::run("pipeline on one scheduler", [] {
+		const adv::Store<int> source = iota_store(k_count);
+		adv::Channel<adv::Store<int>> raw(2), even(2), tripled(2);
+		size_t max_buffered = 0;
+		std::vector<int> output;
+		adv::Scheduler scheduler;
+		scheduler.spawn(adv::emit_chunks(adv::from_store(source), 64, raw));
+		scheduler.spawn(adv::filter_chunks(raw, [](int v) { return v % 2 == 0; }, even));
+		scheduler.spawn(adv::transform_chunks(even, [](int v) { return v * 3; }, tripled));
+		scheduler.spawn(adv::consume_chunks(tripled, [&](adv::Store<int> &chunk) {
+			// Backpressure: no channel ever holds more than its capacity
+			max_buffered = std::max({max_buffered, raw.size(), even.size(), tripled.size()});
+			output.insert(output.end(), chunk.begin(), chunk.end());
+		}));
+		scheduler.run();
+		CHECK(output == expected_output());
+		CHECK(max_buffered <= 2);
+	});
+
+	test::run("stages on two threads", [] {
+		const adv::Store<int> source = iota_store(k_count);
+		adv::Channel<adv::Store<int>> raw(4), even(4), tripled(4);
+		std::vector<int> output;
+		adv::Scheduler producer_side, consumer_side;
+		producer_side.spawn(adv::emit_chunks(adv::from_store(source), 100, raw));
+		producer_side.spawn(adv::filter_chunks(raw, [](int v) { return v % 2 == 0; }, even));
+		consumer_side.spawn(adv::transform_chunks(even, [](int v) { return v * 3; }, tripled));
+		consumer_side.spawn(adv::consume_chunks(tripled, [&](adv::Store<int> &chunk) {
+			output.insert(output.end(), chunk.begin(), chunk.end());
+		}));
+		std::thread worker([&] { producer_side.run(); });
+		consumer_side.run();
+		worker.join();
+		CHECK(output == expected_output());
+	});
+
+	test::run("failing stage stops the pipeline", [] {
+		const adv::Store<int> source = iota_store(k_count);
+		adv::Channel<adv::Store<int>> raw(2), mapped(2);
+		size_t consumed = 0;
+		adv::Scheduler scheduler;
+		scheduler.spawn(adv::emit_chunks(adv::from_store(source), 16, raw));
+		scheduler.spawn(adv::transform_chunks(raw,
+											  [](int v) {
+												  if (v == 500)
+												  {
+													  throw std::runtime_error("stage");
+												  }
+												  return v;
+											  },
+											  mapped));
+		scheduler.spawn(adv::consume_chunks(mapped, [&](adv::Store<int> &chunk) { consumed += chunk.size(); }));
+		bool threw = false;
+		try
+		{
+			scheduler.run(); // Returns: no stage is left suspended
+		}
+		catch (const std::runtime_error &)
+		{
+			threw = true;
+		}
+		CHECK(threw);
+		CHECK(consumed < 500);
+	});
+
+	test::run("channel rejects zero capacity", [] {
+		bool threw = false;
+		try
+		{
+			adv::Channel<int> channel(0);
+		}
+		catch (const std::invalid_argument &)
+		{
+			threw = true;
+		}
+		CHECK(threw);
+	});
+
+	return test::report();
+}
@@ -0,0 +1,250 @@
+/**
+ * @file test_external.cpp
+ * @brief Kiểm tra ExternalStore: spill, sort, unique, codec string, ngân sách bộ nhớ
+ *
+ * Dữ liệu được so với std::sort/std::unique trên bản sao trong bộ nhớ. Các
+ * run được ghi vào một thư mục tạm riêng, thư mục này phải trống sau khi
+ * store bị hủy hoặc clear(). operator new toàn cục được thay để đo lượng heap
+ * đang dùng, kiểm tra sort/duyệt không vượt ngân sách.
+ *
+ * Build & chạy:
+ *   g++ -std=c++17 -O2 -I<thư mục chứa advance/> tests/test_external.cpp -o test_external && ./test_external
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <filesystem>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+#include "advance/store/include/advance_store_external.hpp"
+#include "test_check.hpp"
+
+// =======================
+// Heap Accounting
+// =======================
+
+namespace
+{
+std::atomic<size_t> g_live{0}; // Bytes currently allocated
+std::atomic<size_t> g_peak{0}; // Highest g_live since reset_peak()
+
+void reset_peak() noexcept
+{
+	g_peak.store(g_live.load());
+}
+} // namespace
+
+void *operator new(size_t bytes)
+{
+	// The size is kept in front of the block so delete can subtract it
+	void *raw = std::malloc(bytes + alignof(std::max_align_t));
+	if (!raw)
+	{
+		throw std::bad_alloc();
+	}
+	*static_cast<size_t *>(raw) = bytes;
+	const size_t live = g_live.fetch_add(bytes) + bytes;
+	size_t peak = g_peak.load();
+	while (live > peak && !g_peak.compare_exchange_weak(peak, live))
+	{
+	}
+	return static_cast<char *>(raw) + alignof(std::max_align_t);
+}
+
+void operator delete(void *ptr) noexcept
+{
+	if (ptr)
+	{
+		void *raw = static_cast<char *>(ptr) - alignof(std::max_align_t);
+		g_live.fetch_sub(*static_cast<size_t *>(raw));
+		std::free(raw);
+	}
+}
+
+void operator delete(void *ptr, size_t) noexcept
+{
+	operator delete(ptr);
+}
+
+namespace
+{
+
+/// @brief Private directory for run files, removed on destruction
+struct TempDir
+{
+	std::filesystem::path path;
+
+	TempDir()
+		: path(std::filesystem::temp_directory_path() / ("adv_store_test_" + std::to_string(std::random_device{}())))
+	{
+		std::filesystem::create_directories(path);
+	}
+
+	~TempDir() { std::filesystem::remove_all(path); }
+
+	bool empty() const { return std::filesystem::is_empty(path); }
+};
+
+/// @brief Check that the store streams exactly expected (already sorted)
+template <typename T>
+bool streams(adv::ExternalStore<T> &store, const std::vector<T> &expected)
+{
+	size_t i = 0;
+	bool ok = store.size() == expected.size();
+	for (auto it = store.begin(); it != store.end(); ++it)
+	{
+		ok = ok && i < expected.size() && *it == expected[i];
+		++i;
+	}
+	return ok && i == expected.size();
+}
+
+} // namespace
+
+int main()
+{
+	std::mt19937 gen(51);
+
+	test::run("spill and sorted iteration", [&] {
+		TempDir dir;
+		{
+			adv::ExternalStore<int> store(4096, dir.path);
+			std::vector<int> expected;
+			for (int i = 0; i < 50000; ++i)
+			{
+				const int value = static_cast<int>(gen() % 20000);
+				store.push_back(value);
+				expected.push_back(value);
+				CHECK(store.buffered_bytes() <= store.memory_budget());
+			}
+			CHECK(store.run_count() > 1);
+			CHECK(!dir.empty());
+			std::sort(expected.begin(), expected.end());
+			CHECK(streams(store, expected));
+			CHECK(store.to_store().size() == expected.size());
+		}
+		CHECK(dir.empty());
+	});
+
+	test::run("multi-pass sort and unique", [&] {
+		TempDir dir;
+		{
+			adv::ExternalStore<int> store(1 << 14, dir.path);
+			store.set_max_fan_in(3);
+			std::vector<int> expected;
+			for (int i = 0; i < 60000; ++i)
+			{
+				const int value = static_cast<int>(gen() % 5000);
+				store.push_back(value);
+				expected.push_back(value);
+			}
+			std::sort(expected.begin(), expected.end());
+			store.sort();
+			CHECK(store.run_count() == 1);
+			CHECK(streams(store, expected));
+
+			// Appends after sort() become a second run merged on the fly
+			for (int value = -10; value < 0; ++value)
+			{
+				store.push_back(value);
+				expected.insert(expected.begin(), value);
+			}
+			std::sort(expected.begin(), expected.end());
+			CHECK(streams(store, expected));
+
+			store.unique();
+			expected.erase(std::unique(expected.begin(), expected.end()), expected.end());
+			CHECK(store.run_count() == 1);
+			CHECK(streams(store, expected));
+		}
+		CHECK(dir.empty());
+	});
+
+	test::run("string codec", [&] {
+		TempDir dir;
+		{
+			adv::ExternalStore<std::string> store(2048, dir.path);
+			std::vector<std::string> expected;
+			for (int i = 0; i < 5000; ++i)
+			{
+				// Empty, short and long strings, including embedded zeros
+				std::string value(gen() % 300, static_cast<char>('a' + gen() % 26));
+				if (i % 7 == 0)
+				{
+					value.push_back('\0');
+				}
+				store.push_back(value);
+				expected.push_back(value);
+			}
+			CHECK(store.run_count() > 1);
+			std::sort(expected.begin(), expected.end());
+			store.unique();
+			expected.erase(std::unique(expected.begin(), expected.end()), expected.end());
+			CHECK(streams(store, expected));
+		}
+		CHECK(dir.empty());
+	});
+
+	test::run("clear, spill and move remove files", [&] {
+		TempDir dir;
+		adv::ExternalStore<int> store(1024, dir.path);
+		for (int i = 0; i < 3000; ++i)
+		{
+			store.push_back(i);
+		}
+		store.spill();
+		CHECK(!dir.empty());
+		store.clear();
+		CHECK(dir.empty() && store.empty() && store.run_count() == 0);
+		for (int i = 0; i < 3000; ++i)
+		{
+			store.push_back(i);
+		}
+		{
+			adv::ExternalStore<int> moved(std::move(store));
+			CHECK(moved.size() == 3000);
+		}
+		CHECK(dir.empty());
+	});
+
+	test::run("merges stay within the budget", [&] {
+		TempDir dir;
+		const size_t budget = size_t(1) << 16;
+		std::vector<int> expected(200000);
+		for (int &value : expected)
+		{
+			value = static_cast<int>(gen());
+		}
+		{
+			adv::ExternalStore<int> store(budget, dir.path);
+			const size_t base = g_live.load();
+			for (const int value : expected)
+			{
+				store.push_back(value);
+			}
+			std::sort(expected.begin(), expected.end());
+
+			// Buffers share the budget; slack for stream objects, paths, merge heads
+			// and the default write buffer of the final spill
+			const size_t limit = base + budget + (size_t(16) << 10);
+			reset_peak();
+			size_t i = 0;
+			bool ordered = true;
+			store.for_each([&](int value) { ordered = ordered && value == expected[i++]; });
+			CHECK(ordered && i == expected.size());
+			CHECK(g_peak.load() <= limit);
+
+			reset_peak();
+			store.sort();
+			CHECK(g_peak.load() <= limit);
+			CHECK(streams(store, expected));
+		}
+		CHECK(dir.empty());
+	});
+
+	return test::report();
+}
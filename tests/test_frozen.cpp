@@ -0,0 +1,128 @@
+/**
+ * @file test_frozen.cpp
+ * @brief Kiểm tra freeze(): FrozenStore với minimal perfect hash
+ *
+ * find() phải trả về vị trí đầu tiên giống std::find ở mọi kích thước, kể cả
+ * khi nhiều phần tử khác nhau trùng hash. thaw() trả lại đúng dữ liệu, và
+ * metadata_bytes() giữ quanh 3.5 bit hash + 4 byte vị trí cho mỗi phần tử
+ * phân biệt.
+ *
+ * Build & chạy:
+ *   g++ -std=c++17 -O2 -I<thư mục chứa advance/> tests/test_frozen.cpp -o test_frozen && ./test_frozen
+ */
+
+#include <algorithm>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <unordered_set>
+#include "advance/store/include/advance_store.hpp"
+#include "test_check.hpp"
+
+namespace
+{
+
+/// @brief Value whose hash puts every element in one of three buckets
+struct Clashing
+{
+	int value;
+
+	bool operator==(const Clashing &other) const
+	{
+		return value == other.value;
+	}
+};
+
+} // namespace
+
+template <>
+struct std::hash<Clashing>
+{
+	size_t operator()(const Clashing &c) const noexcept
+	{
+		return static_cast<size_t>(c.value % 3);
+	}
+};
+
+int main()
+{
+	std::mt19937 gen(71);
+
+	test::run("find returns the first position", [&] {
+		for (const int n : {0, 1, 2, 10, 100, 1000, 50000})
+		{
+			adv::Store<int> store;
+			for (int i = 0; i < n; ++i)
+			{
+				store.push_back(static_cast<int>(gen() % (n + 1)));
+			}
+			const adv::FrozenStore<int> frozen = store.freeze();
+			CHECK(frozen.size() == store.size());
+			CHECK(frozen.distinct() == std::unordered_set<int>(store.begin(), store.end()).size());
+			bool agrees = true;
+			for (int value = -5; value < n + 5; ++value)
+			{
+				const auto it = std::find(store.begin(), store.end(), value);
+				const size_t expected = it == store.end() ? adv::FrozenStore<int>::npos : size_t(it - store.begin());
+				agrees = agrees && frozen.find(value) == expected && frozen.contains(value) == (it != store.end());
+			}
+			CHECK(agrees);
+		}
+	});
+
+	test::run("clashing hashes", [] {
+		adv::Store<Clashing> store;
+		for (int i = 0; i < 30; ++i)
+		{
+			store.push_back(Clashing{i % 17});
+		}
+		const adv::FrozenStore<Clashing> frozen = store.freeze();
+		CHECK(frozen.distinct() == 17);
+		for (int i = 0; i < 20; ++i)
+		{
+			CHECK(frozen.contains(Clashing{i}) == (i < 17));
+			CHECK(frozen.find(Clashing{i}) == (i < 17 ? size_t(i) : adv::FrozenStore<Clashing>::npos));
+		}
+	});
+
+	test::run("move freeze and thaw", [] {
+		adv::Store<std::string> words{"x", "y", "x"};
+		const adv::FrozenStore<std::string> frozen = std::move(words).freeze();
+		CHECK(words.empty());
+		CHECK(frozen.find("x") == 0 && frozen.find("y") == 1 && !frozen.contains("z"));
+
+		adv::Store<std::string> thawed = frozen.thaw();
+		CHECK(thawed.size() == 3 && thawed[2] == "x");
+		thawed.push_back(std::string("z")); // The copy is modifiable, the frozen store is not touched
+		CHECK(thawed.contains("z") && !frozen.contains("z"));
+
+		bool threw = false;
+		try
+		{
+			frozen.at(3);
+		}
+		catch (const std::out_of_range &)
+		{
+			threw = true;
+		}
+		CHECK(threw);
+	});
+
+	test::run("about 3.5 bits of hash per key", [&] {
+		const size_t n = 200000;
+		adv::Store<uint64_t> store;
+		store.reserve(n);
+		for (size_t i = 0; i < n; ++i)
+		{
+			store.push_back((static_cast<uint64_t>(gen()) << 32) | gen());
+		}
+		const adv::FrozenStore<uint64_t> frozen = store.freeze();
+		CHECK(frozen.distinct() == n);
+
+		// 4 bytes of first position per key, the rest is the perfect hash
+		const double hash_bits = 8.0 * static_cast<double>(frozen.metadata_bytes() - 4 * n) / n;
+		CHECK(hash_bits > 2.5 && hash_bits < 4.5);
+	});
+
+	return test::report();
+}
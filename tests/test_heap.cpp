@@ -0,0 +1,202 @@
+/**
+ * @file test_heap.cpp
+ * @brief Kiểm tra heap trên Store, HeapStore và IndexedHeap
+ *
+ * make_heap / heap_push / heap_pop với nhiều Arity phải trả phần tử theo
+ * đúng thứ tự của std::sort; HeapStore::drain() cũng vậy. IndexedHeap chạy
+ * Dijkstra trên đồ thị ngẫu nhiên và được so với Bellman-Ford; update theo cả
+ * hai chiều, remove và các lỗi (pop rỗng, push trùng key) được kiểm tra riêng.
+ *
+ * Build & chạy:
+ *   g++ -std=c++17 -O2 -I<thư mục chứa advance/> tests/test_heap.cpp -o test_heap && ./test_heap
+ */
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <vector>
+#include "advance/store/include/advance_store_heap.hpp"
+#include "test_check.hpp"
+
+namespace
+{
+
+struct Edge
+{
+	size_t from;
+	size_t to;
+	long long weight;
+};
+
+/// @brief Push values one by one into an Arity heap, pop them all
+template <size_t Arity>
+std::vector<int> heap_order(const std::vector<int> &values)
+{
+	adv::Store<int> heap;
+	bool valid = true;
+	for (const int value : values)
+	{
+		adv::heap_push<Arity>(heap, value);
+		valid = valid && adv::is_heap<Arity>(heap);
+	}
+	std::vector<int> popped;
+	while (!heap.empty() && valid)
+	{
+		popped.push_back(adv::heap_pop<Arity>(heap));
+		valid = adv::is_heap<Arity>(heap);
+	}
+	return valid ? popped : std::vector<int>();
+}
+
+/// @brief Shortest distances from 0 using IndexedHeap (Dijkstra)
+std::vector<long long> dijkstra(size_t nodes, const std::vector<std::vector<Edge>> &adjacent)
+{
+	const long long inf = std::numeric_limits<long long>::max();
+	std::vector<long long> dist(nodes, inf);
+	adv::IndexedHeap<long long, std::greater<long long>> frontier(nodes);
+	frontier.push(0, 0);
+	while (!frontier.empty())
+	{
+		const auto [node, d] = frontier.pop();
+		dist[node] = d;
+		for (const Edge &edge : adjacent[node])
+		{
+			if (dist[edge.to] == inf)
+			{
+				frontier.improve(edge.to, d + edge.weight);
+			}
+		}
+	}
+	return dist;
+}
+
+/// @brief Shortest distances from 0 by Bellman-Ford
+std::vector<long long> bellman_ford(size_t nodes, const std::vector<Edge> &edges)
+{
+	const long long inf = std::numeric_limits<long long>::max();
+	std::vector<long long> dist(nodes, inf);
+	dist[0] = 0;
+	for (size_t round = 1; round < nodes; ++round)
+	{
+		for (const Edge &edge : edges)
+		{
+			if (dist[edge.from] != inf)
+			{
+				dist[edge.to] = std::min(dist[edge.to], dist[edge.from] + edge.weight);
+			}
+		}
+	}
+	return dist;
+}
+
+} // namespace
+
+int main()
+{
+	std::mt19937 gen(66);
+
+	test::run("store heaps pop in order", [&] {
+		std::vector<int> values(500);
+		for (int &value : values)
+		{
+			value = static_cast<int>(gen() % 100);
+		}
+		std::vector<int> expected = values;
+		std::sort(expected.begin(), expected.end(), std::greater<int>());
+		CHECK(heap_order<2>(values) == expected);
+		CHECK(heap_order<3>(values) == expected);
+		CHECK(heap_order<4>(values) == expected);
+
+		adv::Store<int> store(values);
+		adv::make_heap<8>(store, std::greater<int>()); // Min-heap
+		CHECK(adv::is_heap<8>(store, std::greater<int>()));
+		CHECK(adv::heap_top(store) == expected.back());
+		store.clear();
+		bool threw = false;
+		try
+		{
+			adv::heap_pop(store);
+		}
+		catch (const std::out_of_range &)
+		{
+			threw = true;
+		}
+		CHECK(threw);
+	});
+
+	test::run("HeapStore drains in priority order", [] {
+		adv::HeapStore<int> heap{5, 1, 9, 3, 7};
+		heap.push(4);
+		heap.emplace(8);
+		CHECK(heap.size() == 7 && heap.top() == 9);
+		const adv::Store<int> drained = heap.drain();
+		CHECK((std::vector<int>(drained.cbegin(), drained.cend()) == std::vector<int>{9, 8, 7, 5, 4, 3, 1}));
+		CHECK(heap.empty());
+
+		adv::HeapStore<int, std::greater<int>, 2> smallest(adv::Store<int>{4, 2, 6});
+		CHECK(smallest.pop() == 2 && smallest.pop() == 4 && smallest.top() == 6);
+	});
+
+	test::run("IndexedHeap Dijkstra vs Bellman-Ford", [&] {
+		const size_t nodes = 300;
+		std::vector<Edge> edges;
+		std::vector<std::vector<Edge>> adjacent(nodes);
+		for (size_t i = 0; i < 3000; ++i)
+		{
+			const Edge edge{gen() % nodes, gen() % nodes, static_cast<long long>(gen() % 1000)};
+			edges.push_back(edge);
+			adjacent[edge.from].push_back(edge);
+		}
+		CHECK(dijkstra(nodes, adjacent) == bellman_ford(nodes, edges));
+	});
+
+	test::run("IndexedHeap update and remove", [] {
+		adv::IndexedHeap<int> heap; // Largest on top, key range grows on demand
+		for (size_t key = 0; key < 10; ++key)
+		{
+			heap.push(key, static_cast<int>(key) * 10);
+		}
+		CHECK(heap.top_key() == 9 && heap.top_priority() == 90);
+		heap.update(2, 1000); // Up
+		CHECK(heap.top_key() == 2);
+		heap.update(2, -5); // Down
+		CHECK(heap.top_key() == 9 && heap.priority(2) == -5);
+		CHECK(!heap.improve(9, 50) && heap.improve(9, 95) && heap.priority(9) == 95);
+		heap.remove(9);
+		CHECK(!heap.contains(9) && heap.size() == 9 && heap.top_key() == 8);
+		heap.push(42, 7);
+		CHECK(heap.contains(42));
+
+		int errors = 0;
+		try
+		{
+			heap.push(42, 1);
+		}
+		catch (const std::invalid_argument &)
+		{
+			++errors;
+		}
+		try
+		{
+			heap.priority(9);
+		}
+		catch (const std::out_of_range &)
+		{
+			++errors;
+		}
+		CHECK(errors == 2);
+
+		std::vector<int> order;
+		while (!heap.empty())
+		{
+			order.push_back(heap.pop().second);
+		}
+		CHECK(std::is_sorted(order.rbegin(), order.rend()) && order.back() == -5);
+		heap.push(9, 1); // Removed keys can come back
+		CHECK(heap.size() == 1);
+	});
+
+	return test::report();
+}
@@ -0,0 +1,148 @@
+/**
+ * @file test_index.cpp
+ * @brief Kiểm tra build_index(): StoreIndex và quy tắc version() chung cho mọi cache
+ *
+ * Kết quả của StoreIndex được so với find_all() quét tuyến tính. Index phải tự
+ * build lại sau mọi thay đổi, kể cả ghi qua at()/operator[]/data()/iterator
+ * (các accessor mutable tăng version), trong khi đọc qua const reference hay
+ * cbegin() không làm mất index. Cùng quy tắc đó được kiểm tra cho sort_order(),
+ * freeze_rmq(), freeze_search() và live_filter().
+ *
+ * Build & chạy:
+ *   g++ -std=c++17 -O2 -I<thư mục chứa advance/> tests/test_index.cpp -o test_index && ./test_index
+ */
+
+#include <random>
+#include <string>
+#include <vector>
+#include "advance/store/include/advance_store.hpp"
+#include "test_check.hpp"
+
+namespace
+{
+
+struct Person
+{
+	std::string name;
+	int age;
+};
+
+/// @brief Check that index answers like a find_all scan for every value in [lo, hi)
+template <typename Index>
+bool agrees_with_scan(const adv::Store<int> &store, const Index &index, int lo, int hi)
+{
+	for (int value = lo; value < hi; ++value)
+	{
+		if (index.find_all(value) != store.find_all(value) || index.contains(value) != store.contains(value))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+} // namespace
+
+int main()
+{
+	std::mt19937 gen(62);
+
+	test::run("index matches a scan", [&] {
+		adv::Store<int> store;
+		for (int i = 0; i < 5000; ++i)
+		{
+			store.push_back(static_cast<int>(gen() % 1000));
+		}
+		const auto index = store.build_index();
+		CHECK(agrees_with_scan(store, index, -5, 1005));
+		size_t total = 0;
+		for (int value = 0; value < 1000; ++value)
+		{
+			total += index.count(value);
+		}
+		CHECK(total == store.size());
+
+		const std::vector<int> keys{3, 2000, 7, -1};
+		const auto found = index.probe(keys);
+		const std::vector<bool> present = index.contains_all(keys);
+		for (size_t i = 0; i < keys.size(); ++i)
+		{
+			CHECK(found[i].size() == store.count(keys[i]));
+			CHECK(present[i] == store.contains(keys[i]));
+		}
+	});
+
+	test::run("key function", [] {
+		const adv::Store<Person> people{{"an", 30}, {"binh", 25}, {"chi", 30}};
+		const auto by_age = people.build_index([](const Person &p) { return p.age; });
+		CHECK(by_age.key_count() == 2);
+		CHECK((by_age.find_all(30) == std::vector<size_t>{0, 2}));
+		const auto by_name = people.build_index([](const Person &p) { return p.name; });
+		CHECK(by_name.contains("binh") && !by_name.contains("dung"));
+	});
+
+	test::run("index follows modifications", [] {
+		adv::Store<int> store{5, 1, 5, 2};
+		const auto index = store.build_index();
+		CHECK(index.count(5) == 2 && !index.stale());
+		store.push_back(5);
+		CHECK(index.stale() && index.count(5) == 3);
+		store.remove_at(0);
+		CHECK((index.find_all(5) == std::vector<size_t>{1, 3}));
+		store.sort();
+		CHECK(agrees_with_scan(store, index, 0, 7));
+	});
+
+	test::run("mutable access counts as a modification", [] {
+		adv::Store<int> store{1, 2, 3, 4};
+		const auto index = store.build_index();
+		CHECK(index.contains(4));
+
+		store[3] = 40;
+		CHECK(!index.contains(4) && index.contains(40));
+		store.at(0) = 10;
+		CHECK(index.count(10) == 1);
+		store.data()[1] = 20;
+		CHECK(index.contains(20) && !index.contains(2));
+		*store.begin() = 100;
+		CHECK(index.contains(100));
+		*store.rbegin() = 400;
+		CHECK(agrees_with_scan(store, index, 0, 500));
+
+		// Reading through const access keeps the index current
+		const adv::Store<int> &view = store;
+		const uint64_t version = store.version();
+		long long total = 0;
+		for (auto it = store.cbegin(); it != store.cend(); ++it)
+		{
+			total += *it;
+		}
+		total += view[0] + view.at(1) + *view.begin() + *view.data();
+		CHECK(total > 0 && store.version() == version && !index.stale());
+	});
+
+	test::run("every cache follows the same rule", [] {
+		adv::Store<int> store;
+		for (int i = 0; i < 100; ++i)
+		{
+			store.push_back(i);
+		}
+		store.sort();
+		CHECK(store.sort_order() == adv::SortOrder::ascending);
+		const auto rmq = store.freeze_rmq();
+		const auto search = store.freeze_search();
+		const auto evens = store.live_filter([](int v) { return v % 2 == 0; });
+		CHECK(rmq.range_max(0, 100) == 99 && !search.contains(1000) && evens.size() == 50);
+
+		store[99] = 1000; // Still ascending, but the store cannot know that
+		CHECK(store.sort_order() == adv::SortOrder::unknown);
+		CHECK(rmq.stale() && rmq.range_max(0, 100) == 1000);
+		CHECK(search.stale() && search.contains(1000) && !search.contains(99));
+		CHECK(evens.stale() && evens.size() == 51);
+
+		store.data()[0] = 1;
+		CHECK(rmq.range_min(0, 10) == 1 && evens.size() == 50);
+	});
+
+	return test::report();
+}
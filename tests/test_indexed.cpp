@@ -0,0 +1,185 @@
+/**
+ * @file test_indexed.cpp
+ * @brief Kiểm tra IndexedStore (B+tree theo vị trí) so với std::vector
+ *
+ * Chuỗi insert/remove_at/push/pop ngẫu nhiên được áp dụng song song lên
+ * IndexedStore và std::vector; nội dung, duyệt xuôi/ngược và truy cập theo vị
+ * trí phải luôn giống nhau, kể cả khi cây tách/gộp leaf và đổi chiều cao.
+ *
+ * Build & chạy:
+ *   g++ -std=c++17 -O2 -I<thư mục chứa advance/> tests/test_indexed.cpp -o test_indexed && ./test_indexed
+ */
+
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "advance/store/include/advance_store_indexed.hpp"
+#include "test_check.hpp"
+
+namespace
+{
+
+/// @brief Compare every access path of the tree with the reference vector
+template <typename T>
+bool matches(const adv::IndexedStore<T> &store, const std::vector<T> &expected)
+{
+	if (store.size() != expected.size() || store.empty() != expected.empty())
+	{
+		return false;
+	}
+	size_t i = 0;
+	for (const T &value : store)
+	{
+		if (value != expected[i++])
+		{
+			return false;
+		}
+	}
+	for (auto it = store.end(); it != store.begin();)
+	{
+		--it;
+		if (*it != expected[--i])
+		{
+			return false;
+		}
+	}
+	for (size_t pos = 0; pos < expected.size(); pos += 1 + pos / 8)
+	{
+		if (store[pos] != expected[pos] || store.at(pos) != expected[pos])
+		{
+			return false;
+		}
+	}
+	return expected.empty() || (store.front() == expected.front() && store.back() == expected.back());
+}
+
+/// @brief Apply the same random edits to both containers
+/// @param insert_percent Share of inserts, above 50 grows the tree
+void random_edits(std::mt19937 &gen, adv::IndexedStore<int> &store, std::vector<int> &expected, size_t steps,
+				  unsigned insert_percent)
+{
+	for (size_t step = 0; step < steps; ++step)
+	{
+		const unsigned roll = gen() % 100;
+		const int value = static_cast<int>(gen());
+		if (roll < insert_percent || expected.empty())
+		{
+			const size_t pos = gen() % (expected.size() + 1);
+			store.insert(pos, value);
+			expected.insert(expected.begin() + static_cast<std::ptrdiff_t>(pos), value);
+		}
+		else if (roll < insert_percent + 5)
+		{
+			store.push_front(value);
+			expected.insert(expected.begin(), value);
+		}
+		else if (roll < insert_percent + 10)
+		{
+			store.pop_back();
+			expected.pop_back();
+		}
+		else
+		{
+			const size_t pos = gen() % expected.size();
+			CHECK(store.remove_at(pos) == expected[pos]);
+			expected.erase(expected.begin() + static_cast<std::ptrdiff_t>(pos));
+		}
+		if (step % 997 == 0)
+		{
+			CHECK(matches(store, expected));
+		}
+	}
+	CHECK(matches(store, expected));
+}
+
+} // namespace
+
+int main()
+{
+	std::mt19937 gen(77);
+
+	test::run("random edits match std::vector", [&] {
+		for (const size_t initial : {0, 1, 100, 5000, 60000})
+		{
+			std::vector<int> expected(initial);
+			for (int &value : expected)
+			{
+				value = static_cast<int>(gen());
+			}
+			adv::IndexedStore<int> store(expected.begin(), expected.end());
+			CHECK(matches(store, expected));
+			random_edits(gen, store, expected, 20000, 60); // Grow
+			random_edits(gen, store, expected, 20000, 35); // Shrink
+		}
+	});
+
+	test::run("drain to empty and refill", [&] {
+		std::vector<int> expected(20000);
+		for (size_t i = 0; i < expected.size(); ++i)
+		{
+			expected[i] = static_cast<int>(i);
+		}
+		adv::IndexedStore<int> store(expected.begin(), expected.end());
+		while (!expected.empty())
+		{
+			const size_t pos = gen() % expected.size();
+			store.remove_at(pos);
+			expected.erase(expected.begin() + static_cast<std::ptrdiff_t>(pos));
+		}
+		CHECK(matches(store, expected));
+		for (int i = 0; i < 3000; ++i)
+		{
+			store.push_back(i);
+			expected.push_back(i);
+		}
+		CHECK(matches(store, expected));
+	});
+
+	test::run("mutable access writes through", [&] {
+		std::vector<int> expected(3000, 0);
+		adv::IndexedStore<int> store(expected.begin(), expected.end());
+		for (size_t i = 0; i < expected.size(); i += 3)
+		{
+			store[i] = static_cast<int>(i);
+			expected[i] = static_cast<int>(i);
+		}
+		for (int &value : store)
+		{
+			value += 1;
+		}
+		for (int &value : expected)
+		{
+			value += 1;
+		}
+		CHECK(matches(store, expected));
+	});
+
+	test::run("copy, move and conversions", [] {
+		adv::IndexedStore<std::string> words{"a", "b"};
+		adv::IndexedStore<std::string> copy = words;
+		copy.insert(1, "x");
+		adv::IndexedStore<std::string> moved = std::move(copy);
+		CHECK(moved.size() == 3 && moved[1] == "x" && words.size() == 2);
+		const adv::Store<std::string> flat = moved.to_store();
+		CHECK(flat.size() == 3 && flat[2] == "b");
+		adv::IndexedStore<std::string> from_store(flat);
+		CHECK(from_store.size() == 3 && from_store.back() == "b");
+	});
+
+	test::run("bounds checking", [] {
+		adv::IndexedStore<int> store{1, 2, 3};
+		bool threw = false;
+		try
+		{
+			store.at(3);
+		}
+		catch (const std::out_of_range &)
+		{
+			threw = true;
+		}
+		CHECK(threw);
+	});
+
+	return test::report();
+}
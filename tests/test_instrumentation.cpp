@@ -0,0 +1,167 @@
+/**
+ * @file test_instrumentation.cpp
+ * @brief Kiểm tra bộ đếm thao tác (ADV_STORE_INSTRUMENTATION) và latency
+ *        histogram (ADV_STORE_TIMING)
+ *
+ * Số lần gọi, phần tử bị dịch, realloc dự đoán và linear scan phải khớp với
+ * giá trị tính tay; các lời gọi const đồng thời không được làm mất lượt đếm.
+ * Histogram được kiểm tra về sai số bucket, percentile và việc gộp shard của
+ * nhiều thread (kể cả thread đã kết thúc).
+ *
+ * Build & chạy (nên thêm -fsanitize=thread):
+ *   g++ -std=c++17 -O2 -I<thư mục chứa advance/> tests/test_instrumentation.cpp -o test_instrumentation -pthread && ./test_instrumentation
+ */
+
+#define ADV_STORE_INSTRUMENTATION
+#define ADV_STORE_TIMING
+#include <sstream>
+#include <thread>
+#include <vector>
+#include "advance/store/include/advance_store.hpp"
+#include "test_check.hpp"
+
+int main()
+{
+	static_assert(adv::Store<int>::instrumented(), "ADV_STORE_INSTRUMENTATION must enable the counters");
+
+	test::run("shifts and reallocations", [] {
+		adv::Store<int> store;
+		store.reserve(4);
+		for (int i = 0; i < 4; ++i)
+		{
+			store.push_back(i);
+		}
+		CHECK(store.stats()[adv::StoreOp::push_back].calls == 4);
+		CHECK(store.stats()[adv::StoreOp::push_back].reallocations == 0);
+
+		store.push_back(4); // Full: one reallocation copying 4 elements
+		const adv::OpCounters push = store.stats()[adv::StoreOp::push_back];
+		CHECK(push.reallocations == 1);
+		CHECK(push.bytes_copied == 4 * sizeof(int));
+
+		store.push_front(-1); // Shifts all 5
+		CHECK(store.stats()[adv::StoreOp::push_front].shifted == 5);
+		store.insert(2, 7); // Shifts the 4 after position 2
+		CHECK(store.stats()[adv::StoreOp::insert].shifted == 4);
+		store.pop_front(); // Shifts the remaining 6
+		CHECK(store.stats()[adv::StoreOp::pop_front].shifted == 6);
+		store.remove_at(4); // Shifts the last one
+		CHECK(store.stats()[adv::StoreOp::remove_at].shifted == 1);
+	});
+
+	test::run("scans", [] {
+		adv::Store<int> empty;
+		CHECK(!empty.contains(3));
+		CHECK(empty.stats()[adv::StoreOp::contains].calls == 1);
+		CHECK(empty.stats()[adv::StoreOp::contains].scans == 0);
+
+		adv::Store<int> store{5, 6, 7, 8};
+		CHECK(store.contains(7));  // Visits 3 elements
+		CHECK(!store.contains(9)); // Visits all 4
+		const adv::OpCounters contains = store.stats()[adv::StoreOp::contains];
+		CHECK(contains.scans == 2 && contains.scanned == 7);
+		store.find_all(6);
+		CHECK(store.stats()[adv::StoreOp::find_all].scanned == 4);
+
+		store.enable_membership_filter();
+		CHECK(!store.contains(100)); // Rejected by the filter, no scan
+		CHECK(store.stats()[adv::StoreOp::contains].scans <= 3);
+	});
+
+	test::run("reset, copy and dump", [] {
+		adv::Store<int> store{1, 2, 3};
+		store.push_front(0);
+		adv::Store<int> copy(store);
+		CHECK(copy.stats().total().calls == store.stats().total().calls);
+		copy.reset_stats();
+		CHECK(copy.stats().total().calls == 0);
+		CHECK(store.stats()[adv::StoreOp::push_front].calls == 1);
+		std::ostringstream out;
+		store.dump_stats(out);
+		CHECK(out.str().find("push_front") != std::string::npos);
+		CHECK(out.str().find("contains") == std::string::npos);
+	});
+
+	test::run("concurrent const calls lose no counts", [] {
+		adv::Store<int> store;
+		for (int i = 0; i < 1000; ++i)
+		{
+			store.push_back(i);
+		}
+		const adv::Store<int> &shared = store;
+		std::vector<std::thread> threads;
+		for (int t = 0; t < 4; ++t)
+		{
+			threads.emplace_back([&] {
+				for (int i = 0; i < 1000; ++i)
+				{
+					(void)shared.contains(i);
+				}
+			});
+		}
+		for (std::thread &thread : threads)
+		{
+			thread.join();
+		}
+		const adv::OpCounters contains = store.stats()[adv::StoreOp::contains];
+		CHECK(contains.calls == 4000);
+		CHECK(contains.scanned == 4 * 1000 * 1001 / 2);
+	});
+
+	test::run("histogram buckets and percentiles", [] {
+		for (uint64_t ns = 0; ns < (uint64_t(1) << 40); ns = ns * 3 / 2 + 1)
+		{
+			// Upper bound never below the value, at most 1/16 above it
+			const uint64_t upper = adv::LatencyHistogram::bucket_upper(adv::LatencyHistogram::bucket_of(ns));
+			CHECK(upper >= ns && upper - ns <= ns / 16);
+		}
+		adv::LatencyHistogram histogram;
+		for (uint64_t ns = 1; ns <= 1000; ++ns)
+		{
+			histogram.record(ns);
+		}
+		CHECK(histogram.count() == 1000 && histogram.max() == 1000);
+		CHECK(histogram.mean() == 500.5);
+		const uint64_t p50 = histogram.percentile(50);
+		const uint64_t p99 = histogram.percentile(99);
+		CHECK(p50 >= 500 && p50 <= 500 + 500 / 16);
+		CHECK(p99 >= 990 && p99 <= 1000);
+		CHECK(histogram.percentile(100) == 1000);
+		CHECK(adv::LatencyHistogram().percentile(50) == 0);
+	});
+
+	test::run("latency shards merge on read", [] {
+		static_assert(adv::StoreLatency::compiled_in(), "ADV_STORE_TIMING must enable the timers");
+		adv::StoreLatency::reset();
+		std::vector<std::thread> threads;
+		for (int t = 0; t < 4; ++t)
+		{
+			threads.emplace_back([] {
+				adv::Store<int> store{1, 2, 3};
+				for (int i = 0; i < 250; ++i)
+				{
+					(void)store.contains(i);
+				}
+			});
+		}
+		for (std::thread &thread : threads)
+		{
+			thread.join();
+		}
+		// Every thread has exited, its samples still count
+		CHECK(adv::StoreLatency::snapshot(adv::StoreOp::contains).count() == 1000);
+
+		adv::StoreLatency::set_enabled(false);
+		adv::Store<int> store{1};
+		(void)store.contains(1);
+		adv::StoreLatency::set_enabled(true);
+		CHECK(adv::StoreLatency::snapshot(adv::StoreOp::contains).count() == 1000);
+		std::ostringstream out;
+		adv::StoreLatency::dump(out);
+		CHECK(out.str().find("contains") != std::string::npos);
+		adv::StoreLatency::reset();
+		CHECK(adv::StoreLatency::snapshot(adv::StoreOp::contains).count() == 0);
+	});
+
+	return test::report();
+}
@@ -0,0 +1,176 @@
+/**
+ * @file test_live.cpp
+ * @brief Kiểm tra live_filter(): LiveFilter cập nhật theo lịch sử thay đổi
+ *
+ * evaluations() đếm số lần gọi predicate: push_back chỉ làm đánh giá phần đuôi
+ * mới, replace_at chỉ đánh giá lại vị trí đã ghi, còn quá 64 replace_at giữa
+ * hai lần refresh, pop_back, insert, ghi qua operator[] đều buộc quét lại cả
+ * Store. Sau mọi kiểu thay đổi kết quả phải trùng với filter().
+ *
+ * Build & chạy:
+ *   g++ -std=c++17 -O2 -I<thư mục chứa advance/> tests/test_live.cpp -o test_live && ./test_live
+ */
+
+#include <random>
+#include <stdexcept>
+#include <vector>
+#include "advance/store/include/advance_store.hpp"
+#include "test_check.hpp"
+
+namespace
+{
+
+/// @brief Check that view holds exactly the elements store.filter() picks
+template <typename View, typename Pred>
+bool same_as_filter(const adv::Store<int> &store, const View &view, Pred pred)
+{
+	const adv::Store<int> expected = store.filter(pred);
+	const adv::Store<int> actual = view.to_store();
+	return std::vector<int>(actual.begin(), actual.end()) == std::vector<int>(expected.begin(), expected.end());
+}
+
+} // namespace
+
+int main()
+{
+	const auto is_even = [](int v) { return v % 2 == 0; };
+
+	test::run("appends evaluate only the tail", [&] {
+		adv::Store<int> store;
+		for (int i = 0; i < 1000; ++i)
+		{
+			store.push_back(i);
+		}
+		const auto evens = store.live_filter(is_even);
+		CHECK(evens.evaluations() == 1000 && evens.size() == 500);
+
+		for (int round = 0; round < 10; ++round)
+		{
+			for (int i = 0; i < 10; ++i)
+			{
+				store.push_back(1000 + round * 10 + i);
+			}
+			CHECK(evens.stale());
+			CHECK(evens.size() == 505 + 5 * static_cast<size_t>(round));
+			CHECK(evens.evaluations() == 1010 + 10 * static_cast<size_t>(round));
+		}
+		CHECK(!evens.stale() && evens.at(0) == 0 && evens.at(549) == 1098);
+	});
+
+	test::run("replace_at rechecks only its position", [&] {
+		adv::Store<int> store;
+		for (int i = 0; i < 1000; ++i)
+		{
+			store.push_back(i);
+		}
+		const auto evens = store.live_filter(is_even);
+		store.replace_at(1, 2);	  // Now matches
+		store.replace_at(10, 11); // No longer matches
+		store.push_back(1000);
+		CHECK(evens.size() == 501);
+		CHECK(evens.evaluations() == 1000 + 3);
+		CHECK(evens.positions()[1] == 1 && evens.positions()[6] == 12);
+		CHECK(same_as_filter(store, evens, is_even));
+	});
+
+	test::run("over 64 replace_at force a rescan", [&] {
+		adv::Store<int> store;
+		for (int i = 0; i < 1000; ++i)
+		{
+			store.push_back(i);
+		}
+		const auto evens = store.live_filter(is_even);
+
+		// 64 writes still fit the change log
+		for (size_t i = 0; i < 64; ++i)
+		{
+			store.replace_at(i, 1);
+		}
+		CHECK(evens.size() == 468 && evens.evaluations() == 1000 + 64);
+
+		// The 65th write between two refreshes drops the oldest entry
+		for (size_t i = 0; i < 65; ++i)
+		{
+			store.replace_at(i, 0);
+		}
+		CHECK(evens.size() == 532);
+		CHECK(evens.evaluations() == 1064 + 1000);
+		CHECK(same_as_filter(store, evens, is_even));
+	});
+
+	test::run("moving writes force a rescan", [&] {
+		adv::Store<int> store;
+		for (int i = 0; i < 100; ++i)
+		{
+			store.push_back(i);
+		}
+		const auto evens = store.live_filter(is_even);
+		size_t before = evens.evaluations();
+
+		store.pop_back();
+		CHECK(evens.size() == 50 && evens.evaluations() == before + 99);
+		before = evens.evaluations();
+
+		store.insert(0, 7); // Shifts every position
+		CHECK(evens.size() == 50 && evens.positions()[0] == 1);
+		CHECK(evens.evaluations() == before + 100);
+		before = evens.evaluations();
+
+		store[0] = 8; // Untracked write through mutable access
+		CHECK(evens.size() == 51 && evens.evaluations() == before + 100);
+		CHECK(same_as_filter(store, evens, is_even));
+
+		store.remove_at(0);
+		store.sort(false);
+		CHECK(same_as_filter(store, evens, is_even));
+		store.clear();
+		CHECK(evens.empty());
+
+		bool threw = false;
+		try
+		{
+			evens.at(0);
+		}
+		catch (const std::out_of_range &)
+		{
+			threw = true;
+		}
+		CHECK(threw);
+	});
+
+	test::run("random modifications", [&] {
+		std::mt19937 gen(72);
+		adv::Store<int> store;
+		const auto small = [](int v) { return v < 100; };
+		const auto view = store.live_filter(small);
+		for (int step = 0; step < 2000; ++step)
+		{
+			const unsigned kind = gen() % 8;
+			const int value = static_cast<int>(gen() % 400);
+			if (kind < 4 || store.empty())
+			{
+				store.push_back(value);
+			}
+			else if (kind < 6)
+			{
+				store.replace_at(gen() % store.size(), value);
+			}
+			else if (kind == 6)
+			{
+				store.remove_at(gen() % store.size());
+			}
+			else
+			{
+				store.insert(gen() % store.size(), value);
+			}
+			if (step % 7 == 0 && !same_as_filter(store, view, small))
+			{
+				CHECK(false);
+				break;
+			}
+		}
+		CHECK(same_as_filter(store, view, small));
+	});
+
+	return test::report();
+}
@@ -0,0 +1,170 @@
+/**
+ * @file test_math.cpp
+ * @brief Kiểm tra advance_store_math.hpp: dot, axpy, biểu thức lazy adv::ops
+ *
+ * dot()/axpy() và evaluate()/sum() của biểu thức được so với vòng lặp tuần tự
+ * ở nhiều độ dài (kể cả phần dư không chia hết cho độ rộng SIMD). Kiểu kết quả
+ * được nâng như phép toán C++ (int * 0.5 là double), out có thể xuất hiện
+ * trong chính biểu thức, và hai Store khác độ dài bị từ chối.
+ *
+ * Build & chạy:
+ *   g++ -std=c++17 -O2 -I<thư mục chứa advance/> tests/test_math.cpp -o test_math && ./test_math
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+#include <type_traits>
+#include "advance/store/include/advance_store_math.hpp"
+#include "test_check.hpp"
+
+using namespace adv::ops;
+
+namespace
+{
+
+/// @brief Check that a and b agree up to a relative tolerance
+bool close(double a, double b, double tolerance)
+{
+	return std::fabs(a - b) <= tolerance * std::max(1.0, std::fabs(b));
+}
+
+} // namespace
+
+int main()
+{
+	std::mt19937 gen(73);
+
+	test::run("dot and axpy match a loop", [&] {
+		for (const size_t n : {0, 1, 3, 4, 7, 8, 9, 100, 1001})
+		{
+			adv::Store<double> a(n), b(n);
+			adv::Store<float> fa(n), fb(n);
+			adv::Store<int> ia(n), ib(n);
+			double expected = 0;
+			float fexpected = 0;
+			int iexpected = 0;
+			for (size_t i = 0; i < n; ++i)
+			{
+				a[i] = gen() % 100 / 7.0;
+				b[i] = gen() % 100 / 3.0;
+				fa[i] = gen() % 10 / 4.0f;
+				fb[i] = gen() % 10 / 2.0f;
+				ia[i] = static_cast<int>(gen() % 10);
+				ib[i] = static_cast<int>(gen() % 10);
+				expected += a[i] * b[i];
+				fexpected += fa[i] * fb[i];
+				iexpected += ia[i] * ib[i];
+			}
+			CHECK(close(adv::dot(a, b), expected, 1e-9));
+			CHECK(close(adv::dot(fa, fb), fexpected, 1e-3));
+			CHECK(adv::dot(ia, ib) == iexpected);
+
+			adv::Store<double> y = b;
+			adv::axpy(3.0, a, y);
+			bool agrees = true;
+			for (size_t i = 0; i < n; ++i)
+			{
+				agrees = agrees && y[i] == b[i] + 3.0 * a[i];
+			}
+			CHECK(agrees);
+		}
+	});
+
+	test::run("expressions evaluate fused", [&] {
+		for (const size_t n : {0, 1, 5, 64, 1001})
+		{
+			adv::Store<double> a(n), b(n), c(n);
+			adv::Store<int> ia(n), ib(n);
+			for (size_t i = 0; i < n; ++i)
+			{
+				a[i] = gen() % 100 / 7.0;
+				b[i] = gen() % 100 / 3.0;
+				c[i] = gen() % 10;
+				ia[i] = static_cast<int>(gen() % 10);
+				ib[i] = static_cast<int>(gen() % 10);
+			}
+			adv::Store<double> out;
+			adv::evaluate(out, a * b + c);
+			const adv::Store<double> scaled = adv::evaluate(2.0 * a - c / 2 + 1);
+			const adv::Store<int> mixed = adv::evaluate(adv::ops::expr(ia) * 2 + ib);
+			double expected_sum = 0;
+			bool agrees = out.size() == n && scaled.size() == n && mixed.size() == n;
+			for (size_t i = 0; i < n && agrees; ++i)
+			{
+				agrees = out[i] == a[i] * b[i] + c[i] && scaled[i] == 2.0 * a[i] - c[i] / 2 + 1 &&
+						 mixed[i] == ia[i] * 2 + ib[i];
+				expected_sum += a[i] * b[i];
+			}
+			CHECK(agrees);
+			CHECK(close(adv::sum(a * b), expected_sum, 1e-9));
+
+			// The destination may appear in its own expression
+			adv::evaluate(a, a * b + c);
+			CHECK(std::equal(a.begin(), a.end(), out.begin(), out.end()));
+		}
+	});
+
+	test::run("result types follow C++ promotion", [] {
+		const adv::Store<int> a{10, 20, 30};
+		const auto halves = adv::evaluate(a * 0.5);
+		static_assert(std::is_same_v<decltype(halves), const adv::Store<double>>);
+		CHECK(halves[0] == 5.0 && halves[2] == 15.0);
+
+		const adv::Store<float> f{1, 2, 3};
+		const auto fhalves = adv::evaluate(f * 0.5);
+		static_assert(std::is_same_v<decltype(fhalves), const adv::Store<float>>);
+		CHECK(fhalves[1] == 1.0f);
+
+		const auto ints = adv::evaluate(a * 2 + 1);
+		static_assert(std::is_same_v<decltype(ints), const adv::Store<int>>);
+		CHECK(ints[2] == 61);
+
+		const adv::Store<double> d{0.25, 0.5, 0.75};
+		const auto sums = adv::evaluate(a + d);
+		static_assert(std::is_same_v<decltype(sums), const adv::Store<double>>);
+		CHECK(sums[0] == 10.25);
+		CHECK(adv::sum(a / 4.0) == 15.0);
+
+		// Evaluating into an int store converts each element back
+		adv::Store<int> out;
+		adv::evaluate(out, a * 0.5);
+		CHECK(out[0] == 5 && out[2] == 15);
+	});
+
+	test::run("length mismatch is rejected", [] {
+		const adv::Store<double> three(size_t(3)), four(size_t(4));
+		adv::Store<double> target(size_t(4));
+		size_t throws = 0;
+		try
+		{
+			const auto e = three * four;
+			(void)e;
+		}
+		catch (const std::invalid_argument &)
+		{
+			++throws;
+		}
+		try
+		{
+			adv::dot(three, four);
+		}
+		catch (const std::invalid_argument &)
+		{
+			++throws;
+		}
+		try
+		{
+			adv::axpy(1.0, three, target);
+		}
+		catch (const std::invalid_argument &)
+		{
+			++throws;
+		}
+		CHECK(throws == 3);
+		CHECK(target[0] == 0.0);
+	});
+
+	return test::report();
+}
@@ -0,0 +1,159 @@
+/**
+ * @file test_membership.cpp
+ * @brief Kiểm tra enable_membership_filter(): contains()/find_all() qua Bloom filter
+ *
+ * Kết quả có filter phải trùng với Store không có filter sau mọi kiểu thay
+ * đổi (push, xóa, replace_at, ghi qua operator[] hay iterator), tỉ lệ dương
+ * tính giả ở 10 bit/phần tử khoảng 1%. Filter chỉ được cấp phát khi bật, copy
+ * mang theo filter riêng, nhiều reader const đồng thời được phép (nên chạy
+ * thêm dưới -fsanitize=thread).
+ *
+ * Build & chạy:
+ *   g++ -std=c++17 -O2 -I<thư mục chứa advance/> tests/test_membership.cpp -o test_membership -pthread && ./test_membership
+ */
+
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include "advance/store/include/advance_store.hpp"
+#include "test_check.hpp"
+
+namespace
+{
+
+/// @brief Check that filtered answers like plain for every value in [lo, hi)
+bool same_answers(const adv::Store<int> &filtered, const adv::Store<int> &plain, int lo, int hi)
+{
+	for (int value = lo; value < hi; ++value)
+	{
+		if (filtered.contains(value) != plain.contains(value) || filtered.find_all(value) != plain.find_all(value))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+} // namespace
+
+int main()
+{
+	std::mt19937 gen(63);
+
+	test::run("filtered lookups match a scan", [&] {
+		adv::Store<int> filtered;
+		adv::Store<int> plain;
+		filtered.enable_membership_filter();
+		CHECK(filtered.membership_filter_enabled() && !plain.membership_filter_enabled());
+		for (int round = 0; round < 20; ++round)
+		{
+			for (int i = 0; i < 200; ++i)
+			{
+				const int value = static_cast<int>(gen() % 3000);
+				filtered.push_back(value);
+				plain.push_back(value);
+			}
+			const size_t pos = gen() % filtered.size();
+			filtered.remove_at(pos);
+			plain.remove_at(pos);
+			filtered.replace_at(0, 5000 + round);
+			plain.replace_at(0, 5000 + round);
+			filtered[1] = 6000 + round; // Mutable access, seen through the version
+			plain[1] = 6000 + round;
+			*(filtered.end() - 1) = 7000 + round;
+			*(plain.end() - 1) = 7000 + round;
+			CHECK(same_answers(filtered, plain, 0, 3000));
+			CHECK(filtered.contains(5000 + round) && filtered.contains(6000 + round) && filtered.contains(7000 + round));
+		}
+		filtered.clear();
+		CHECK(!filtered.contains(5) && filtered.find_all(5).empty());
+	});
+
+	test::run("false positive rate", [] {
+		adv::detail::MembershipFilter filter(10);
+		std::vector<int> keys(10000);
+		for (int i = 0; i < 10000; ++i)
+		{
+			keys[i] = i;
+		}
+		const auto hash = [](int key) { return adv::detail::mix_hash(std::hash<int>()(key)); };
+		filter.ensure(keys, 1, hash);
+		CHECK(filter.current(1) && !filter.current(2));
+		bool no_false_negative = true;
+		for (const int key : keys)
+		{
+			no_false_negative = no_false_negative && filter.may_contain(hash(key));
+		}
+		CHECK(no_false_negative);
+		size_t false_positives = 0;
+		for (int key = 10000; key < 110000; ++key)
+		{
+			false_positives += filter.may_contain(hash(key)) ? 1 : 0;
+		}
+		CHECK(false_positives < 2000); // About 1% expected, 2% allowed
+	});
+
+	test::run("allocated only when enabled", [] {
+		CHECK(sizeof(adv::detail::CacheSlot<adv::detail::MembershipFilter>) == sizeof(void *));
+		adv::Store<std::string> words{"a", "b"};
+		words.enable_membership_filter(16);
+		CHECK(words.contains("a") && !words.contains("z"));
+
+		// Copies carry their own filter, moves transfer it
+		adv::Store<std::string> copy(words);
+		copy.push_back(std::string("z"));
+		CHECK(copy.membership_filter_enabled() && copy.contains("z") && !words.contains("z"));
+		adv::Store<std::string> moved(std::move(copy));
+		CHECK(moved.membership_filter_enabled() && moved.contains("z"));
+		words = moved;
+		CHECK(words.contains("z"));
+
+		words.disable_membership_filter();
+		CHECK(!words.membership_filter_enabled() && words.contains("z"));
+
+		bool threw = false;
+		try
+		{
+			words.enable_membership_filter(0);
+		}
+		catch (const std::invalid_argument &)
+		{
+			threw = true;
+		}
+		CHECK(threw);
+	});
+
+	test::run("concurrent const lookups", [] {
+		adv::Store<int> store;
+		for (int i = 0; i < 20000; i += 2)
+		{
+			store.push_back(i);
+		}
+		store.enable_membership_filter();
+		for (int round = 0; round < 3; ++round)
+		{
+			store.push_back(20000 + round); // Every round starts with a stale filter
+			const adv::Store<int> &shared = store;
+			std::vector<std::thread> threads;
+			std::vector<int> wrong(4, 0);
+			for (int t = 0; t < 4; ++t)
+			{
+				threads.emplace_back([&, t] {
+					for (int value = t; value < 20000; value += 4)
+					{
+						wrong[t] += shared.contains(value) != (value % 2 == 0) ? 1 : 0;
+					}
+				});
+			}
+			for (std::thread &thread : threads)
+			{
+				thread.join();
+			}
+			CHECK(wrong == std::vector<int>(4, 0));
+		}
+	});
+
+	return test::report();
+}
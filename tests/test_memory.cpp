@@ -0,0 +1,220 @@
+/**
+ * @file test_memory.cpp
+ * @brief Kiểm tra memory_usage(), TrackingAllocator, constructor nhận allocator
+ *        và CapacityPolicy
+ *
+ * Số byte do TrackingAllocator ghi nhận phải khớp với capacity của Store, về
+ * 0 khi Store bị hủy; memory_usage() phải tách đúng payload, slack và phần
+ * heap do phần tử sở hữu (string dài, Store lồng nhau). CapacityPolicy phải
+ * co lại khi thưa, có hysteresis và không làm mất phần tử khi copy/move ném
+ * exception.
+ *
+ * Build & chạy:
+ *   g++ -std=c++17 -O2 -I<thư mục chứa advance/> tests/test_memory.cpp -o test_memory && ./test_memory
+ */
+
+#include <list>
+#include <memory>
+#include <stdexcept>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "advance/store/include/advance_store.hpp"
+#include "test_check.hpp"
+
+namespace
+{
+
+/// @brief Element whose move may throw and whose copies throw once a budget runs out
+struct ThrowingCopy
+{
+	static inline int s_copies_left = 1 << 30;
+	int value;
+
+	explicit ThrowingCopy(int v) : value(v) {}
+	ThrowingCopy(const ThrowingCopy &other) : value(other.value)
+	{
+		if (--s_copies_left < 0)
+		{
+			throw std::runtime_error("copy");
+		}
+	}
+	ThrowingCopy(ThrowingCopy &&other) : value(other.value) {} // Not noexcept
+	ThrowingCopy &operator=(const ThrowingCopy &) = default;
+	bool operator==(const ThrowingCopy &other) const { return value == other.value; }
+};
+
+} // namespace
+
+int main()
+{
+	test::run("memory_usage splits payload, slack and deep", [] {
+		adv::Store<int> ints{1, 2, 3};
+		ints.reserve(10);
+		const adv::MemoryUsage usage = ints.memory_usage();
+		CHECK(usage.payload == 3 * sizeof(int));
+		CHECK(usage.slack == (ints.capacity() - 3) * sizeof(int));
+		CHECK(usage.deep == 0 && usage.total() == ints.capacity() * sizeof(int));
+
+		// Short strings live inside the object (SSO), long ones on the heap
+		adv::Store<std::string> words{"a", std::string(100, 'x')};
+		CHECK(words.memory_usage().deep >= 101);
+		CHECK(words.memory_usage().deep <= 2 * 101);
+
+		adv::Store<adv::Store<int>> nested;
+		nested.push_back(adv::Store<int>(50));
+		CHECK(nested.memory_usage().deep >= 50 * sizeof(int));
+	});
+
+	test::run("tracking allocator follows capacity", [] {
+		adv::AllocationStats stats;
+		{
+			adv::Store<int, adv::TrackingAllocator<int>> store{adv::TrackingAllocator<int>(stats)};
+			for (int i = 0; i < 1000; ++i)
+			{
+				store.push_back(i);
+			}
+			CHECK(stats.bytes_live() == store.capacity() * sizeof(int));
+			CHECK(stats.allocations() == stats.deallocations() + 1);
+			CHECK(stats.bytes_peak() >= stats.bytes_live());
+			store.shrink_to_fit();
+			CHECK(stats.bytes_live() == 1000 * sizeof(int));
+		}
+		CHECK(stats.bytes_live() == 0);
+		CHECK(stats.allocations() == stats.deallocations());
+		stats.reset();
+		CHECK(stats.allocations() == 0 && stats.bytes_peak() == 0);
+	});
+
+	test::run("every constructor takes the allocator", [] {
+		adv::AllocationStats &group = adv::allocation_group("test_memory");
+		const adv::TrackingAllocator<int> alloc(group);
+		const std::vector<int> values{1, 2, 3, 4};
+		const std::list<int> linked{7, 8};
+		const adv::Store<int, adv::TrackingAllocator<int>> stores[] = {
+			adv::Store<int, adv::TrackingAllocator<int>>(alloc),
+			adv::Store<int, adv::TrackingAllocator<int>>(size_t(5), alloc),
+			adv::Store<int, adv::TrackingAllocator<int>>({1, 2, 3}, alloc),
+			adv::Store<int, adv::TrackingAllocator<int>>(values.begin(), values.end(), alloc),
+			adv::Store<int, adv::TrackingAllocator<int>>(linked, alloc),
+		};
+		const size_t sizes[] = {0, 5, 3, 4, 2};
+		for (size_t i = 0; i < 5; ++i)
+		{
+			CHECK(stores[i].size() == sizes[i]);
+			CHECK(&stores[i].get_allocator().stats() == &group);
+		}
+		CHECK(group.bytes_live() == (5 + 3 + 4 + 2) * sizeof(int));
+		std::ostringstream out;
+		adv::dump_allocation_groups(out);
+		CHECK(out.str().find("test_memory: ") != std::string::npos);
+
+		// Without an allocator the overloads stay unambiguous
+		const adv::Store<size_t> sized(size_t(4));
+		const adv::Store<int> from_range(values);
+		CHECK(sized.size() == 4 && from_range.size() == 4);
+	});
+
+	test::run("copies keep the allocator", [] {
+		adv::AllocationStats stats;
+		adv::TrackedStore<std::string> store{adv::TrackingAllocator<std::string>(stats)};
+		store.push_back(std::string("one"));
+		adv::TrackedStore<std::string> copy(store);
+		CHECK(&copy.get_allocator().stats() == &stats);
+		adv::TrackedStore<std::string> moved(std::move(copy));
+		CHECK(&moved.get_allocator().stats() == &stats && moved.size() == 1);
+	});
+
+	test::run("adaptive policy shrinks with hysteresis", [] {
+		adv::AllocationStats stats;
+		adv::Store<int, adv::TrackingAllocator<int>> store{adv::TrackingAllocator<int>(stats)};
+		store.set_capacity_policy(adv::CapacityPolicy::adaptive(16));
+		for (int i = 0; i < 1024; ++i)
+		{
+			store.push_back(i);
+		}
+		CHECK(store.capacity() == 1024);
+		while (store.size() > 200)
+		{
+			store.pop_back();
+		}
+		// Shrunk once the store fell below a quarter, to size * 2 + 1
+		CHECK(store.capacity() < 1024 && store.capacity() >= 2 * store.size());
+		CHECK(stats.bytes_live() == store.capacity() * sizeof(int));
+
+		// Bouncing around the new size does not reallocate
+		const uint64_t allocations = stats.allocations();
+		for (int round = 0; round < 100; ++round)
+		{
+			store.push_back(round);
+			store.pop_front();
+		}
+		CHECK(stats.allocations() == allocations);
+
+		store.clear();
+		CHECK(store.capacity() == 16);
+		for (int i = 0; i < 17; ++i)
+		{
+			store.push_back(i);
+		}
+		CHECK(store.capacity() == 32); // Growth factor 2
+		for (int i = 0; i < 17; ++i)
+		{
+			CHECK(store[i] == i);
+		}
+	});
+
+	test::run("invalid policies are rejected", [] {
+		adv::Store<int> store;
+		for (const adv::CapacityPolicy policy : {adv::CapacityPolicy{0.5, 0.0, 0}, adv::CapacityPolicy{2.0, 0.5, 0},
+												 adv::CapacityPolicy{0.0, 1.0, 0}})
+		{
+			bool threw = false;
+			try
+			{
+				store.set_capacity_policy(policy);
+			}
+			catch (const std::invalid_argument &)
+			{
+				threw = true;
+			}
+			CHECK(threw);
+		}
+	});
+
+	test::run("shrinking never loses elements", [] {
+		adv::Store<ThrowingCopy> copyable;
+		copyable.set_capacity_policy(adv::CapacityPolicy::adaptive());
+		for (int i = 0; i < 1000; ++i)
+		{
+			copyable.emplace_back(i);
+		}
+		ThrowingCopy::s_copies_left = 3; // The shrink copy fails part way
+		for (int i = 0; i < 900; ++i)
+		{
+			copyable.pop_back();
+		}
+		ThrowingCopy::s_copies_left = 1 << 30;
+		bool intact = copyable.size() == 100;
+		for (int i = 0; i < 100 && intact; ++i)
+		{
+			intact = copyable[i].value == i;
+		}
+		CHECK(intact);
+
+		adv::Store<std::unique_ptr<int>> move_only;
+		move_only.set_capacity_policy(adv::CapacityPolicy::adaptive());
+		for (int i = 0; i < 1000; ++i)
+		{
+			move_only.push_back(std::make_unique<int>(i));
+		}
+		for (int i = 0; i < 990; ++i)
+		{
+			move_only.pop_back();
+		}
+		CHECK(move_only.capacity() < 1000);
+		CHECK(move_only.size() == 10 && *move_only[9] == 9);
+	});
+
+	return test::report();
+}
@@ -0,0 +1,142 @@
+/**
+ * @file test_merge.cpp
+ * @brief Kiểm tra operator+= giữ thứ tự sort và k-way merge (advance_store_merge.hpp)
+ *
+ * operator+= chỉ được merge khi cả hai Store chắc chắn đã sort; ghi qua
+ * operator[] hay iterator phải làm mất thứ tự đã nhớ. merge / merge_unique
+ * được so với std::merge / std::unique trên cùng dữ liệu, run chưa sort phải
+ * bị từ chối.
+ *
+ * Build & chạy:
+ *   g++ -std=c++17 -O2 -I<thư mục chứa advance/> tests/test_merge.cpp -o test_merge && ./test_merge
+ */
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <random>
+#include <stdexcept>
+#include <vector>
+#include "advance/store/include/advance_store_merge.hpp"
+#include "test_check.hpp"
+
+namespace
+{
+
+/// @brief Copy a store into a std::vector
+template <typename T>
+std::vector<T> to_vector(const adv::Store<T> &store)
+{
+	return std::vector<T>(store.cbegin(), store.cend());
+}
+
+/// @brief Sorted store of count random values below limit
+adv::Store<int> sorted_random(std::mt19937 &gen, size_t count, int limit)
+{
+	adv::Store<int> store;
+	for (size_t i = 0; i < count; ++i)
+	{
+		store.push_back(static_cast<int>(gen() % limit));
+	}
+	store.sort();
+	return store;
+}
+
+} // namespace
+
+int main()
+{
+	std::mt19937 gen(64);
+
+	test::run("append merges sorted stores", [] {
+		adv::Store<int> a{1, 4, 7};
+		adv::Store<int> b{2, 3, 9};
+		a.sort();
+		b.sort();
+		a += std::move(b);
+		CHECK((to_vector(a) == std::vector<int>{1, 2, 3, 4, 7, 9}));
+		CHECK(a.sort_order() == adv::SortOrder::ascending);
+
+		adv::Store<int> down{9, 5};
+		adv::Store<int> more{8, 1};
+		down.sort(false);
+		more.sort(false);
+		down += std::move(more);
+		CHECK((to_vector(down) == std::vector<int>{9, 8, 5, 1}));
+		CHECK(down.sort_order() == adv::SortOrder::descending);
+
+		// Unknown order on either side appends as is
+		adv::Store<int> plain{5, 1};
+		adv::Store<int> tail{0};
+		tail.sort();
+		plain += std::move(tail);
+		CHECK((to_vector(plain) == std::vector<int>{5, 1, 0}));
+		CHECK(plain.sort_order() == adv::SortOrder::unknown);
+	});
+
+	test::run("write through operator[] drops the order", [] {
+		adv::Store<int> a{2, 3, 4};
+		adv::Store<int> b{5, 6, 7};
+		a.sort();
+		b.sort();
+		a[0] = 100;
+		CHECK(a.sort_order() == adv::SortOrder::unknown);
+		a += std::move(b);
+		CHECK((to_vector(a) == std::vector<int>{100, 3, 4, 5, 6, 7}));
+		CHECK(a.sort_order() == adv::SortOrder::unknown);
+
+		adv::Store<int> c{1, 2};
+		c.sort();
+		*c.begin() = 50;
+		CHECK(c.sort_order() == adv::SortOrder::unknown);
+		c.mark_sorted(false);
+		CHECK(c.sort_order() == adv::SortOrder::descending);
+	});
+
+	test::run("k-way merge matches std::merge", [&] {
+		std::vector<adv::Store<int>> runs;
+		std::vector<int> expected;
+		for (size_t k = 0; k < 9; ++k)
+		{
+			runs.push_back(sorted_random(gen, k * 37, 500));
+			expected.insert(expected.end(), runs.back().cbegin(), runs.back().cend());
+		}
+		runs.push_back(adv::Store<int>()); // Empty runs are fine
+		std::sort(expected.begin(), expected.end());
+		const adv::Store<int> merged = adv::merge(runs);
+		CHECK(to_vector(merged) == expected);
+		CHECK(merged.sort_order() == adv::SortOrder::ascending);
+
+		const adv::Store<int> deduped = adv::merge(runs, true);
+		expected.erase(std::unique(expected.begin(), expected.end()), expected.end());
+		CHECK(to_vector(deduped) == expected);
+
+		const adv::Store<int> a = sorted_random(gen, 100, 50);
+		const adv::Store<int> b = sorted_random(gen, 80, 50);
+		std::vector<int> both;
+		std::merge(a.cbegin(), a.cend(), b.cbegin(), b.cend(), std::back_inserter(both));
+		CHECK(to_vector(adv::merge(a, b)) == both);
+		both.erase(std::unique(both.begin(), both.end()), both.end());
+		CHECK(to_vector(adv::merge_unique(a, b)) == both);
+	});
+
+	test::run("descending and unsorted runs", [] {
+		std::vector<adv::Store<int>> runs{adv::Store<int>{9, 4, 1}, adv::Store<int>{8, 4, 0}};
+		const adv::Store<int> merged = adv::merge(runs, false, std::greater<int>());
+		CHECK((to_vector(merged) == std::vector<int>{9, 8, 4, 4, 1, 0}));
+		CHECK(merged.sort_order() == adv::SortOrder::descending);
+
+		bool threw = false;
+		try
+		{
+			adv::merge(adv::Store<int>{1, 3}, adv::Store<int>{5, 2});
+		}
+		catch (const std::invalid_argument &)
+		{
+			threw = true;
+		}
+		CHECK(threw);
+	});
+
+	return test::report();
+}
@@ -0,0 +1,166 @@
+/**
+ * @file test_range.cpp
+ * @brief Kiểm tra enable_range_index(): range_sum / range_min / range_max
+ *
+ * Sau mỗi thao tác ngẫu nhiên (replace_at, fill cập nhật tại chỗ; push, xóa,
+ * ghi qua operator[] buộc build lại) kết quả truy vấn được so với cách tính
+ * trực tiếp trên cùng dữ liệu. Index chỉ được cấp phát khi bật, copy mang theo
+ * index riêng, truy vấn const đồng thời được phép (nên chạy thêm dưới
+ * -fsanitize=thread).
+ *
+ * Build & chạy:
+ *   g++ -std=c++17 -O2 -I<thư mục chứa advance/> tests/test_range.cpp -o test_range -pthread && ./test_range
+ */
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include "advance/store/include/advance_store.hpp"
+#include "test_check.hpp"
+
+namespace
+{
+
+/// @brief Check a few random ranges of store against direct computation
+bool ranges_agree(const adv::Store<long long> &store, std::mt19937 &gen)
+{
+	for (int query = 0; query < 50; ++query)
+	{
+		const size_t first = gen() % store.size();
+		const size_t last = first + 1 + gen() % (store.size() - first);
+		const auto begin = store.cbegin() + first;
+		const auto end = store.cbegin() + last;
+		if (store.range_sum(first, last) != std::accumulate(begin, end, 0LL) ||
+			store.range_min(first, last) != *std::min_element(begin, end) ||
+			store.range_max(first, last) != *std::max_element(begin, end))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+} // namespace
+
+int main()
+{
+	std::mt19937 gen(68);
+
+	test::run("queries match direct computation", [&] {
+		adv::Store<long long> store;
+		for (int i = 0; i < 1000; ++i)
+		{
+			store.push_back(static_cast<long long>(gen() % 2001) - 1000);
+		}
+		CHECK(ranges_agree(store, gen)); // Without the index
+		store.enable_range_index();
+		CHECK(store.range_index_enabled());
+		bool ok = true;
+		for (int step = 0; step < 300 && ok; ++step)
+		{
+			const size_t pos = gen() % store.size();
+			const long long value = static_cast<long long>(gen() % 2001) - 1000;
+			switch (step % 6)
+			{
+			case 0:
+			case 1:
+			case 2:
+				store.replace_at(pos, value); // Updated in place
+				break;
+			case 3:
+				store[pos] = value; // Rebuilt on the next query
+				break;
+			case 4:
+				store.push_back(value);
+				store.remove_at(pos);
+				break;
+			default:
+				if (step % 60 == 5)
+				{
+					store.fill(value);
+				}
+				*(store.begin() + pos) = value;
+				break;
+			}
+			ok = ranges_agree(store, gen);
+		}
+		CHECK(ok);
+	});
+
+	test::run("non-arithmetic elements", [] {
+		adv::Store<std::string> words{"pear", "apple", "fig", "plum"};
+		words.enable_range_index();
+		CHECK(words.range_min(0, 4) == "apple" && words.range_max(0, 4) == "plum");
+		words.replace_at(1, "zucchini");
+		CHECK(words.range_min(0, 4) == "fig" && words.range_max(1, 3) == "zucchini");
+	});
+
+	test::run("allocated only when enabled", [] {
+		CHECK(sizeof(adv::detail::CacheSlot<adv::detail::RangeTrees<int>>) == sizeof(void *));
+		adv::Store<int> store{4, 2, 6};
+		store.enable_range_index();
+		store.enable_range_index(); // Keeps the existing trees
+		adv::Store<int> copy(store);
+		copy.replace_at(0, -1);
+		CHECK(copy.range_index_enabled() && copy.range_min(0, 3) == -1 && store.range_min(0, 3) == 2);
+		adv::Store<int> moved(std::move(copy));
+		CHECK(moved.range_index_enabled() && moved.range_sum(0, 3) == 7);
+		moved.disable_range_index();
+		CHECK(!moved.range_index_enabled() && moved.range_sum(0, 3) == 7);
+	});
+
+	test::run("invalid ranges", [] {
+		adv::Store<int> store{1, 2, 3};
+		store.enable_range_index();
+		CHECK(store.range_sum(1, 1) == 0);
+		int errors = 0;
+		for (const auto &range : {std::pair<size_t, size_t>{2, 1}, {0, 4}, {1, 1}})
+		{
+			try
+			{
+				store.range_min(range.first, range.second);
+			}
+			catch (const std::out_of_range &)
+			{
+				++errors;
+			}
+		}
+		CHECK(errors == 3);
+	});
+
+	test::run("concurrent const queries", [] {
+		adv::Store<int> store(10000);
+		std::iota(store.begin(), store.end(), 0);
+		store.enable_range_index();
+		for (int round = 0; round < 3; ++round)
+		{
+			store.push_back(10000 + round); // Every round starts with stale trees
+			const adv::Store<int> &shared = store;
+			const int n = static_cast<int>(store.size());
+			std::vector<std::thread> threads;
+			std::vector<int> wrong(4, 0);
+			for (int t = 0; t < 4; ++t)
+			{
+				threads.emplace_back([&, t] {
+					for (int i = t; i < 2000; i += 4)
+					{
+						const size_t first = static_cast<size_t>(i);
+						wrong[t] += shared.range_min(first, shared.size()) != i ? 1 : 0;
+						wrong[t] += shared.range_max(0, first + 1) != i ? 1 : 0;
+					}
+				});
+			}
+			for (std::thread &thread : threads)
+			{
+				thread.join();
+			}
+			CHECK(wrong == std::vector<int>(4, 0) && store.range_max(0, store.size()) == n - 1);
+		}
+	});
+
+	return test::report();
+}
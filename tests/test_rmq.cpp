@@ -0,0 +1,125 @@
+/**
+ * @file test_rmq.cpp
+ * @brief Kiểm tra freeze_rmq(): range_min / range_max / argmin / argmax O(1)
+ *
+ * Mọi truy vấn được so với một lượt quét trực tiếp, ở các kích thước quanh
+ * biên block và với nhiều giá trị trùng (vị trí trả về phải là vị trí trái
+ * nhất). argmin_all / argmax_all phải trả lời giống từng truy vấn riêng, dù
+ * lô đã sort hay chưa. Cấu trúc tự build lại sau khi Store thay đổi.
+ *
+ * Build & chạy:
+ *   g++ -std=c++17 -O2 -I<thư mục chứa advance/> tests/test_rmq.cpp -o test_rmq && ./test_rmq
+ */
+
+#include <algorithm>
+#include <random>
+#include <stdexcept>
+#include <vector>
+#include "advance/store/include/advance_store.hpp"
+#include "test_check.hpp"
+
+int main()
+{
+	std::mt19937 gen(69);
+
+	test::run("queries match a scan", [&] {
+		bool ok = true;
+		for (const size_t n : {1, 2, 31, 32, 33, 63, 64, 65, 100, 1000, 5000})
+		{
+			for (const int range : {3, 1000000}) // Many ties, then few
+			{
+				adv::Store<int> store;
+				for (size_t i = 0; i < n; ++i)
+				{
+					store.push_back(static_cast<int>(gen() % range));
+				}
+				const auto rmq = store.freeze_rmq();
+				const adv::Store<int> &values = store;
+				for (int query = 0; query < 500; ++query)
+				{
+					size_t first = gen() % n;
+					size_t last = gen() % n;
+					if (first > last)
+					{
+						std::swap(first, last);
+					}
+					++last;
+					// Leftmost position of the extreme value
+					size_t lowest = first;
+					size_t highest = first;
+					for (size_t k = first; k < last; ++k)
+					{
+						lowest = values[k] < values[lowest] ? k : lowest;
+						highest = values[highest] < values[k] ? k : highest;
+					}
+					ok = ok && rmq.argmin(first, last) == lowest && rmq.argmax(first, last) == highest &&
+						 rmq.range_min(first, last) == values[lowest] && rmq.range_max(first, last) == values[highest];
+				}
+			}
+		}
+		CHECK(ok);
+	});
+
+	test::run("batch queries", [&] {
+		adv::Store<double> store;
+		for (int i = 0; i < 3000; ++i)
+		{
+			store.push_back(static_cast<double>(gen() % 1000) / 7.0);
+		}
+		const auto rmq = store.freeze_rmq();
+		std::vector<adv::RangeQuery> queries;
+		for (int q = 0; q < 2000; ++q)
+		{
+			const size_t first = gen() % store.size();
+			queries.push_back({first, first + 1 + gen() % (store.size() - first)});
+		}
+		for (int pass = 0; pass < 2; ++pass)
+		{
+			const std::vector<size_t> mins = rmq.argmin_all(queries);
+			const std::vector<size_t> maxes = rmq.argmax_all(queries);
+			bool ok = mins.size() == queries.size() && maxes.size() == queries.size();
+			for (size_t i = 0; i < queries.size() && ok; ++i)
+			{
+				ok = mins[i] == rmq.argmin(queries[i].first, queries[i].last) &&
+					 maxes[i] == rmq.argmax(queries[i].first, queries[i].last);
+			}
+			CHECK(ok);
+			// Second pass with the batch already in position order
+			std::sort(queries.begin(), queries.end(),
+					  [](const adv::RangeQuery &a, const adv::RangeQuery &b) { return a.first < b.first; });
+		}
+	});
+
+	test::run("rebuilds after modifications", [] {
+		adv::Store<int> store{5, 3, 8, 1, 9};
+		const auto rmq = store.freeze_rmq();
+		CHECK(rmq.argmin(0, 5) == 3 && !rmq.stale());
+		store.replace_at(0, -5);
+		CHECK(rmq.stale() && rmq.range_min(0, 5) == -5);
+		store.push_back(100);
+		CHECK(rmq.range_max(0, 6) == 100 && rmq.argmax(0, 6) == 5);
+		store[2] = 200;
+		CHECK(rmq.argmax(0, 6) == 2);
+		CHECK(rmq.bytes() > 0);
+	});
+
+	test::run("invalid ranges", [] {
+		adv::Store<int> store{1, 2, 3};
+		const auto rmq = store.freeze_rmq();
+		int errors = 0;
+		for (const adv::RangeQuery &query : {adv::RangeQuery{1, 1}, adv::RangeQuery{2, 1}, adv::RangeQuery{0, 4}})
+		{
+			try
+			{
+				rmq.argmin(query.first, query.last);
+			}
+			catch (const std::out_of_range &)
+			{
+				++errors;
+			}
+		}
+		CHECK(errors == 3);
+	});
+
+	return test::report();
+}
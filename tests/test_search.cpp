@@ -0,0 +1,108 @@
+/**
+ * @file test_search.cpp
+ * @brief Kiểm tra freeze_search(): layout Eytzinger cho Store đã sort
+ *
+ * lower_bound / upper_bound / count / contains được so với std::lower_bound
+ * và std::upper_bound ở các kích thước quanh lũy thừa của 2, với nhiều giá
+ * trị trùng. Các hàm theo lô phải trả lời giống từng lượt tìm riêng. Store
+ * chưa sort bị từ chối, cả lúc tạo lẫn lúc build lại.
+ *
+ * Build & chạy:
+ *   g++ -std=c++17 -O2 -I<thư mục chứa advance/> tests/test_search.cpp -o test_search && ./test_search
+ */
+
+#include <algorithm>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "advance/store/include/advance_store.hpp"
+#include "test_check.hpp"
+
+int main()
+{
+	std::mt19937 gen(70);
+
+	test::run("matches std::lower_bound", [&] {
+		bool ok = true;
+		for (const int n : {0, 1, 2, 3, 7, 8, 15, 16, 17, 100, 1023, 1024, 1025, 5000})
+		{
+			adv::Store<int> store;
+			for (int i = 0; i < n; ++i)
+			{
+				store.push_back(static_cast<int>(gen() % (n / 2 + 3)));
+			}
+			store.sort();
+			const auto search = store.freeze_search();
+			for (int value = -2; value < n / 2 + 6; ++value)
+			{
+				const auto first = store.cbegin();
+				const size_t lower = static_cast<size_t>(std::lower_bound(first, store.cend(), value) - first);
+				const size_t upper = static_cast<size_t>(std::upper_bound(first, store.cend(), value) - first);
+				ok = ok && search.lower_bound(value) == lower && search.upper_bound(value) == upper &&
+					 search.count(value) == upper - lower && search.contains(value) == (upper > lower);
+			}
+		}
+		CHECK(ok);
+	});
+
+	test::run("batch searches", [&] {
+		adv::Store<long long> store;
+		for (int i = 0; i < 10000; ++i)
+		{
+			store.push_back(static_cast<long long>(gen() % 30000));
+		}
+		store.sort();
+		const auto search = store.freeze_search();
+		std::vector<long long> values(3000);
+		for (long long &value : values)
+		{
+			value = static_cast<long long>(gen() % 31000) - 500;
+		}
+		const std::vector<size_t> lowers = search.lower_bound_all(values);
+		const std::vector<bool> found = search.contains_all(values);
+		bool ok = lowers.size() == values.size() && found.size() == values.size();
+		for (size_t i = 0; i < values.size() && ok; ++i)
+		{
+			ok = lowers[i] == search.lower_bound(values[i]) && found[i] == search.contains(values[i]);
+		}
+		CHECK(ok);
+		CHECK(search.lower_bound_all({}).empty());
+	});
+
+	test::run("strings and rebuilds", [] {
+		adv::Store<std::string> words{"e", "a", "c"};
+		words.sort();
+		const auto search = words.freeze_search();
+		CHECK(search.lower_bound("b") == 1 && search.contains("e") && !search.contains("f"));
+		words.push_back(std::string("g"));
+		CHECK(search.stale() && search.contains("g") && search.upper_bound("z") == 4);
+	});
+
+	test::run("unsorted stores are rejected", [] {
+		int errors = 0;
+		const adv::Store<int> unsorted{3, 1};
+		try
+		{
+			unsorted.freeze_search();
+		}
+		catch (const std::invalid_argument &)
+		{
+			++errors;
+		}
+		adv::Store<int> store{1, 2, 3};
+		const auto search = store.freeze_search();
+		store.push_front(9); // No longer sorted, the next query must not answer
+		try
+		{
+			search.contains(9);
+		}
+		catch (const std::invalid_argument &)
+		{
+			++errors;
+		}
+		CHECK(errors == 2);
+	});
+
+	return test::report();
+}
@@ -0,0 +1,163 @@
+/**
+ * @file test_set.cpp
+ * @brief Kiểm tra intersect / unite / difference / symmetric_difference
+ *
+ * Kết quả được so với std::set_* (ngữ nghĩa multiset) trên dữ liệu ngẫu
+ * nhiên: có và không có phần tử trùng, kích thước lệch nhiều (galloping),
+ * số nguyên tăng ngặt (kernel SSE2), thứ tự giảm dần. Store kết quả phải
+ * được tái sử dụng capacity và đánh dấu đã sort.
+ *
+ * Build & chạy:
+ *   g++ -std=c++17 -O2 -I<thư mục chứa advance/> tests/test_set.cpp -o test_set && ./test_set
+ */
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <random>
+#include <stdexcept>
+#include <vector>
+#include "advance/store/include/advance_store_set.hpp"
+#include "test_check.hpp"
+
+namespace
+{
+
+/// @brief Check that out holds exactly expected
+template <typename T>
+bool equals(const adv::Store<T> &out, const std::vector<T> &expected)
+{
+	return std::vector<T>(out.cbegin(), out.cend()) == expected;
+}
+
+/// @brief Compare every operation with std::set_* on random inputs of type T
+template <typename T>
+bool matches_std(std::mt19937 &gen)
+{
+	bool ok = true;
+	for (int round = 0; round < 600; ++round)
+	{
+		const size_t na = gen() % 200;
+		const size_t nb = round % 3 == 0 ? gen() % 10000 : gen() % 200; // Skewed sizes gallop
+		const int range = 1 + static_cast<int>(gen() % 500);
+		std::vector<T> va(na);
+		std::vector<T> vb(nb);
+		for (T &value : va)
+		{
+			value = static_cast<T>(static_cast<int>(gen() % range) - range / 2);
+		}
+		for (T &value : vb)
+		{
+			value = static_cast<T>(static_cast<int>(gen() % range) - range / 2);
+		}
+		std::sort(va.begin(), va.end());
+		std::sort(vb.begin(), vb.end());
+		if (round % 2 == 1) // Strictly increasing inputs take the block kernels
+		{
+			va.erase(std::unique(va.begin(), va.end()), va.end());
+			vb.erase(std::unique(vb.begin(), vb.end()), vb.end());
+		}
+		const adv::Store<T> a(va);
+		const adv::Store<T> b(vb);
+		adv::Store<T> out;
+		std::vector<T> expected;
+
+		std::set_intersection(va.begin(), va.end(), vb.begin(), vb.end(), std::back_inserter(expected));
+		adv::intersect(a, b, out);
+		ok = ok && equals(out, expected);
+		adv::intersect(b, a, out);
+		ok = ok && equals(out, expected);
+
+		expected.clear();
+		std::set_union(va.begin(), va.end(), vb.begin(), vb.end(), std::back_inserter(expected));
+		ok = ok && equals(adv::unite(a, b), expected);
+
+		expected.clear();
+		std::set_difference(va.begin(), va.end(), vb.begin(), vb.end(), std::back_inserter(expected));
+		adv::difference(a, b, out);
+		ok = ok && equals(out, expected);
+
+		expected.clear();
+		std::set_difference(vb.begin(), vb.end(), va.begin(), va.end(), std::back_inserter(expected));
+		ok = ok && equals(adv::difference(b, a), expected);
+
+		expected.clear();
+		std::set_symmetric_difference(va.begin(), va.end(), vb.begin(), vb.end(), std::back_inserter(expected));
+		adv::symmetric_difference(a, b, out);
+		ok = ok && equals(out, expected) && out.sort_order() == adv::SortOrder::ascending;
+	}
+	return ok;
+}
+
+} // namespace
+
+int main()
+{
+	std::mt19937 gen(65);
+
+	test::run("int matches std::set_*", [&] { CHECK(matches_std<int>(gen)); });
+	test::run("long long matches std::set_*", [&] { CHECK(matches_std<long long>(gen)); });
+	test::run("short and double match std::set_*", [&] {
+		CHECK(matches_std<short>(gen));
+		CHECK(matches_std<double>(gen));
+	});
+
+	test::run("output capacity is reused", [] {
+		adv::Store<int> a;
+		adv::Store<int> b;
+		for (int i = 0; i < 1000; ++i)
+		{
+			a.push_back(2 * i);
+			b.push_back(3 * i);
+		}
+		adv::Store<int> out;
+		adv::unite(a, b, out);
+		const int *buffer = &*out.cbegin();
+		const size_t capacity = out.capacity();
+		for (int round = 0; round < 3; ++round)
+		{
+			adv::intersect(a, b, out);
+			adv::difference(a, b, out);
+			adv::unite(a, b, out);
+		}
+		CHECK(out.capacity() == capacity && &*out.cbegin() == buffer);
+		CHECK(out.size() == 1000 + 1000 - 334);
+	});
+
+	test::run("descending order", [] {
+		const adv::Store<int> a{9, 7, 5, 3};
+		const adv::Store<int> b{8, 7, 3, 1};
+		adv::Store<int> out;
+		adv::intersect(a, b, out, std::greater<int>());
+		CHECK(equals(out, std::vector<int>{7, 3}));
+		CHECK(out.sort_order() == adv::SortOrder::descending);
+		adv::unite(a, b, out, std::greater<int>());
+		CHECK(equals(out, std::vector<int>{9, 8, 7, 5, 3, 1}));
+	});
+
+	test::run("invalid inputs are rejected", [] {
+		const adv::Store<int> unsorted{3, 1};
+		adv::Store<int> sorted{1, 2};
+		adv::Store<int> out;
+		int rejected = 0;
+		try
+		{
+			adv::intersect(unsorted, sorted, out);
+		}
+		catch (const std::invalid_argument &)
+		{
+			++rejected;
+		}
+		try
+		{
+			adv::unite(sorted, sorted, sorted); // Output aliases an input
+		}
+		catch (const std::invalid_argument &)
+		{
+			++rejected;
+		}
+		CHECK(rejected == 2);
+	});
+
+	return test::report();
+}
@@ -0,0 +1,273 @@
+/**
+ * @file test_simd.cpp
+ * @brief Kiểm tra các kernel SIMD của Store so với cài đặt vô hướng
+ *
+ * Mỗi phép (max/min/sum/contains/count/find_all/filter và các predicate
+ * object cho filter/count_if/find_all_if/any_of/erase_if) được chạy ở mọi
+ * mức force_simd_level() mà CPU hỗ trợ và so với kết quả của thuật toán std.
+ *
+ * Build & chạy:
+ *   g++ -std=c++17 -O2 -I<thư mục chứa advance/> tests/test_simd.cpp -o test_simd && ./test_simd
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+#include "advance/store/include/advance_store.hpp"
+#include "test_check.hpp"
+
+namespace
+{
+
+// =======================
+// Helpers
+// =======================
+
+/// @brief Every level up to the detected one, scalar first
+std::vector<adv::SimdLevel> levels()
+{
+	std::vector<adv::SimdLevel> result;
+	for (unsigned level = 0; level <= static_cast<unsigned>(adv::detected_simd_level()); ++level)
+	{
+		result.push_back(static_cast<adv::SimdLevel>(level));
+	}
+	return result;
+}
+
+/// @brief Equal, treating two NaNs as equal
+template <typename T>
+bool same(const T &a, const T &b)
+{
+	if constexpr (std::is_floating_point_v<T>)
+	{
+		return a == b || (std::isnan(a) && std::isnan(b));
+	}
+	else
+	{
+		return a == b;
+	}
+}
+
+template <typename T>
+bool same(const adv::Store<T> &store, const std::vector<T> &expected)
+{
+	if (store.size() != expected.size())
+	{
+		return false;
+	}
+	for (size_t i = 0; i < expected.size(); ++i)
+	{
+		if (!same(store[i], expected[i]))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+/// @brief Random store with many duplicates, a NaN for floating types and the
+///        extremes of the type
+template <typename T>
+adv::Store<T> random_store(std::mt19937 &gen, size_t n, int range)
+{
+	adv::Store<T> store(n);
+	for (size_t i = 0; i < n; ++i)
+	{
+		const long long value = static_cast<long long>(gen() % static_cast<unsigned>(range)) -
+								(std::is_signed_v<T> ? range / 2 : 0);
+		store[i] = static_cast<T>(value);
+	}
+	if (n > 8)
+	{
+		store[gen() % n] = std::numeric_limits<T>::max();
+		store[gen() % n] = std::numeric_limits<T>::lowest();
+		if constexpr (std::is_floating_point_v<T>)
+		{
+			store[gen() % n] = std::numeric_limits<T>::quiet_NaN();
+			store[gen() % n] = -T(0.0);
+		}
+	}
+	return store;
+}
+
+// =======================
+// Kernels
+// =======================
+
+template <typename T>
+void check_kernels(std::mt19937 &gen, size_t n, int range)
+{
+	const adv::Store<T> store = random_store<T>(gen, n, range);
+	const std::vector<T> values(store.begin(), store.end());
+	const T probe = n ? values[gen() % n] : T(1);
+
+	std::vector<size_t> positions;
+	std::vector<T> greater;
+	for (size_t i = 0; i < n; ++i)
+	{
+		if (values[i] == probe)
+		{
+			positions.push_back(i);
+		}
+		if (values[i] > probe)
+		{
+			greater.push_back(values[i]);
+		}
+	}
+
+	adv::force_simd_level(adv::SimdLevel::scalar);
+	const T scalar_sum = store.sum();
+
+	for (const adv::SimdLevel level : levels())
+	{
+		adv::force_simd_level(level);
+		if (n != 0)
+		{
+			// Same position as std, not just an equal value
+			CHECK(&store.max() - store.data() == std::max_element(values.begin(), values.end()) - values.begin());
+			CHECK(&store.min() - store.data() == std::min_element(values.begin(), values.end()) - values.begin());
+		}
+		CHECK(store.contains(probe) == !positions.empty());
+		CHECK(store.count(probe) == positions.size());
+		CHECK(store.find_all(probe) == positions);
+		CHECK(same(store.filter([&](const T &x) { return x > probe; }), greater));
+		CHECK(store.filter([](const T &) { return true; }).size() == n);
+		if constexpr (std::is_integral_v<T>)
+		{
+			// Integer sums wrap identically at every level
+			CHECK(store.sum() == scalar_sum);
+		}
+		else
+		{
+			// Lane-wise accumulation may round differently, NaN must survive
+			CHECK(std::isnan(store.sum()) == std::isnan(scalar_sum));
+		}
+	}
+	adv::reset_simd_level();
+}
+
+// =======================
+// Predicate Objects
+// =======================
+
+template <typename T, typename Pred>
+void check_predicate(const adv::Store<T> &store, const Pred &pred)
+{
+	std::vector<size_t> positions;
+	std::vector<T> kept;
+	std::vector<T> rest;
+	for (size_t i = 0; i < store.size(); ++i)
+	{
+		if (pred(store[i]))
+		{
+			positions.push_back(i);
+			kept.push_back(store[i]);
+		}
+		else
+		{
+			rest.push_back(store[i]);
+		}
+	}
+
+	for (const adv::SimdLevel level : levels())
+	{
+		adv::force_simd_level(level);
+		CHECK(same(store.filter(pred), kept));
+		CHECK(store.count_if(pred) == positions.size());
+		CHECK(store.find_all_if(pred) == positions);
+		CHECK(store.any_of(pred) == !positions.empty());
+		adv::Store<T> erased = store;
+		CHECK(erased.erase_if(pred) == positions.size());
+		CHECK(same(erased, rest));
+	}
+	adv::reset_simd_level();
+}
+
+template <typename T>
+void check_predicates(std::mt19937 &gen, size_t n)
+{
+	const adv::Store<T> store = random_store<T>(gen, n, 200);
+	const T pivot = n ? store[n / 2] : T(3);
+	check_predicate(store, adv::eq(pivot));
+	check_predicate(store, adv::ne(pivot));
+	check_predicate(store, adv::lt(pivot));
+	check_predicate(store, adv::le(pivot));
+	check_predicate(store, adv::gt(pivot));
+	check_predicate(store, adv::ge(pivot));
+	check_predicate(store, adv::between(T(-20), T(40)));
+	// Bounds of another type, including ones T cannot represent exactly
+	check_predicate(store, adv::gt(2.5));
+	check_predicate(store, adv::lt(-1));
+	check_predicate(store, adv::ge(3000000000LL));
+	check_predicate(store, adv::ne(std::numeric_limits<double>::quiet_NaN()));
+	check_predicate(store, adv::in({T(1), T(2), pivot, T(50)}));
+	check_predicate(store, adv::gt(T(10)) && adv::lt(T(60)));
+	check_predicate(store, adv::lt(T(-50)) || adv::gt(T(80)) || adv::eq(pivot));
+}
+
+const size_t k_sizes[] = {0, 1, 3, 15, 16, 17, 63, 64, 65, 1023, 1024, 1025, 3000};
+
+} // namespace
+
+int main()
+{
+	std::printf("detected SIMD level: %s\n", adv::simd_level_name(adv::detected_simd_level()));
+	std::mt19937 gen(2024);
+
+	test::run("kernels match scalar", [&] {
+		for (const size_t n : k_sizes)
+		{
+			for (const int range : {4, 1000, 1000000})
+			{
+				check_kernels<int>(gen, n, range);
+				check_kernels<unsigned>(gen, n, range);
+				check_kernels<long long>(gen, n, range);
+				check_kernels<unsigned long long>(gen, n, range);
+				check_kernels<float>(gen, n, range);
+				check_kernels<double>(gen, n, range);
+				check_kernels<short>(gen, n, range);
+			}
+		}
+	});
+
+	test::run("predicates match scalar", [&] {
+		for (const size_t n : k_sizes)
+		{
+			check_predicates<int>(gen, n);
+			check_predicates<unsigned>(gen, n);
+			check_predicates<long long>(gen, n);
+			check_predicates<unsigned long long>(gen, n);
+			check_predicates<float>(gen, n);
+			check_predicates<double>(gen, n);
+		}
+	});
+
+	test::run("force_simd_level clamps", [] {
+		adv::force_simd_level(adv::SimdLevel::avx512);
+		CHECK(adv::simd_level() <= adv::detected_simd_level());
+		adv::reset_simd_level();
+		CHECK(adv::simd_level() == adv::detected_simd_level());
+	});
+
+	test::run("filter capacity follows result", [] {
+		adv::Store<int> store(size_t(1) << 20);
+		std::iota(store.begin(), store.end(), 0);
+		const adv::Store<int> one = store.filter(adv::eq(123456));
+		CHECK(one.size() == 1 && one[0] == 123456);
+		CHECK(one.capacity() < 1024);
+	});
+
+	test::run("non-vectorizable types", [] {
+		const adv::Store<std::string> words{"b", "a", "c", "a"};
+		CHECK(words.max() == "c" && words.min() == "a");
+		CHECK(words.count("a") == 2 && words.find_all("a") == (std::vector<size_t>{1, 3}));
+		CHECK(words.count_if(adv::in({std::string("a"), std::string("c")})) == 3);
+	});
+
+	return test::report();
+}